@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchBinaryImageFilter_h
+#define itkTorchBinaryImageFilter_h
+
+#include "itkInPlaceImageFilter.h"
+#include "itkTorchImage.h"
+#include "itkTorchFunctors.h"
+
+namespace itk
+{
+/** \class TorchBinaryImageFilter
+ *  \brief Apply a tensor functor to two TorchImages, or to a TorchImage and a constant.
+ *
+ * TorchBinaryImageFilter computes its output by applying a functor
+ * from the TorchFunctor namespace to the whole tensors of its inputs,
+ * as one vectorized ATen operation on the device of the first input,
+ * rather than one pixel at a time.  The output has the device and
+ * component layout of the first input.
+ *
+ * The second operand is either a second TorchImage, set with
+ * SetInput2(), or a constant pixel, set with SetConstant2(), which is
+ * broadcast over the first input.  A second input on another device
+ * or with another component layout is moved or permuted to match the
+ * first.  The pixels of the second input or the constant either have
+ * the components of the pixels of the first input, or are scalars
+ * that are broadcast over those components.
+ *
+ * If the deep scalar types of the inputs and output differ, the input
+ * tensors are converted to that of the output before the functor is
+ * applied.
+ *
+ * With InPlace on and equal first input and output types, the functor
+ * writes into the tensor of the first input, which becomes the
+ * output, and no tensor is allocated.
+ *
+ * The whole image is always computed: as one operation with the
+ * number of ATen threads given by TorchThreadingPolicy or, with its
+ * itkWorkUnitParallelism and a CPU tensor, split by the multithreader
+ * of the filter into regions whose narrowed views are computed by one
+ * ATen thread each.
+ *
+ * \sa TorchUnaryImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+class ITK_TEMPLATE_EXPORT TorchBinaryImageFilter : public InPlaceImageFilter< TInputImage1, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchBinaryImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchBinaryImageFilter;
+  using Superclass = InPlaceImageFilter< TInputImage1, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchBinaryImageFilter, InPlaceImageFilter );
+
+  using Input1ImageType = TInputImage1;
+  using Input2ImageType = TInputImage2;
+  using Input2PixelType = typename Input2ImageType::PixelType;
+  using OutputImageType = TOutputImage;
+  using FunctorType = TFunctor;
+
+  static_assert( Input1ImageType::TorchImagePixelHelper::SizeOf == OutputImageType::TorchImagePixelHelper::SizeOf
+    && Input1ImageType::PixelDimension == OutputImageType::PixelDimension,
+    "TorchBinaryImageFilter requires first input and output pixels with the same components" );
+  static_assert( ( Input2ImageType::TorchImagePixelHelper::SizeOf == Input1ImageType::TorchImagePixelHelper::SizeOf
+    && Input2ImageType::PixelDimension == Input1ImageType::PixelDimension ) || Input2ImageType::PixelDimension == 0,
+    "TorchBinaryImageFilter requires second input pixels with the components of the first or scalar ones" );
+
+  /** Set/Get the first operand. */
+  void SetInput1( const Input1ImageType *image1 )
+    {
+    this->SetInput( image1 );
+    }
+  const Input1ImageType * GetInput1() const
+    {
+    return this->GetInput();
+    }
+
+  /** Set/Get an image as the second operand. */
+  void SetInput2( const Input2ImageType *image2 );
+  const Input2ImageType * GetInput2() const;
+
+  /** Set/Get a constant as the second operand.  Setting a constant
+   * removes the second input image. */
+  void SetConstant2( const Input2PixelType & constant2 );
+  const Input2PixelType & GetConstant2() const
+    {
+    return m_Constant2;
+    }
+  /** Whether the second operand is the constant. */
+  itkGetConstMacro( UseConstant2, bool );
+
+  /** Get the functor object.  The functor is returned by reference so
+   * that its parameters can be set; call Modified() afterwards. */
+  FunctorType & GetFunctor()
+    {
+    return m_Functor;
+    }
+  const FunctorType & GetFunctor() const
+    {
+    return m_Functor;
+    }
+
+  /** Set the functor object. */
+  void SetFunctor( const FunctorType & functor )
+    {
+    m_Functor = functor;
+    this->Modified();
+    }
+
+protected:
+  TorchBinaryImageFilter();
+  ~TorchBinaryImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** Check that there is a second operand. */
+  void GenerateOutputInformation() override;
+
+  /** The whole image is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** The output takes the device and component layout of the first
+   * input. */
+  void AllocateOutputs() override;
+
+  void GenerateData() override;
+
+private:
+  FunctorType m_Functor;
+  Input2PixelType m_Constant2;
+  bool m_UseConstant2;
+};
+
+/** Binary TorchImage filters of the functors in TorchFunctor. */
+template< typename TInputImage1, typename TInputImage2 = TInputImage1, typename TOutputImage = TInputImage1 >
+using TorchAddImageFilter = TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TorchFunctor::Add >;
+template< typename TInputImage1, typename TInputImage2 = TInputImage1, typename TOutputImage = TInputImage1 >
+using TorchSubtractImageFilter = TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TorchFunctor::Subtract >;
+template< typename TInputImage1, typename TInputImage2 = TInputImage1, typename TOutputImage = TInputImage1 >
+using TorchMultiplyImageFilter = TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TorchFunctor::Multiply >;
+template< typename TInputImage1, typename TInputImage2 = TInputImage1, typename TOutputImage = TInputImage1 >
+using TorchDivideImageFilter = TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TorchFunctor::Divide >;
+template< typename TInputImage1, typename TInputImage2 = TInputImage1, typename TOutputImage = TInputImage1 >
+using TorchMinimumImageFilter = TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TorchFunctor::Minimum >;
+template< typename TInputImage1, typename TInputImage2 = TInputImage1, typename TOutputImage = TInputImage1 >
+using TorchMaximumImageFilter = TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TorchFunctor::Maximum >;
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchBinaryImageFilter.hxx"
+#endif
+
+#endif
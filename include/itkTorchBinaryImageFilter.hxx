@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchBinaryImageFilter_hxx
+#define itkTorchBinaryImageFilter_hxx
+
+#include "itkTorchBinaryImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::TorchBinaryImageFilter()
+  : m_Constant2( NumericTraits< Input2PixelType >::ZeroValue() ),
+    m_UseConstant2( false )
+{
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::SetInput2( const Input2ImageType *image2 )
+{
+  // ProcessObject is not const-correct, so the const_cast is required.
+  this->ProcessObject::SetNthInput( 1, const_cast< Input2ImageType * >( image2 ) );
+  m_UseConstant2 = false;
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+const typename TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >::Input2ImageType *
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::GetInput2() const
+{
+  return itkDynamicCastInDebugMode< const Input2ImageType * >( this->ProcessObject::GetInput( 1 ) );
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::SetConstant2( const Input2PixelType & constant2 )
+{
+  this->ProcessObject::SetNthInput( 1, nullptr );
+  m_Constant2 = constant2;
+  m_UseConstant2 = true;
+  this->Modified();
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::GenerateOutputInformation()
+{
+  if( !m_UseConstant2 && this->GetInput2() == nullptr )
+    {
+    itkExceptionMacro( << "Either Input2 or Constant2 must be set" );
+    }
+  Superclass::GenerateOutputInformation();
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::AllocateOutputs()
+{
+  // When running in place, the graft of the first input replaces these.
+  this->GetOutput()->CopyTensorInformation( this->GetInput1() );
+  Superclass::AllocateOutputs();
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::GenerateData()
+{
+  this->AllocateOutputs();
+
+  const Input1ImageType *input1 = this->GetInput1();
+  OutputImageType *output = this->GetOutput();
+  if( !input1->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The first input TorchImage is not allocated" );
+    }
+
+  // Running in place on a clone, or on the source of one, writes to
+  // pixels of the output's own.
+  if( this->GetRunningInPlace() )
+    {
+    output->MakeTensorWritable();
+    }
+
+  // When running in place the output tensor is an alias of the first
+  // input tensor, and is passed as both so that functors can tell.
+  torch::Tensor target = output->GetTensor();
+  const torch::Tensor source1 =
+    this->GetRunningInPlace() ? target : input1->GetTensor().to( OutputImageType::TorchValueType );
+
+  // The second operand is laid out to broadcast over the first.
+  const auto componentLayout2 =
+    static_cast< typename Input2ImageType::ComponentLayoutType >( input1->GetComponentLayout() );
+  torch::Tensor source2;
+  if( m_UseConstant2 )
+    {
+    source2 = Input2ImageType::PixelToTensor( m_Constant2, componentLayout2 );
+    }
+  else
+    {
+    const Input2ImageType *input2 = this->GetInput2();
+    if( !input2->GetTensor().defined() )
+      {
+      itkExceptionMacro( << "The second input TorchImage is not allocated" );
+      }
+    // The second image is broadcast, and split, with the regions of
+    // the output.
+    if( input2->GetBufferedRegion() != output->GetBufferedRegion() )
+      {
+      itkExceptionMacro( << "The buffered region " << input2->GetBufferedRegion()
+        << " of the second input differs from the output region " << output->GetBufferedRegion() );
+      }
+    source2 = Input2ImageType::PermuteComponentLayout( input2->GetTensor(), input2->GetComponentLayout(), componentLayout2 );
+    if( Input2ImageType::PixelDimension < Input1ImageType::PixelDimension
+      && input1->GetComponentLayout() == Input1ImageType::itkComponentsLast )
+      {
+      // Scalar pixels broadcast over trailing component dimensions
+      // only once those dimensions exist.
+      for( unsigned int i = 0; i < Input1ImageType::PixelDimension; ++i )
+        {
+        source2 = source2.unsqueeze( -1 );
+        }
+      }
+    }
+  source2 = source2.to( target.device(), OutputImageType::TorchValueType );
+
+  if( TorchThreadingPolicy::GetInstance()->SplitsRegion( this, target ) )
+    {
+    const typename OutputImageType::RegionType bufferedRegion = output->GetBufferedRegion();
+    const auto componentLayout = output->GetComponentLayout();
+    this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+    this->GetMultiThreader()->template ParallelizeImageRegion< OutputImageType::ImageDimension >( bufferedRegion,
+      [&]( const typename OutputImageType::RegionType & region )
+        {
+        const TorchIntraOpThreadsGuard threadsGuard( 1 );
+        torch::Tensor targetRegion = OutputImageType::NarrowToRegion( target, componentLayout, bufferedRegion, region );
+        // A constant broadcasts over any region.
+        m_Functor( targetRegion, this->GetRunningInPlace()
+          ? targetRegion : OutputImageType::NarrowToRegion( source1, componentLayout, bufferedRegion, region ),
+          m_UseConstant2
+          ? source2 : Input2ImageType::NarrowToRegion( source2, componentLayout2, bufferedRegion, region ) );
+        }, this );
+    }
+  else
+    {
+    const TorchIntraOpThreadsGuard threadsGuard( this );
+    m_Functor( target, source1, source2 );
+    }
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunctor >
+void
+TorchBinaryImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunctor >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_Constant2: " << static_cast< typename NumericTraits< Input2PixelType >::PrintType >( m_Constant2 )
+    << std::endl
+    << indent << "m_UseConstant2: " << m_UseConstant2 << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
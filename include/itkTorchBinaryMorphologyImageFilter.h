@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchBinaryMorphologyImageFilter_h
+#define itkTorchBinaryMorphologyImageFilter_h
+
+#include "itkTorchMorphologyImageFilterBase.h"
+
+namespace itk
+{
+/** \class TorchBinaryMorphologyImageFilter
+ *  \brief Dilate, erode, open or close the foreground of a scalar TorchImage with a flat structuring element.
+ *
+ * The foreground is the set of pixels of value ForegroundValue; all
+ * other values are background.  The filter computes what
+ * BinaryDilateImageFilter, BinaryErodeImageFilter,
+ * BinaryMorphologicalOpeningImageFilter and
+ * BinaryMorphologicalClosingImageFilter compute with the
+ * FlatStructuringElement Box() or Ball() of the same radius:
+ *
+ * - the dilation sets the pixels it adds to the foreground to
+ *   ForegroundValue, and the closing the pixels it adds;
+ * - the erosion sets the pixels it removes from the foreground to
+ *   BackgroundValue, and the opening the pixels it removes;
+ * - all other pixels keep the values of the input.
+ *
+ * As there, outside of the image is background for dilations and
+ * foreground for erosions, and with SafeBorder the closing pads the
+ * input with background by the radius, so that the foreground is not
+ * closed against the border.
+ *
+ * The foreground is morphed as a floating point mask, by the pooling
+ * and line decompositions of TorchMorphologyImageFilterBase.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchBinaryMorphologyImageFilter
+  : public TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchBinaryMorphologyImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchBinaryMorphologyImageFilter;
+  using Superclass = TorchMorphologyImageFilterBase< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchBinaryMorphologyImageFilter, TorchMorphologyImageFilterBase );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename InputImageType::PixelType;
+
+  /** The value of the foreground.  Defaults to the highest value of
+   * the pixel type. */
+  itkSetMacro( ForegroundValue, InputPixelType );
+  itkGetConstMacro( ForegroundValue, InputPixelType );
+
+  /** The value of the pixels removed from the foreground.  Defaults to
+   * the lowest value of the pixel type. */
+  itkSetMacro( BackgroundValue, InputPixelType );
+  itkGetConstMacro( BackgroundValue, InputPixelType );
+
+  /** Whether closings pad the input.  On by default. */
+  itkSetMacro( SafeBorder, bool );
+  itkGetConstMacro( SafeBorder, bool );
+  itkBooleanMacro( SafeBorder );
+
+protected:
+  TorchBinaryMorphologyImageFilter();
+  ~TorchBinaryMorphologyImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  void GenerateData() override;
+
+private:
+  InputPixelType m_ForegroundValue;
+  InputPixelType m_BackgroundValue;
+  bool m_SafeBorder;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchBinaryMorphologyImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchBinaryMorphologyImageFilter_hxx
+#define itkTorchBinaryMorphologyImageFilter_hxx
+
+#include "itkTorchBinaryMorphologyImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchBinaryMorphologyImageFilter< TInputImage, TOutputImage >
+::TorchBinaryMorphologyImageFilter()
+  : m_ForegroundValue( NumericTraits< InputPixelType >::max() ),
+    m_BackgroundValue( NumericTraits< InputPixelType >::NonpositiveMin() ),
+    m_SafeBorder( true )
+{
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchBinaryMorphologyImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  const torch::Tensor input = this->GetInput()->GetTensor();
+  const torch::Tensor foreground = input.eq( torch::Scalar( m_ForegroundValue ) );
+  const torch::Tensor mask = foreground.to( torch::kFloat );
+  const auto isSet = []( const torch::Tensor & morphed )
+    {
+    return morphed.gt( 0.5 );
+    };
+
+  torch::Tensor result;
+  switch( this->GetOperation() )
+    {
+    case Superclass::itkDilate:
+      {
+      const torch::Tensor dilated = isSet( this->Morph( mask, true, 0 ) );
+      result = input.masked_fill( dilated, torch::Scalar( m_ForegroundValue ) );
+      break;
+      }
+    case Superclass::itkErode:
+      {
+      const torch::Tensor eroded = isSet( this->Morph( mask, false, 1 ) );
+      result = input.masked_fill( foreground.logical_and( eroded.logical_not() ), torch::Scalar( m_BackgroundValue ) );
+      break;
+      }
+    case Superclass::itkOpen:
+      {
+      const torch::Tensor opened = isSet( this->Morph( this->Morph( mask, false, 1 ), true, 0 ) );
+      result = input.masked_fill( foreground.logical_and( opened.logical_not() ), torch::Scalar( m_BackgroundValue ) );
+      break;
+      }
+    case Superclass::itkClose:
+      {
+      torch::Tensor closed = m_SafeBorder ? this->PadByRadius( mask, 1, 0 ) : mask;
+      closed = this->Morph( this->Morph( closed, true, 0 ), false, 1 );
+      if( m_SafeBorder )
+        {
+        closed = this->PadByRadius( closed, -1, 0 );
+        }
+      result = input.masked_fill( isSet( closed ), torch::Scalar( m_ForegroundValue ) );
+      break;
+      }
+    }
+  this->SetOutputTensor( result );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchBinaryMorphologyImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_ForegroundValue: "
+    << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_ForegroundValue ) << std::endl
+    << indent << "m_BackgroundValue: "
+    << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_BackgroundValue ) << std::endl
+    << indent << "m_SafeBorder: " << m_SafeBorder << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
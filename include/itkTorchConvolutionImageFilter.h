@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchConvolutionImageFilter_h
+#define itkTorchConvolutionImageFilter_h
+
+#include "itkTorchConvolutionImageFilterBase.h"
+
+namespace itk
+{
+/** \class TorchConvolutionImageFilter
+ *  \brief Convolve a TorchImage with a kernel TorchImage.
+ *
+ * The output is the convolution of each component of the input with
+ * the scalar kernel image, computed by one grouped ATen convolution
+ * on the device of the input, as described for
+ * TorchConvolutionImageFilterBase.  As for ConvolutionImageFilter, the
+ * kernel's center is the pixel at index size / 2 from the start of its
+ * buffered region, the kernel's geometry is ignored, and with
+ * Normalize on the kernel is divided by the sum of its pixels.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage,
+  typename TKernelImage = TorchImage< float, TInputImage::ImageDimension >,
+  typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchConvolutionImageFilter : public TorchConvolutionImageFilterBase< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchConvolutionImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchConvolutionImageFilter;
+  using Superclass = TorchConvolutionImageFilterBase< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchConvolutionImageFilter, TorchConvolutionImageFilterBase );
+
+  using InputImageType = TInputImage;
+  using KernelImageType = TKernelImage;
+  using OutputImageType = TOutputImage;
+
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
+
+  static_assert( KernelImageType::PixelDimension == 0 && KernelImageType::ImageDimension == ImageDimension,
+    "TorchConvolutionImageFilter requires a scalar kernel of the dimension of the image" );
+
+  /** Set/Get the kernel to convolve with. */
+  itkSetInputMacro( KernelImage, KernelImageType );
+  itkGetInputMacro( KernelImage, KernelImageType );
+
+  /** Whether the kernel is normalized to sum to one.  Off by default. */
+  itkSetMacro( Normalize, bool );
+  itkGetConstMacro( Normalize, bool );
+  itkBooleanMacro( Normalize );
+
+protected:
+  TorchConvolutionImageFilter();
+  ~TorchConvolutionImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The whole kernel is needed. */
+  void GenerateInputRequestedRegion() override;
+
+  /** The kernel need not occupy the physical space of the input. */
+  void VerifyInputInformation() ITKv5_CONST override {}
+
+  void GenerateData() override;
+
+private:
+  bool m_Normalize;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchConvolutionImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchConvolutionImageFilter_hxx
+#define itkTorchConvolutionImageFilter_hxx
+
+#include "itkTorchConvolutionImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage >
+TorchConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >
+::TorchConvolutionImageFilter()
+  : m_Normalize( false )
+{
+  this->AddRequiredInputName( "KernelImage" );
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage >
+void
+TorchConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto *kernel = const_cast< KernelImageType * >( this->GetKernelImage() );
+  if( kernel != nullptr )
+    {
+    kernel->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage >
+void
+TorchConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  const KernelImageType *kernelImage = this->GetKernelImage();
+  if( !kernelImage->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The kernel TorchImage is not allocated" );
+    }
+  const torch::Tensor batch = this->GetInputBatch();
+
+  // Flipping the kernel turns ATen's correlation into a convolution.
+  // The kernel's center, at size / 2, then lies size - 1 - size / 2
+  // elements from its start.
+  std::vector< int64_t > tensorDimensions( ImageDimension );
+  std::vector< int64_t > kernelSize{ 1, 1 };
+  std::vector< int64_t > padding;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tensorDimensions[d] = d;
+    const int64_t size = kernelImage->GetTensor().size( d );
+    kernelSize.push_back( size );
+    padding.push_back( size - 1 - size / 2 );
+    padding.push_back( size / 2 );
+    }
+  torch::Tensor kernel = kernelImage->GetTensor().flip( tensorDimensions ).to( batch.device(), batch.scalar_type() );
+  if( m_Normalize )
+    {
+    kernel = kernel / kernel.sum();
+    }
+
+  this->SetOutputFromBatch( Superclass::CorrelateBatch( batch, kernel.reshape( kernelSize ), padding ) );
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage >
+void
+TorchConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "m_Normalize: " << m_Normalize << std::endl;
+}
+
+} // end namespace itk
+
+#endif
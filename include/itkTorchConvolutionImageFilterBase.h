@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchConvolutionImageFilterBase_h
+#define itkTorchConvolutionImageFilterBase_h
+
+#include "itkImageToImageFilter.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchConvolutionImageFilterBase
+ *  \brief Base class for filters that convolve a TorchImage with ATen's convolutions.
+ *
+ * The input tensor is viewed as a batch of one, with the pixel
+ * components as channels, so each component is convolved separately
+ * by a grouped at::conv1d, at::conv2d or at::conv3d.  Before each
+ * convolution the tensor is padded by replicating its border pixels,
+ * which is the zero-flux Neumann boundary condition that ITK's
+ * convolution filters use by default.  The convolutions are computed
+ * in the deep scalar type of the output if it is a floating point
+ * type, and in float otherwise.
+ *
+ * The output has the buffered region, device and component layout of
+ * the input.
+ *
+ * \sa TorchConvolutionImageFilter
+ * \sa TorchDiscreteGaussianImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchConvolutionImageFilterBase : public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchConvolutionImageFilterBase );
+
+  /** Standard class type aliases */
+  using Self = TorchConvolutionImageFilterBase;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchConvolutionImageFilterBase, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  static_assert( ImageDimension >= 1 && ImageDimension <= 3, "ATen convolves only 1, 2 and 3 dimensional images" );
+  static_assert( InputImageType::TorchImagePixelHelper::SizeOf == OutputImageType::TorchImagePixelHelper::SizeOf
+    && InputImageType::PixelDimension == OutputImageType::PixelDimension,
+    "TorchConvolutionImageFilterBase requires input and output pixels with the same components" );
+
+  /** The dtype in which the convolutions are computed. */
+  static constexpr torch::ScalarType ComputeValueType =
+    std::is_floating_point< typename OutputImageType::DeepScalarType >::value ? OutputImageType::TorchValueType : torch::kFloat;
+
+protected:
+  TorchConvolutionImageFilterBase() = default;
+  ~TorchConvolutionImageFilterBase() override = default;
+
+  /** The whole image is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** The input tensor as a batch of one, of sizes (1, components,
+   * index sizes in tensor order), in ComputeValueType. */
+  torch::Tensor GetInputBatch() const;
+
+  /** Set the output tensor from a batch of the sizes returned by
+   * GetInputBatch(). */
+  void SetOutputFromBatch( const torch::Tensor & batch );
+
+  /** Correlate each channel of a batch with the single channel of a
+   * kernel of sizes (1, 1, kernel sizes in tensor order).  The batch is
+   * padded by replication with padding[2 * d] elements before and
+   * padding[2 * d + 1] elements after along tensor index dimension d,
+   * so that the output has the sizes of the batch if the paddings of
+   * each dimension add up to the kernel size minus one. */
+  static torch::Tensor CorrelateBatch( const torch::Tensor & batch, const torch::Tensor & kernel,
+    const std::vector< int64_t > & padding );
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchConvolutionImageFilterBase.hxx"
+#endif
+
+#endif
@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchConvolutionImageFilterBase_hxx
+#define itkTorchConvolutionImageFilterBase_hxx
+
+#include "itkTorchConvolutionImageFilterBase.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchConvolutionImageFilterBase< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchConvolutionImageFilterBase< TInputImage, TOutputImage >
+::GetInputBatch() const
+{
+  const InputImageType *input = this->GetInput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+  const torch::Tensor tensor =
+    InputImageType::PermuteComponentLayout( input->GetTensor(), input->GetComponentLayout(), InputImageType::itkComponentsFirst );
+  std::vector< int64_t > batchSize{ 1, InputImageType::TorchImagePixelHelper::SizeOf };
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    batchSize.push_back( tensor.size( InputImageType::PixelDimension + d ) );
+    }
+  return tensor.reshape( batchSize ).to( ComputeValueType );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchConvolutionImageFilterBase< TInputImage, TOutputImage >
+::SetOutputFromBatch( const torch::Tensor & batch )
+{
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  output->CopyTensorInformation( input );
+  output->SetBufferedRegion( input->GetBufferedRegion() );
+
+  std::vector< int64_t > tensorSize;
+  OutputImageType::TorchImagePixelHelper::AppendSizes( tensorSize );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tensorSize.push_back( batch.size( 2 + d ) );
+    }
+  const torch::Tensor tensor = batch.reshape( tensorSize ).to( OutputImageType::TorchValueType );
+  // Pixels are copied only to interleave the components of vector
+  // pixels for itkComponentsLast.
+  output->SetTensor( OutputImageType::PermuteComponentLayout( tensor, OutputImageType::itkComponentsFirst,
+    output->GetComponentLayout() ).contiguous() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchConvolutionImageFilterBase< TInputImage, TOutputImage >
+::CorrelateBatch( const torch::Tensor & batch, const torch::Tensor & kernel, const std::vector< int64_t > & padding )
+{
+  // pad() lists the paddings of the last dimension first.
+  std::vector< int64_t > padSizes;
+  bool padded = false;
+  for( unsigned int d = ImageDimension; d-- > 0; )
+    {
+    padSizes.push_back( padding[2 * d] );
+    padSizes.push_back( padding[2 * d + 1] );
+    padded = padded || padding[2 * d] != 0 || padding[2 * d + 1] != 0;
+    }
+  namespace F = torch::nn::functional;
+  const torch::Tensor paddedBatch = padded ? F::pad( batch, F::PadFuncOptions( padSizes ).mode( torch::kReplicate ) ) : batch;
+
+  // One group per channel, all with the same kernel.
+  const int64_t channels = batch.size( 1 );
+  std::vector< int64_t > weightSize = kernel.sizes().vec();
+  weightSize[0] = channels;
+  const torch::Tensor weight = kernel.expand( weightSize ).contiguous();
+  switch( ImageDimension )
+    {
+    case 1:
+      return torch::conv1d( paddedBatch, weight, {}, 1, 0, 1, channels );
+    case 2:
+      return torch::conv2d( paddedBatch, weight, {}, 1, 0, 1, channels );
+    default:
+      return torch::conv3d( paddedBatch, weight, {}, 1, 0, 1, channels );
+    }
+}
+
+} // end namespace itk
+
+#endif
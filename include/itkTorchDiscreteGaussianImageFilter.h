@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchDiscreteGaussianImageFilter_h
+#define itkTorchDiscreteGaussianImageFilter_h
+
+#include "itkTorchConvolutionImageFilterBase.h"
+#include "itkFixedArray.h"
+
+namespace itk
+{
+/** \class TorchDiscreteGaussianImageFilter
+ *  \brief Blur a TorchImage with a separable discrete Gaussian kernel.
+ *
+ * TorchDiscreteGaussianImageFilter computes what DiscreteGaussianImageFilter
+ * computes, with the same parameters.  The one dimensional kernels are
+ * the coefficients of GaussianOperator, for the variance of each
+ * dimension in physical units if UseImageSpacing is on, and in pixels
+ * otherwise.  Each is applied by one grouped ATen convolution per
+ * dimension, to all components of the pixels at once, on the device of
+ * the input, as described for TorchConvolutionImageFilterBase.
+ * Dimensions with a variance of zero are not blurred.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchDiscreteGaussianImageFilter : public TorchConvolutionImageFilterBase< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchDiscreteGaussianImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchDiscreteGaussianImageFilter;
+  using Superclass = TorchConvolutionImageFilterBase< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchDiscreteGaussianImageFilter, TorchConvolutionImageFilterBase );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
+
+  using ArrayType = FixedArray< double, ImageDimension >;
+
+  /** The variance of the Gaussian in each dimension.  Defaults to zero. */
+  itkSetMacro( Variance, ArrayType );
+  itkGetConstMacro( Variance, ArrayType );
+  void SetVariance( double variance )
+    {
+    ArrayType array;
+    array.Fill( variance );
+    this->SetVariance( array );
+    }
+
+  /** The maximum error of the truncated kernel in each dimension, in
+   * (0, 1).  Defaults to 0.01. */
+  itkSetMacro( MaximumError, ArrayType );
+  itkGetConstMacro( MaximumError, ArrayType );
+  void SetMaximumError( double maximumError )
+    {
+    ArrayType array;
+    array.Fill( maximumError );
+    this->SetMaximumError( array );
+    }
+
+  /** The maximum size of a kernel.  Defaults to 32. */
+  itkSetMacro( MaximumKernelWidth, unsigned int );
+  itkGetConstMacro( MaximumKernelWidth, unsigned int );
+
+  /** Whether the variance is in physical units.  On by default. */
+  itkSetMacro( UseImageSpacing, bool );
+  itkGetConstMacro( UseImageSpacing, bool );
+  itkBooleanMacro( UseImageSpacing );
+
+  /** The coefficients of the kernel for a dimension of the input. */
+  std::vector< double > GetKernelCoefficients( unsigned int dimension ) const;
+
+protected:
+  TorchDiscreteGaussianImageFilter();
+  ~TorchDiscreteGaussianImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  void GenerateData() override;
+
+private:
+  ArrayType m_Variance;
+  ArrayType m_MaximumError;
+  unsigned int m_MaximumKernelWidth;
+  bool m_UseImageSpacing;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchDiscreteGaussianImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchDiscreteGaussianImageFilter_hxx
+#define itkTorchDiscreteGaussianImageFilter_hxx
+
+#include "itkTorchDiscreteGaussianImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+#include "itkGaussianOperator.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchDiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::TorchDiscreteGaussianImageFilter()
+  : m_MaximumKernelWidth( 32 ),
+    m_UseImageSpacing( true )
+{
+  m_Variance.Fill( 0.0 );
+  m_MaximumError.Fill( 0.01 );
+}
+
+template< typename TInputImage, typename TOutputImage >
+std::vector< double >
+TorchDiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GetKernelCoefficients( unsigned int dimension ) const
+{
+  double variance = m_Variance[dimension];
+  if( m_UseImageSpacing )
+    {
+    const double spacing = this->GetInput()->GetSpacing()[dimension];
+    variance /= spacing * spacing;
+    }
+  GaussianOperator< double, ImageDimension > gaussianOperator;
+  gaussianOperator.SetDirection( dimension );
+  gaussianOperator.SetVariance( variance );
+  gaussianOperator.SetMaximumError( m_MaximumError[dimension] );
+  gaussianOperator.SetMaximumKernelWidth( m_MaximumKernelWidth );
+  gaussianOperator.CreateDirectional();
+  return std::vector< double >( gaussianOperator.Begin(), gaussianOperator.End() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchDiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  torch::Tensor batch = this->GetInputBatch();
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if( m_Variance[i] <= 0.0 )
+      {
+      continue;
+      }
+    const std::vector< double > coefficients = this->GetKernelCoefficients( i );
+    const int64_t kernelWidth = coefficients.size();
+
+    // Index dimension i is tensor dimension ImageDimension - 1 - i of
+    // the image, after the batch and channel dimensions.
+    const unsigned int d = ImageDimension - 1 - i;
+    std::vector< int64_t > kernelSize( 2 + ImageDimension, 1 );
+    kernelSize[2 + d] = kernelWidth;
+    std::vector< int64_t > padding( 2 * ImageDimension, 0 );
+    padding[2 * d] = kernelWidth / 2;
+    padding[2 * d + 1] = kernelWidth / 2;
+    const torch::Tensor kernel =
+      torch::tensor( coefficients, torch::dtype( torch::kDouble ) ).reshape( kernelSize ).to( batch.options() );
+    batch = Superclass::CorrelateBatch( batch, kernel, padding );
+    }
+  this->SetOutputFromBatch( batch );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchDiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_Variance: " << m_Variance << std::endl
+    << indent << "m_MaximumError: " << m_MaximumError << std::endl
+    << indent << "m_MaximumKernelWidth: " << m_MaximumKernelWidth << std::endl
+    << indent << "m_UseImageSpacing: " << m_UseImageSpacing << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
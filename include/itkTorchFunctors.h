@@ -0,0 +1,283 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchFunctors_h
+#define itkTorchFunctors_h
+
+#include <torch/torch.h>
+#include <torch/version.h>
+
+namespace itk
+{
+/** \namespace TorchFunctor
+ *  \brief Functors of TorchUnaryImageFilter and TorchBinaryImageFilter.
+ *
+ * Unlike the functors of itk::Functor, which compute one pixel at a
+ * time, these functors compute whole tensors with ATen operations.
+ * They write into an output tensor that has already been allocated
+ * with the sizes and dtype of the result; the input tensors have the
+ * dtype of the output and broadcast to its sizes.  The output may be
+ * the first input tensor itself, for in-place computation.
+ *
+ * \ingroup PyTorch
+ */
+namespace TorchFunctor
+{
+
+/** \class Abs
+ * \brief Absolute value.
+ * \ingroup PyTorch
+ */
+class Abs
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input ) const
+    {
+    at::abs_out( output, input );
+    }
+};
+
+/** \class Exp
+ * \brief Exponential.
+ * \ingroup PyTorch
+ */
+class Exp
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input ) const
+    {
+    at::exp_out( output, input );
+    }
+};
+
+/** \class Log
+ * \brief Natural logarithm.
+ * \ingroup PyTorch
+ */
+class Log
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input ) const
+    {
+    at::log_out( output, input );
+    }
+};
+
+/** \class Clamp
+ * \brief Clamp values to [Lower, Upper].
+ *
+ * Either bound may be left unset, in which case values are not
+ * limited on that side.
+ *
+ * \ingroup PyTorch
+ */
+class Clamp
+{
+public:
+  void SetLower( double lower )
+    {
+    m_Lower = lower;
+    }
+  void SetUpper( double upper )
+    {
+    m_Upper = upper;
+    }
+  void SetBounds( double lower, double upper )
+    {
+    m_Lower = lower;
+    m_Upper = upper;
+    }
+
+  void operator()( torch::Tensor & output, const torch::Tensor & input ) const
+    {
+    c10::optional< torch::Scalar > lower;
+    c10::optional< torch::Scalar > upper;
+    if( m_Lower )
+      {
+      lower = *m_Lower;
+      }
+    if( m_Upper )
+      {
+      upper = *m_Upper;
+      }
+    at::clamp_out( output, input, lower, upper );
+    }
+
+private:
+  c10::optional< double > m_Lower;
+  c10::optional< double > m_Upper;
+};
+
+/** \class Threshold
+ * \brief Replace values outside of [Lower, Upper] by OutsideValue.
+ *
+ * As for ThresholdImageFilter, values within the bounds are kept.
+ * Either bound may be left unset, in which case no values are outside
+ * on that side.  The comparisons are computed into a boolean mask,
+ * which is then filled into the output in one masked operation.
+ *
+ * \ingroup PyTorch
+ */
+class Threshold
+{
+public:
+  void SetLower( double lower )
+    {
+    m_Lower = lower;
+    }
+  void SetUpper( double upper )
+    {
+    m_Upper = upper;
+    }
+  void SetBounds( double lower, double upper )
+    {
+    m_Lower = lower;
+    m_Upper = upper;
+    }
+  void SetOutsideValue( double outsideValue )
+    {
+    m_OutsideValue = outsideValue;
+    }
+
+  void operator()( torch::Tensor & output, const torch::Tensor & input ) const
+    {
+    torch::Tensor outside;
+    if( m_Lower )
+      {
+      outside = input.lt( *m_Lower );
+      }
+    if( m_Upper )
+      {
+      outside = outside.defined() ? outside.logical_or_( input.gt( *m_Upper ) ) : input.gt( *m_Upper );
+      }
+    if( !output.is_same( input ) )
+      {
+      output.copy_( input );
+      }
+    if( outside.defined() )
+      {
+      output.masked_fill_( outside, m_OutsideValue );
+      }
+    }
+
+private:
+  c10::optional< double > m_Lower;
+  c10::optional< double > m_Upper;
+  double m_OutsideValue{ 0.0 };
+};
+
+/** \class Add
+ * \brief Sum of two inputs.
+ * \ingroup PyTorch
+ */
+class Add
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input1, const torch::Tensor & input2 ) const
+    {
+    at::add_out( output, input1, input2 );
+    }
+};
+
+/** \class Subtract
+ * \brief Difference of two inputs.
+ * \ingroup PyTorch
+ */
+class Subtract
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input1, const torch::Tensor & input2 ) const
+    {
+    at::sub_out( output, input1, input2 );
+    }
+};
+
+/** \class Multiply
+ * \brief Product of two inputs.
+ * \ingroup PyTorch
+ */
+class Multiply
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input1, const torch::Tensor & input2 ) const
+    {
+    at::mul_out( output, input1, input2 );
+    }
+};
+
+/** \class Divide
+ * \brief Quotient of two inputs.
+ *
+ * Integer quotients are computed in the integer type and rounded
+ * toward zero, as in C++.  Before libtorch 1.8, which has no rounding
+ * mode for at::div(), the quotient of the magnitudes is computed with
+ * at::floor_divide(), whose rounding of negative quotients differs
+ * between versions, and given its sign.  Integer division by zero is
+ * undefined.
+ *
+ * \ingroup PyTorch
+ */
+class Divide
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input1, const torch::Tensor & input2 ) const
+    {
+    if( output.is_floating_point() )
+      {
+      at::div_out( output, input1, input2 );
+      }
+    else
+      {
+#if TORCH_VERSION_MAJOR > 1 || TORCH_VERSION_MINOR >= 8
+      output.copy_( at::div( input1, input2, "trunc" ) );
+#else
+      output.copy_( input1.abs().floor_divide( input2.abs() ).mul_( input1.sign() ).mul_( input2.sign() ) );
+#endif
+      }
+    }
+};
+
+/** \class Minimum
+ * \brief Elementwise minimum of two inputs.
+ * \ingroup PyTorch
+ */
+class Minimum
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input1, const torch::Tensor & input2 ) const
+    {
+    at::min_out( output, input1, input2 );
+    }
+};
+
+/** \class Maximum
+ * \brief Elementwise maximum of two inputs.
+ * \ingroup PyTorch
+ */
+class Maximum
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input1, const torch::Tensor & input2 ) const
+    {
+    at::max_out( output, input1, input2 );
+    }
+};
+
+} // end namespace TorchFunctor
+} // end namespace itk
+
+#endif
@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGradientImageFilter_h
+#define itkTorchGradientImageFilter_h
+
+#include "itkCovariantVector.h"
+#include "itkTorchGradientImageFilterBase.h"
+
+namespace itk
+{
+/** \class TorchGradientImageFilter
+ *  \brief Compute the gradient of a scalar TorchImage as a TorchImage of CovariantVector pixels.
+ *
+ * TorchGradientImageFilter computes what GradientImageFilter computes,
+ * with the same parameters: the central differences described for
+ * TorchGradientImageFilterBase and, with UseImageDirection, their
+ * rotation from index axes to physical axes by the direction of the
+ * input.
+ *
+ * Each derivative is written directly into its component of the output
+ * tensor, whose component dimension is last or first as the component
+ * layout of the input, so the gradient is neither assembled from
+ * separate component images nor interleaved afterwards.  The rotation,
+ * if the direction is not the identity, is one matrix product over the
+ * component dimension.
+ *
+ * \sa TorchGradientMagnitudeImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage,
+  typename TOutputImage = TorchImage< CovariantVector< float, TInputImage::ImageDimension >, TInputImage::ImageDimension > >
+class ITK_TEMPLATE_EXPORT TorchGradientImageFilter : public TorchGradientImageFilterBase< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchGradientImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchGradientImageFilter;
+  using Superclass = TorchGradientImageFilterBase< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchGradientImageFilter, TorchGradientImageFilterBase );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
+
+  static_assert( OutputImageType::PixelDimension == 1 && OutputImageType::TorchImagePixelHelper::SizeOf == ImageDimension,
+    "TorchGradientImageFilter requires output pixels of one component per dimension" );
+
+  /** Whether the gradient is in physical rather than index axes.  On by
+   * default. */
+  itkSetMacro( UseImageDirection, bool );
+  itkGetConstMacro( UseImageDirection, bool );
+  itkBooleanMacro( UseImageDirection );
+
+protected:
+  TorchGradientImageFilter();
+  ~TorchGradientImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  void GenerateData() override;
+
+private:
+  bool m_UseImageDirection;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchGradientImageFilter.hxx"
+#endif
+
+#endif
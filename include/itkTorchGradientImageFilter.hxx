@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGradientImageFilter_hxx
+#define itkTorchGradientImageFilter_hxx
+
+#include "itkTorchGradientImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchGradientImageFilter< TInputImage, TOutputImage >
+::TorchGradientImageFilter()
+  : m_UseImageDirection( true )
+{
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  output->CopyTensorInformation( input );
+  output->SetBufferedRegion( input->GetBufferedRegion() );
+
+  const torch::Tensor paddedInput = this->GetPaddedInput();
+  std::vector< int64_t > tensorSize;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tensorSize.push_back( paddedInput.size( d ) - 2 );
+    }
+  const int64_t componentDimension = output->GetFirstComponentTorchDimension();
+  tensorSize.insert( tensorSize.begin() + componentDimension, ImageDimension );
+  torch::Tensor gradient = torch::empty( tensorSize, paddedInput.options() );
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    this->ComputeDerivative( paddedInput, i, gradient.select( componentDimension, i ) );
+    }
+
+  const typename InputImageType::DirectionType & direction = input->GetDirection();
+  if( m_UseImageDirection && !direction.GetVnlMatrix().is_identity() )
+    {
+    // The physical gradient is the direction times the index gradient.
+    std::vector< double > directionValues;
+    for( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      for( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        directionValues.push_back( direction[i][j] );
+        }
+      }
+    const torch::Tensor directionTensor = torch::tensor( directionValues, torch::dtype( torch::kDouble ) )
+      .reshape( { ImageDimension, ImageDimension } ).to( gradient.options() );
+    gradient = componentDimension == 0
+      ? torch::tensordot( directionTensor, gradient, { 1 }, { 0 } )
+      : torch::matmul( gradient, directionTensor.t() );
+    }
+  output->SetTensor( gradient.contiguous() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "m_UseImageDirection: " << m_UseImageDirection << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGradientImageFilterBase_h
+#define itkTorchGradientImageFilterBase_h
+
+#include "itkImageToImageFilter.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchGradientImageFilterBase
+ *  \brief Base class for filters that compute the central differences of a scalar TorchImage.
+ *
+ * The derivative along each index dimension is the central difference
+ * ( f(x + 1) - f(x - 1) ) / 2, divided by the spacing with
+ * UseImageSpacing, as computed by the first order DerivativeOperator of
+ * GradientImageFilter and GradientMagnitudeImageFilter.  The input is
+ * padded once by replicating its border pixels, which is the zero-flux
+ * Neumann boundary condition of those filters, and each difference is
+ * then a subtraction of two shifted views of the padded input written
+ * into a tensor given by the subclass, without convolving with a
+ * mostly zero kernel.
+ *
+ * The differences are computed in the deep scalar type of the output,
+ * which must be a floating point type, on the device of the input.
+ *
+ * \sa TorchGradientImageFilter
+ * \sa TorchGradientMagnitudeImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage >
+class ITK_TEMPLATE_EXPORT TorchGradientImageFilterBase : public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchGradientImageFilterBase );
+
+  /** Standard class type aliases */
+  using Self = TorchGradientImageFilterBase;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchGradientImageFilterBase, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  static_assert( ImageDimension >= 1 && ImageDimension <= 3, "ATen pads by replication only 1, 2 and 3 dimensional images" );
+  static_assert( InputImageType::PixelDimension == 0, "TorchGradientImageFilterBase requires scalar input pixels" );
+  static_assert( std::is_floating_point< typename OutputImageType::DeepScalarType >::value,
+    "TorchGradientImageFilterBase requires floating point output pixels" );
+
+  /** Whether the derivatives are in physical units.  On by default. */
+  itkSetMacro( UseImageSpacing, bool );
+  itkGetConstMacro( UseImageSpacing, bool );
+  itkBooleanMacro( UseImageSpacing );
+
+protected:
+  TorchGradientImageFilterBase();
+  ~TorchGradientImageFilterBase() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion() override;
+
+  /** The whole output is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** The input tensor in the deep scalar type of the output, padded by
+   * one replicated pixel on both sides of every dimension. */
+  torch::Tensor GetPaddedInput() const;
+
+  /** Write the derivative along index dimension dimension of a padded
+   * input into derivative, a tensor, or a view, of the index sizes in
+   * tensor order. */
+  void ComputeDerivative( const torch::Tensor & paddedInput, unsigned int dimension, torch::Tensor derivative ) const;
+
+private:
+  bool m_UseImageSpacing;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchGradientImageFilterBase.hxx"
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGradientImageFilterBase_hxx
+#define itkTorchGradientImageFilterBase_hxx
+
+#include "itkTorchGradientImageFilterBase.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchGradientImageFilterBase< TInputImage, TOutputImage >
+::TorchGradientImageFilterBase()
+  : m_UseImageSpacing( true )
+{
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientImageFilterBase< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto *input = const_cast< InputImageType * >( this->GetInput() );
+  if( input != nullptr )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientImageFilterBase< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchGradientImageFilterBase< TInputImage, TOutputImage >
+::GetPaddedInput() const
+{
+  const InputImageType *input = this->GetInput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+  // Replication pads only batches of channels.
+  const torch::Tensor batch = input->GetTensor().to( OutputImageType::TorchValueType ).unsqueeze( 0 ).unsqueeze( 0 );
+  namespace F = torch::nn::functional;
+  return F::pad( batch, F::PadFuncOptions( std::vector< int64_t >( 2 * ImageDimension, 1 ) ).mode( torch::kReplicate ) )
+    .squeeze( 0 ).squeeze( 0 );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientImageFilterBase< TInputImage, TOutputImage >
+::ComputeDerivative( const torch::Tensor & paddedInput, unsigned int dimension, torch::Tensor derivative ) const
+{
+  // Index dimension dimension is tensor dimension d.
+  const int64_t d = ImageDimension - 1 - dimension;
+  torch::Tensor forward = paddedInput;
+  torch::Tensor backward = paddedInput;
+  for( int64_t k = 0; k < static_cast< int64_t >( ImageDimension ); ++k )
+    {
+    const int64_t size = paddedInput.size( k ) - 2;
+    forward = forward.narrow( k, k == d ? 2 : 1, size );
+    backward = backward.narrow( k, k == d ? 0 : 1, size );
+    }
+  double scale = 0.5;
+  if( m_UseImageSpacing )
+    {
+    scale /= this->GetInput()->GetSpacing()[dimension];
+    }
+  torch::sub_out( derivative, forward, backward ).mul_( scale );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientImageFilterBase< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "m_UseImageSpacing: " << m_UseImageSpacing << std::endl;
+}
+
+} // end namespace itk
+
+#endif
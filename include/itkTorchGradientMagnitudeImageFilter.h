@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGradientMagnitudeImageFilter_h
+#define itkTorchGradientMagnitudeImageFilter_h
+
+#include "itkTorchGradientImageFilterBase.h"
+
+namespace itk
+{
+/** \class TorchGradientMagnitudeImageFilter
+ *  \brief Compute the magnitude of the gradient of a scalar TorchImage.
+ *
+ * TorchGradientMagnitudeImageFilter computes what
+ * GradientMagnitudeImageFilter computes, with the same parameters, from
+ * the central differences described for TorchGradientImageFilterBase.
+ * The gradient image is never formed: the derivatives are computed one
+ * at a time into a single buffer and their squares accumulated into the
+ * output, which takes the square root in place.  The direction of the
+ * input does not change the magnitude.
+ *
+ * \sa TorchGradientImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchGradientMagnitudeImageFilter : public TorchGradientImageFilterBase< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchGradientMagnitudeImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchGradientMagnitudeImageFilter;
+  using Superclass = TorchGradientImageFilterBase< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchGradientMagnitudeImageFilter, TorchGradientImageFilterBase );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+
+  static constexpr unsigned int ImageDimension = Superclass::ImageDimension;
+
+  static_assert( OutputImageType::PixelDimension == 0, "TorchGradientMagnitudeImageFilter requires scalar output pixels" );
+
+protected:
+  TorchGradientMagnitudeImageFilter() = default;
+  ~TorchGradientMagnitudeImageFilter() override = default;
+
+  void GenerateData() override;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchGradientMagnitudeImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGradientMagnitudeImageFilter_hxx
+#define itkTorchGradientMagnitudeImageFilter_hxx
+
+#include "itkTorchGradientMagnitudeImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGradientMagnitudeImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  output->CopyTensorInformation( input );
+  output->SetBufferedRegion( input->GetBufferedRegion() );
+
+  const torch::Tensor paddedInput = this->GetPaddedInput();
+  std::vector< int64_t > tensorSize;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tensorSize.push_back( paddedInput.size( d ) - 2 );
+    }
+  const torch::Tensor derivative = torch::empty( tensorSize, paddedInput.options() );
+  torch::Tensor squaredMagnitude = torch::zeros( tensorSize, paddedInput.options() );
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    this->ComputeDerivative( paddedInput, i, derivative );
+    squaredMagnitude.addcmul_( derivative, derivative );
+    }
+  output->SetTensor( squaredMagnitude.sqrt_() );
+}
+
+} // end namespace itk
+
+#endif
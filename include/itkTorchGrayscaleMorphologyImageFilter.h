@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGrayscaleMorphologyImageFilter_h
+#define itkTorchGrayscaleMorphologyImageFilter_h
+
+#include "itkTorchMorphologyImageFilterBase.h"
+
+namespace itk
+{
+/** \class TorchGrayscaleMorphologyImageFilter
+ *  \brief Dilate, erode, open or close a scalar TorchImage with a flat structuring element.
+ *
+ * The dilation (erosion) is the maximum (minimum) of the input over the
+ * structuring element centered at each pixel, and the opening (closing)
+ * the erosion followed by the dilation (the dilation followed by the
+ * erosion), as computed by GrayscaleDilateImageFilter,
+ * GrayscaleErodeImageFilter, GrayscaleMorphologicalOpeningImageFilter
+ * and GrayscaleMorphologicalClosingImageFilter with the
+ * FlatStructuringElement Box() or Ball() of the same radius.
+ *
+ * As with those filters, with SafeBorder the opening (closing) pads
+ * the input by the radius with the highest (lowest) value of the pixel
+ * type, so that structures touching the border are not changed by the
+ * boundary condition.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchGrayscaleMorphologyImageFilter
+  : public TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchGrayscaleMorphologyImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchGrayscaleMorphologyImageFilter;
+  using Superclass = TorchMorphologyImageFilterBase< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchGrayscaleMorphologyImageFilter, TorchMorphologyImageFilterBase );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename InputImageType::PixelType;
+
+  /** Whether openings and closings pad the input.  On by default. */
+  itkSetMacro( SafeBorder, bool );
+  itkGetConstMacro( SafeBorder, bool );
+  itkBooleanMacro( SafeBorder );
+
+protected:
+  TorchGrayscaleMorphologyImageFilter();
+  ~TorchGrayscaleMorphologyImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  void GenerateData() override;
+
+private:
+  bool m_SafeBorder;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchGrayscaleMorphologyImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchGrayscaleMorphologyImageFilter_hxx
+#define itkTorchGrayscaleMorphologyImageFilter_hxx
+
+#include "itkTorchGrayscaleMorphologyImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchGrayscaleMorphologyImageFilter< TInputImage, TOutputImage >
+::TorchGrayscaleMorphologyImageFilter()
+  : m_SafeBorder( true )
+{
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGrayscaleMorphologyImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  // Outside of the image, the lowest value takes no part in maxima and
+  // the highest value none in minima.
+  const torch::Scalar lowest( NumericTraits< InputPixelType >::NonpositiveMin() );
+  const torch::Scalar highest( NumericTraits< InputPixelType >::max() );
+  const torch::Tensor input = this->GetInput()->GetTensor();
+  torch::Tensor result;
+  switch( this->GetOperation() )
+    {
+    case Superclass::itkDilate:
+      result = this->Morph( input, true, lowest );
+      break;
+    case Superclass::itkErode:
+      result = this->Morph( input, false, highest );
+      break;
+    case Superclass::itkOpen:
+      result = m_SafeBorder ? this->PadByRadius( input, 1, highest ) : input;
+      result = this->Morph( this->Morph( result, false, highest ), true, lowest );
+      if( m_SafeBorder )
+        {
+        result = this->PadByRadius( result, -1, 0 );
+        }
+      break;
+    case Superclass::itkClose:
+      result = m_SafeBorder ? this->PadByRadius( input, 1, lowest ) : input;
+      result = this->Morph( this->Morph( result, true, lowest ), false, highest );
+      if( m_SafeBorder )
+        {
+        result = this->PadByRadius( result, -1, 0 );
+        }
+      break;
+    }
+  this->SetOutputTensor( result );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchGrayscaleMorphologyImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "m_SafeBorder: " << m_SafeBorder << std::endl;
+}
+
+} // end namespace itk
+
+#endif
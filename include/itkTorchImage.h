@@ -19,13 +19,21 @@
 #define itkTorchImage_h
 
 #include <torch/torch.h>
+#include <ATen/dlpack.h>
 #include <ATen/native/TensorIteratorDynamicCasting.h>
 #include "itkSmartPointer.h"
 #include "itkImageBase.h"
+#include "itkImage.h"
 #include "itkTorchPixelHelper.h"
+#include "itkTorchImportImageContainer.h"
+#include "itkTorchInstrumentation.h"
+#include "itkTorchTensorPool.h"
 
 namespace itk
 {
+template< typename TImage >
+class TorchImageSerializer;
+
 /** \class TorchImage
  *  \brief Templated n-dimensional torch image class.
  *
@@ -59,6 +67,17 @@ namespace itk
  * The Index type reverses the order so that with Index[0] = col,
  * Index[1] = row, Index[2] = slice, ...
  *
+ * The components of a non-scalar pixel type are additional tensor
+ * dimensions.  With the default itkComponentsLast layout they follow
+ * the index dimensions, [slice][row][col][component], so that the
+ * buffer is laid out as for an itk::Image.  With the
+ * itkComponentsFirst layout they precede the index dimensions,
+ * [component][slice][row][col], as most models expect.  GetPixel(),
+ * SetPixel() and FillBuffer() take and return whole pixels in either
+ * layout.  GetBufferPointer() always points at the first deep scalar
+ * of the buffer; only with itkComponentsLast can the buffer be used as
+ * an array of TPixel.
+ *
  * \sa ImageBase
  *
  * \ingroup PyTorch
@@ -77,7 +96,16 @@ public:
   using ConstPointer = SmartPointer< const Self >;
   using ConstWeakPointer = WeakPointer< const Self >;
 
-  /** Method for creation through the object factory. */
+  /** Method for creation through the object factory.  This also
+   * defines Clone(), which returns a deep copy of the image whose
+   * pixels are copied lazily: the clone shares this image's storage
+   * until either image is written (see MakeTensorWritable()), and only
+   * the image written first copies them, so a clone that is never
+   * written costs no pixel memory.  The meta information, device,
+   * component layout and DirectCPUAccess are copied.  The pixels of
+   * an image whose storage is already shared with region views made
+   * by GraftRegion(), or with other tensors, are copied right away,
+   * as those write without checking for a clone. */
   itkNewMacro( Self );
 
   /** Run-time type information (and related methods). */
@@ -149,6 +177,11 @@ public:
   template< typename UPixelType, unsigned int NUImageDimension = ImageDimension >
   using RebindImageType = itk::TorchImage< UPixelType, NUImageDimension >;
 
+  /** The itk::Image type with the same pixel type and dimension, for
+   * use with FromImage() and ToImage(). */
+  using ITKImageType = Image< TPixel, VImageDimension >;
+  using ITKImagePointer = typename ITKImageType::Pointer;
+
   using TorchImagePixelHelper = TorchPixelHelper< PixelType >;
   using DeepScalarType = typename TorchImagePixelHelper::DeepScalarType;
   static constexpr unsigned int PixelDimension = TorchImagePixelHelper::PixelDimension;
@@ -156,6 +189,8 @@ public:
 
   enum DeviceType { itkCPU, itkCUDA };
   enum TensorInitializer { itkEmpty, itkZeros, itkOnes, itkRand, itkRandn };
+  enum ComponentLayoutType { itkComponentsLast, itkComponentsFirst };
+  enum MemoryMapModeType { itkMapReadOnly, itkMapCopyOnWrite, itkMapShared };
 
   /** Select itkCUDA (on device #0) or itkCPU */
   bool SetDevice( DeviceType deviceType );
@@ -164,15 +199,101 @@ public:
   bool SetDevice( DeviceType deviceType, uint64_t cudaDeviceNumber );
 
   /** Query current device type and device number */
-  void GetDevice( DeviceType &deviceType, uint64_t &cudaDeviceNumber );
+  void GetDevice( DeviceType &deviceType, uint64_t &cudaDeviceNumber ) const;
+
+  /** Select the device and component layout of another TorchImage of
+   * the same dimension, e.g. for the output of a filter before it is
+   * allocated. */
+  template< typename TOtherPixel >
+  void CopyTensorInformation( const TorchImage< TOtherPixel, VImageDimension > *image )
+    {
+    typename TorchImage< TOtherPixel, VImageDimension >::DeviceType deviceType;
+    uint64_t cudaDeviceNumber;
+    image->GetDevice( deviceType, cudaDeviceNumber );
+    if( deviceType == TorchImage< TOtherPixel, VImageDimension >::itkCUDA )
+      {
+      this->SetDevice( itkCUDA, cudaDeviceNumber );
+      }
+    else
+      {
+      this->SetDevice( itkCPU );
+      }
+    this->SetComponentLayout( static_cast< ComponentLayoutType >( image->GetComponentLayout() ) );
+    }
+
+  /** Select whether the pixel component dimensions follow
+   * (itkComponentsLast, the default) or precede (itkComponentsFirst)
+   * the index dimensions of the tensor.  If the image is allocated,
+   * its pixels are re-laid out into a contiguous tensor.  No pixels
+   * are copied when the permuted tensor is contiguous already, e.g.
+   * for scalar pixel types or single-component pixels. */
+  void SetComponentLayout( ComponentLayoutType componentLayout );
+  ComponentLayoutType GetComponentLayout() const
+    {
+    return m_ComponentLayout;
+    }
+
+  /** The tensor dimension of the slowest varying index dimension,
+   * i.e. of the last component of an IndexType.  The other index
+   * dimensions follow it in reverse order. */
+  unsigned int GetFirstIndexTorchDimension() const
+    {
+    return m_ComponentLayout == itkComponentsFirst ? Self::PixelDimension : 0;
+    }
+
+  /** The tensor dimension of the outermost pixel component dimension.
+   * Any nested component dimensions follow it. */
+  unsigned int GetFirstComponentTorchDimension() const
+    {
+    return m_ComponentLayout == itkComponentsFirst ? 0 : Self::ImageDimension;
+    }
+
+  /** Return a view of a tensor of this image type in which the pixel
+   * component dimensions are moved from one layout to another.  No
+   * pixels are copied. */
+  static torch::Tensor PermuteComponentLayout( const torch::Tensor & tensor, ComponentLayoutType fromLayout, ComponentLayoutType toLayout );
+
+  /** Return a view of a tensor holding the pixels of bufferedRegion in
+   * componentLayout, narrowed to region, which must lie within
+   * bufferedRegion.  The tensor may have fewer pixel component
+   * dimensions than this image type, or broadcastable ones, as long as
+   * its index dimensions are first (itkComponentsLast) or last
+   * (itkComponentsFirst).  No pixels are copied. */
+  static torch::Tensor NarrowToRegion( const torch::Tensor & tensor, ComponentLayoutType componentLayout,
+    const RegionType & bufferedRegion, const RegionType & region );
 
   /** Allocate the torch image memory. The size of the torch image
    * must already be set, e.g. by calling SetRegions().  Returns false
-   * if allocation to a non-existent GPU fails. */
+   * if allocation to a non-existent GPU fails.  If the
+   * TorchTensorPool is enabled, the tensor is taken from the pool
+   * where possible. */
   void Allocate( TensorInitializer tensorInitializer = itkEmpty );
 
+  /** Allocate the torch image memory as a memory mapping of a file,
+   * for images that do not fit in RAM.  The size of the torch image
+   * and its component layout must already be set.  The file holds the
+   * raw, contiguous tensor, starting at byte offset, in native byte
+   * order.  Pages are read from the file only when pixels are
+   * accessed, and processes that map the same file share the pages in
+   * memory.  The tensor resides in CPU memory and is never returned to
+   * the TorchTensorPool; the mapping is removed when the last tensor
+   * using it is released.
+   *
+   * With itkMapReadOnly, the image is read-only: the methods that
+   * write, or hand out pixels to write, throw an exception (see
+   * MakeTensorWritable()), as do writes through GetPixel().  Its
+   * clones copy the pixels on their first write as usual, and
+   * ToImage() copies them into the itk::Image.  Writing through
+   * GetTensor() is not checked and crashes the process.  With itkMapCopyOnWrite, written pages become private to this
+   * process and the file is not changed.  With itkMapShared, writes go
+   * to the file, which is extended if it is too short.  Memory mapping
+   * is not supported on Windows. */
+  void AllocateFromFile( const std::string & fileName, MemoryMapModeType memoryMapMode = itkMapReadOnly,
+    uint64_t offset = 0 );
+
   /** Restore the data object to its initial state. This means releasing
-   * memory. */
+   * memory.  A tensor that was allocated by Allocate() and is not
+   * shared is returned to the TorchTensorPool, if it is enabled. */
   void Initialize() override;
 
   /** Fill the torch image buffer with a value.  Be sure to call
@@ -182,21 +303,38 @@ public:
   typename std::enable_if< PixelDimension == 0, T >::type
   FillBuffer( const PixelType &value )
     {
+    this->MakeTensorWritable( false );
     m_Tensor.fill_( value );
     }
 
   /** Fill the torch image buffer with a value.  Be sure to call
    * Allocate() first. This version is for pixel types that are not
-   * simple scalars. */
+   * simple scalars.  The components of the value are gathered into a
+   * small tensor once, by PixelToTensor(), which is then broadcast over
+   * the whole buffer in a single operation. */
   template< typename T = void >
   typename std::enable_if< PixelDimension != 0, T >::type
   FillBuffer( const PixelType &value )
     {
-    const SizeType &bufferSize = Self::GetBufferedRegion().GetSize();
-    std::vector< at::indexing::TensorIndex > TorchIndex;
-    FillBufferPart( Self::ImageDimension, bufferSize, TorchIndex, value );
+    this->MakeTensorWritable( false );
+    m_Tensor.copy_( Self::PixelToTensor( value, m_ComponentLayout ) );
     }
 
+  /** Return a CPU tensor of TorchValueType holding the components of
+   * a pixel, shaped so that it broadcasts over every pixel of a tensor
+   * of this image type with the given component layout.  A scalar
+   * pixel gives a zero-dimensional tensor. */
+  static torch::Tensor PixelToTensor( const PixelType &value, ComponentLayoutType componentLayout );
+
+  /** When on (the default) and the tensor resides in CPU memory,
+   * GetPixel(), SetPixel() and operator[] compute the pixel's address
+   * from the tensor strides and read or write the DeepScalarType
+   * memory directly, rather than dispatching an indexing operation
+   * through ATen for each access. */
+  itkSetMacro( DirectCPUAccess, bool );
+  itkGetConstMacro( DirectCPUAccess, bool );
+  itkBooleanMacro( DirectCPUAccess );
+
   /** \brief Set a pixel value.
    *
    * Allocate() needs to have been called first -- for efficiency,
@@ -207,7 +345,10 @@ public:
   /** \brief Get a reference to a pixel (e.g. for editing).
    *
    * For efficiency, this function does not check that the
-   * torch image has actually been allocated yet. */
+   * torch image has actually been allocated yet.  Reading the
+   * reference of the non-const version reads pixels that may still be
+   * shared with a clone; its first write copies them (see Clone()),
+   * or throws for a read-only image. */
   TorchImagePixelHelper GetPixel( const IndexType & index );
   const TorchImagePixelHelper GetPixel( const IndexType & index ) const;
 
@@ -226,13 +367,122 @@ public:
     }
 
   /** The pointer might be to GPU memory and, if so, could not be
-   * dereferenced */
+   * dereferenced.  For a view created by GraftRegion() the pointer is
+   * to the first pixel of the view, but the pixels are generally not
+   * contiguous; the tensor strides give their layout.  As the pixels
+   * may be written, this copies the pixels of a copy-on-write image
+   * that still shares them; see Clone(). */
   virtual TPixel *GetBufferPointer();
 
   /** The pointer might be to GPU memory and, if so, could not be
    * dereferenced */
   virtual const TPixel *GetBufferPointer() const;
 
+  /** The enum representation of the data type in the underlying torch
+   * library. */
+  static constexpr at::ScalarType TorchValueType = at::native::cppmap::detail::CPPTypeToScalarType< DeepScalarType >::value();
+
+  /** The first dimension of an image index varies the quickest in the
+   * underlying buffer with ITK generally (e.g. class Image) but the
+   * first dimension varies slowest with the underlying C++ Torch
+   * library, so the index components of this TorchSize are in reverse
+   * order compared to the rest of ITK.  Additionally, TorchImage
+   * represents a non-scalar pixel type as an additional dimension in
+   * the last position, with size equal to the number of components of
+   * the non-scalar pixel type, and varying faster than the index
+   * dimensions.  The non-scalar pixel representation is recursive in
+   * that a non-scalar pixel type A with X components that are a
+   * non-scalar pixel type B with Y components would have dimensions
+   * of size X and Y beyond the index, with the dimension for B being
+   * last and varying the fastest in the underlying buffer.  With the
+   * itkComponentsFirst layout, the dimensions of size X and Y come
+   * first instead, before the index dimensions. */
+  std::vector< int64_t > ComputeTorchSize() const;
+
+  /** The torch::Tensor holding the pixel data.  The returned handle
+   * shares storage with this image.  Call MakeTensorWritable() before
+   * writing through it. */
+  torch::Tensor GetTensor() const
+    {
+    return m_Tensor;
+    }
+
+  /** Use a tensor as the pixel data, sharing rather than copying its
+   * storage.  The buffered region must already be set; the tensor's
+   * dtype must be TorchValueType and its sizes must be those given by
+   * ComputeTorchSize().  The device is taken from the tensor. */
+  void SetTensor( const torch::Tensor & tensor );
+
+  /** Create a CPU TorchImage that uses the pixel buffer of an
+   * itk::Image without copying it.  The tensor holds a reference to
+   * the image's pixel container, which therefore lives at least as
+   * long as the tensor.  The origin, spacing, direction and regions
+   * are copied from the image. */
+  static Pointer FromImage( ITKImageType *image );
+
+  /** Create an itk::Image that uses the pixel buffer of this
+   * TorchImage without copying it.  The image's pixel container holds
+   * a reference to the tensor, which therefore lives at least as long
+   * as the container.  The origin, spacing, direction and regions are
+   * copied from this TorchImage.  The tensor must reside in CPU
+   * memory.  If the tensor is not contiguous in the itkComponentsLast
+   * layout, e.g. because it is a view or uses itkComponentsFirst, the
+   * pixels are copied into a contiguous buffer first.  Otherwise, as
+   * the itk::Image may be written, the pixels of a copy-on-write image
+   * that still shares them are copied into storage of this image's
+   * own first (see MakeTensorWritable()), and those of a read-only
+   * image are copied into the itk::Image. */
+  ITKImagePointer ToImage() const;
+
+  /** Whether this image is a Clone(), or the source of one, whose
+   * tensor still shares its pixels with another image, or a clone of a
+   * read-only image, so that they are copied before the first write. */
+  bool IsTensorShared() const;
+
+  /** Whether the pixels are memory mapped read-only by
+   * AllocateFromFile(), so that writing them throws an exception. */
+  itkGetConstMacro( ReadOnly, bool );
+
+  /** Prepare the tensor of a copy-on-write image for writing: if it
+   * still shares its pixels with a clone, they are copied into storage
+   * of this image's own (or, with preservePixels off, storage is
+   * allocated without copying them, for callers that overwrite every
+   * pixel).  The images grafted from this one share its tensor, so
+   * they keep seeing the same pixels.  SetPixel(), writes through the
+   * non-const GetPixel(), FillBuffer(), the non-const
+   * GetBufferPointer(), ToImage(), iterators that write and in-place
+   * filters call this; code that
+   * writes to GetTensor() must call it too.  Throws an exception for a
+   * read-only image, whose pixels cannot be written.  Returns whether
+   * the storage was replaced. */
+  bool MakeTensorWritable( bool preservePixels = true );
+
+  /** Export the pixels as a DLPack tensor, without copying them, for
+   * other array libraries.  The DLPack tensor has the sizes given by
+   * ComputeTorchSize(), in the component layout of this image, and
+   * the strides of the tensor, so views made by GraftRegion() are
+   * exported as they are.  It holds a reference to the storage, which
+   * therefore stays valid until the consumer calls its deleter.  The
+   * geometry of the image is not part of DLPack; pass this image to
+   * FromDLPack() to restore it.  As the consumer may write the pixels,
+   * the pixels of a copy-on-write image are copied first if they are
+   * still shared.  DLPack has no boolean type, so bool images cannot
+   * be exported. */
+  DLManagedTensor * ToDLPack();
+
+  /** Create a TorchImage that uses the memory of a DLPack tensor
+   * without copying it, e.g. one exported by NumPy, CuPy or torch.
+   * The image takes ownership of dlManagedTensor, calling its deleter
+   * when the tensor is released, also if an exception is thrown.  The
+   * data type must be TorchValueType, and the sizes those given by
+   * ComputeTorchSize() for componentLayout.  The origin, spacing,
+   * direction and regions are copied from geometry, whose buffered
+   * region, or else largest possible region, must match the sizes.
+   * Without geometry the regions start at index zero and are sized
+   * after the tensor.  The device is that of the tensor. */
+  static Pointer FromDLPack( DLManagedTensor * dlManagedTensor, const ImageBase< VImageDimension > * geometry = nullptr,
+    ComponentLayoutType componentLayout = itkComponentsLast );
+
   /** Graft the data and information from one image to another. This
    * is a convenience method to setup a second image with all the meta
    * information of another image and use the same pixel
@@ -242,9 +492,43 @@ public:
    * ImageSource::GraftOutput(). The implementation in ImageBase
    * simply calls CopyInformation() and copies the region ivars.
    * The implementation here refers to the superclass' implementation
-   * and then copies over the pixel container. */
+   * and then shares the tensor handle, so that both images keep using
+   * the same pixels even when MakeTensorWritable() gives one of them
+   * new storage. */
   virtual void Graft( const Self * data );
 
+  /** Graft a sub-region of another image.  The buffered and requested
+   * regions of this image become the given region, which must lie
+   * within the buffered region of data, and the tensor becomes a view
+   * of data's tensor narrowed to that region.  The view keeps data's
+   * strides and shares its storage through the tensor's reference
+   * count, so no pixels are copied and the storage stays valid for as
+   * long as either image uses it.  If data still shares its pixels
+   * with a Clone(), data copies them first (see MakeTensorWritable()),
+   * so that writes through the view reach data and not the clone.  The
+   * largest possible region and the rest of the meta information are
+   * copied from data. */
+  virtual void GraftRegion( const Self * data, const RegionType & region );
+
+  /** Return a new TorchImage that is a view of a sub-region of this
+   * image, as set up by GraftRegion(). */
+  Pointer CreateRegionView( const RegionType & region ) const;
+
+  /** The counts, bytes and wall times of the allocations, device
+   * transfers, implicit copies and pixel proxy accesses of this image
+   * since its construction or ResetInstrumentationCounters(), while
+   * the TorchInstrumentation was enabled.  The image also invokes a
+   * TorchInstrumentationEvent for each of them. */
+  const TorchInstrumentationCounters & GetInstrumentationCounters() const
+    {
+    return m_InstrumentationCounters;
+    }
+
+  void ResetInstrumentationCounters()
+    {
+    m_InstrumentationCounters.Reset();
+    }
+
   constexpr unsigned int GetNumberOfComponentsPerPixel() const override
     {
     return Self::TorchImagePixelHelper::NumberOfComponents;
@@ -252,37 +536,35 @@ public:
 
 protected:
   TorchImage();
-  ~TorchImage() override = default;
+  ~TorchImage() override;
   void PrintSelf( std::ostream & os, Indent indent ) const override;
   void Graft( const DataObject * data ) override;
 
-  /** Recursively fill part of the full buffer */
-  void FillBufferPart( int CurrentDimensions, const SizeType &BufferSize, std::vector< at::indexing::TensorIndex > &TorchIndex, const PixelType &value );
-
-  /** The enum representation of the data type in the underlying torch
-   * library. */
-  static constexpr at::ScalarType TorchValueType = at::native::cppmap::detail::CPPTypeToScalarType< DeepScalarType >::value();
-
-  /** The first dimension of an image index varies the quickest in the
-   * underlying buffer with ITK generally (e.g. class Image) but the
-   * first dimension varies slowest with the underlying C++ Torch
-   * library, so the index components of this TorchSize are in reverse
-   * order compared to the rest of ITK.  Additionally, TorchImage
-   * represents a non-scalar pixel type as an additional dimension in
-   * the last position, with size equal to the number of components of
-   * the non-scalar pixel type, and varying faster than the index
-   * dimensions.  The non-scalar pixel representation is recursive in
-   * that a non-scalar pixel type A with X components that are a
-   * non-scalar pixel type B with Y components would have dimensions
-   * of size X and Y beyond the index, with the dimension for B being
-   * last and varying the fastest in the underlying buffer. */
-  std::vector< int64_t > ComputeTorchSize() const;
+  /** Support Clone(), which itkNewMacro() defines. */
+  LightObject::Pointer InternalClone() const override;
 
   /** Support the ImageBase::Graft methods.
    */
   using Superclass::Graft;
 
+  /** Drop the tensor, offering it to the TorchTensorPool if it was
+   * allocated by Allocate(). */
+  void ReleaseTensor();
+
+  /** Map numberOfBytes bytes of a file, starting at offset, into
+   * memory, as described for AllocateFromFile().  If numberOfBytes is
+   * zero, the rest of the file is mapped and numberOfBytes is set
+   * accordingly.  data is set to the first mapped byte.  The mapping
+   * is removed when the last copy of the returned pointer is
+   * released. */
+  static std::shared_ptr< void > MapFile( const std::string & fileName, MemoryMapModeType memoryMapMode, uint64_t offset,
+    uint64_t & numberOfBytes, void * & data );
+
 private:
+  /** Saves and loads the tensor and the members of the image. */
+  template< typename TImage >
+  friend class TorchImageSerializer;
+
   /** itkCUDA or itkCPU */
   DeviceType m_DeviceType;
 
@@ -292,9 +574,31 @@ private:
   /** Defaults to zero */
   uint64_t m_CudaDeviceNumber;
 
+  /** Whether pixel access to CPU tensors bypasses ATen */
+  bool m_DirectCPUAccess;
+
+  /** Position of the pixel component dimensions in the tensor */
+  ComponentLayoutType m_ComponentLayout;
+
+  /** Whether m_Tensor was allocated by Allocate() and may be
+   * returned to the TorchTensorPool */
+  bool m_Poolable;
+
+  /** Whether m_Tensor may share its storage with a clone, and must be
+   * checked before it is written.  Set by the const Clone() on its
+   * source, too. */
+  mutable bool m_CopyOnWrite;
+
+  /** Whether m_Tensor is a read-only memory mapping, whose pixels
+   * must be copied, by a clone, or not written at all */
+  bool m_ReadOnly;
+
   /** The torch::Tensor object points to the pixel data and also
    * stores information about size, data type, device, etc. */
   torch::Tensor m_Tensor;
+
+  /** Counted also by const methods such as ToImage() and GetPixel() */
+  mutable TorchInstrumentationCounters m_InstrumentationCounters;
 };
 } // end namespace itk
 
@@ -20,6 +20,16 @@
 
 #include "itkTorchImage.h"
 
+#include <cerrno>
+#include <cstring>
+#include <ATen/DLConvertor.h>
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 namespace itk
 {
 
@@ -61,7 +71,10 @@ TorchImage< TPixel, VImageDimension >
       // Change from GPU to CPU
       if( m_Allocated )
         {
+        TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkDeviceTransfer, &m_InstrumentationCounters, this );
         m_Tensor = m_Tensor.to( torch::kCPU );
+        m_ReadOnly = false;
+        probe.Stop( m_Tensor.nbytes() );
         }
       m_DeviceType = deviceType;
     }
@@ -87,7 +100,10 @@ TorchImage< TPixel, VImageDimension >
         }
       if( m_Allocated )
         {
+        TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkDeviceTransfer, &m_InstrumentationCounters, this );
         m_Tensor = m_Tensor.to( torch::kCUDA, cudaDeviceNumber );
+        m_ReadOnly = false;
+        probe.Stop( m_Tensor.nbytes() );
         }
       m_DeviceType = deviceType;
       m_CudaDeviceNumber = cudaDeviceNumber;
@@ -104,7 +120,7 @@ TorchImage< TPixel, VImageDimension >
 template< typename TPixel, unsigned int VImageDimension >
 void
 TorchImage< TPixel, VImageDimension >
-::GetDevice( DeviceType &deviceType, uint64_t &cudaDeviceNumber )
+::GetDevice( DeviceType &deviceType, uint64_t &cudaDeviceNumber ) const
 {
   deviceType = m_DeviceType;
   cudaDeviceNumber = m_CudaDeviceNumber;
@@ -119,15 +135,102 @@ TorchImage< TPixel, VImageDimension >
   // the first one varies the slowest in the buffer.
   const SizeType &bufferSize = Self::GetBufferedRegion().GetSize();
   std::vector< int64_t > torchSize;
+  if( m_ComponentLayout == itkComponentsFirst )
+    {
+    // Prepend 0 or more dimension sizes representing non-scalar pixels.
+    Self::TorchImagePixelHelper::AppendSizes( torchSize );
+    }
   for( SizeValueType i = 0; i < Self::ImageDimension; ++i )
     {
     torchSize.push_back( bufferSize[Self::ImageDimension-1-i] );
     }
-  // Append 0 or more dimension sizes representing non-scalar pixels.
-  Self::TorchImagePixelHelper::AppendSizes( torchSize );
+  if( m_ComponentLayout == itkComponentsLast )
+    {
+    // Append 0 or more dimension sizes representing non-scalar pixels.
+    Self::TorchImagePixelHelper::AppendSizes( torchSize );
+    }
   return torchSize;
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+torch::Tensor
+TorchImage< TPixel, VImageDimension >
+::PermuteComponentLayout( const torch::Tensor & tensor, ComponentLayoutType fromLayout, ComponentLayoutType toLayout )
+{
+  if( fromLayout == toLayout || Self::PixelDimension == 0 )
+    {
+    return tensor;
+    }
+  // Rotate the component dimensions from one end of the tensor
+  // dimensions to the other.
+  const unsigned int fromFirstComponent = fromLayout == itkComponentsFirst ? 0 : Self::ImageDimension;
+  const unsigned int fromFirstIndex = fromLayout == itkComponentsFirst ? Self::PixelDimension : 0;
+  std::vector< int64_t > permutation;
+  if( toLayout == itkComponentsFirst )
+    {
+    for( unsigned int i = 0; i < Self::PixelDimension; ++i )
+      {
+      permutation.push_back( fromFirstComponent + i );
+      }
+    }
+  for( unsigned int i = 0; i < Self::ImageDimension; ++i )
+    {
+    permutation.push_back( fromFirstIndex + i );
+    }
+  if( toLayout == itkComponentsLast )
+    {
+    for( unsigned int i = 0; i < Self::PixelDimension; ++i )
+      {
+      permutation.push_back( fromFirstComponent + i );
+      }
+    }
+  return tensor.permute( permutation );
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+torch::Tensor
+TorchImage< TPixel, VImageDimension >
+::PixelToTensor( const PixelType &value, ComponentLayoutType componentLayout )
+{
+  DeepScalarType deepScalars[TorchImagePixelHelper::SizeOf];
+  TorchImagePixelHelper::CopyToDeepScalars( value, deepScalars );
+  std::vector< int64_t > pixelSize;
+  TorchImagePixelHelper::AppendSizes( pixelSize );
+  if( componentLayout == itkComponentsFirst && Self::PixelDimension != 0 )
+    {
+    // Broadcast over the trailing index dimensions.
+    pixelSize.insert( pixelSize.end(), Self::ImageDimension, 1 );
+    }
+  // deepScalars is about to go out of scope.
+  return torch::from_blob( deepScalars, pixelSize, torch::dtype( Self::TorchValueType ) ).clone();
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImage< TPixel, VImageDimension >
+::SetComponentLayout( ComponentLayoutType componentLayout )
+{
+  if( componentLayout == m_ComponentLayout )
+    {
+    return;
+    }
+  if( m_Allocated )
+    {
+    // contiguous() copies only if the permuted view is not already
+    // contiguous.
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkCopy, &m_InstrumentationCounters, this );
+    const void * const data = m_Tensor.data_ptr();
+    m_Tensor = Self::PermuteComponentLayout( m_Tensor, m_ComponentLayout, componentLayout ).contiguous();
+    if( m_Tensor.data_ptr() != data )
+      {
+      m_ReadOnly = false;
+      probe.Stop( m_Tensor.nbytes() );
+      }
+    }
+  m_ComponentLayout = componentLayout;
+  this->Modified();
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 void
 TorchImage< TPixel, VImageDimension >
@@ -151,24 +254,176 @@ TorchImage< TPixel, VImageDimension >
       break;
     }
 
+  // The previous tensor, if any, goes back to the pool before the new
+  // one is taken, so that re-allocating the same size can reuse it.
+  this->ReleaseTensor();
+  TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkAllocation, &m_InstrumentationCounters, this );
+  m_Tensor = TorchTensorPool::GetInstance()->Acquire( torchSize, tensorOptions );
+  m_Poolable = true;
+
   switch( tensorInitializer )
     {
     case itkEmpty:
-      m_Tensor = torch::empty( torchSize, tensorOptions );
       break;
     case itkZeros:
-      m_Tensor = torch::zeros( torchSize, tensorOptions );
+      m_Tensor.zero_();
       break;
     case itkOnes:
-      m_Tensor = torch::ones( torchSize, tensorOptions );
+      m_Tensor.fill_( 1 );
       break;
     case itkRand:
-      m_Tensor = torch::rand( torchSize, tensorOptions );
+      m_Tensor.uniform_();
       break;
     case itkRandn:
-      m_Tensor = torch::randn( torchSize, tensorOptions );
+      m_Tensor.normal_();
       break;
     }
+  probe.Stop( m_Tensor.nbytes() );
+  m_Allocated = true;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImage< TPixel, VImageDimension >
+::AllocateFromFile( const std::string & fileName, MemoryMapModeType memoryMapMode, uint64_t offset )
+{
+  const std::vector< int64_t > torchSize = this->ComputeTorchSize();
+  int64_t numberOfElements = 1;
+  for( const int64_t size : torchSize )
+    {
+    numberOfElements *= size;
+    }
+  uint64_t numberOfBytes = static_cast< uint64_t >( numberOfElements ) * sizeof( DeepScalarType );
+  if( numberOfBytes == 0 )
+    {
+    itkExceptionMacro( << "AllocateFromFile() requires a non-empty buffered region" );
+    }
+
+  void *data = nullptr;
+  const std::shared_ptr< void > mapping = Self::MapFile( fileName, memoryMapMode, offset, numberOfBytes, data );
+  const auto deleter = [mapping]( void * ) {};
+  this->ReleaseTensor();
+  m_Tensor = torch::from_blob( data, torchSize, deleter, torch::dtype( Self::TorchValueType ).device( torch::kCPU ) );
+  m_ReadOnly = memoryMapMode == itkMapReadOnly;
+  m_DeviceType = itkCPU;
+  m_CudaDeviceNumber = 0;
+  m_Allocated = true;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+std::shared_ptr< void >
+TorchImage< TPixel, VImageDimension >
+::MapFile( const std::string & fileName, MemoryMapModeType memoryMapMode, uint64_t offset, uint64_t & numberOfBytes,
+  void * & data )
+{
+#ifdef _WIN32
+  (void)memoryMapMode;
+  (void)offset;
+  (void)numberOfBytes;
+  (void)data;
+  itkGenericExceptionMacro( << "Memory mapping is not supported on Windows; cannot map " << fileName );
+#else
+  const int fileDescriptor = open( fileName.c_str(), memoryMapMode == itkMapShared ? O_RDWR | O_CREAT : O_RDONLY, 0666 );
+  if( fileDescriptor < 0 )
+    {
+    itkGenericExceptionMacro( << "Cannot open " << fileName << ": " << std::strerror( errno ) );
+    }
+  struct stat fileStatus;
+  if( fstat( fileDescriptor, &fileStatus ) != 0 )
+    {
+    const int error = errno;
+    close( fileDescriptor );
+    itkGenericExceptionMacro( << "Cannot stat " << fileName << ": " << std::strerror( error ) );
+    }
+  const uint64_t fileSize = static_cast< uint64_t >( fileStatus.st_size );
+  if( numberOfBytes == 0 )
+    {
+    numberOfBytes = fileSize > offset ? fileSize - offset : 0;
+    if( numberOfBytes == 0 )
+      {
+      close( fileDescriptor );
+      itkGenericExceptionMacro( << fileName << " has no bytes to map after offset " << offset );
+      }
+    }
+  if( fileSize < offset + numberOfBytes )
+    {
+    if( memoryMapMode != itkMapShared )
+      {
+      close( fileDescriptor );
+      itkGenericExceptionMacro( << fileName << " has " << fileSize << " bytes but " << offset + numberOfBytes
+        << " are needed" );
+      }
+    if( ftruncate( fileDescriptor, static_cast< off_t >( offset + numberOfBytes ) ) != 0 )
+      {
+      const int error = errno;
+      close( fileDescriptor );
+      itkGenericExceptionMacro( << "Cannot extend " << fileName << ": " << std::strerror( error ) );
+      }
+    }
+
+  // mmap requires an offset that is a multiple of the page size.
+  const uint64_t pageSize = static_cast< uint64_t >( sysconf( _SC_PAGESIZE ) );
+  const uint64_t pageOffset = offset % pageSize;
+  const size_t mappedBytes = static_cast< size_t >( pageOffset + numberOfBytes );
+  int protection = PROT_READ;
+  int flags = MAP_SHARED;
+  switch( memoryMapMode )
+    {
+    case itkMapReadOnly:
+      break;
+    case itkMapCopyOnWrite:
+      protection |= PROT_WRITE;
+      flags = MAP_PRIVATE;
+      break;
+    case itkMapShared:
+      protection |= PROT_WRITE;
+      break;
+    }
+  void * const mapping = mmap( nullptr, mappedBytes, protection, flags, fileDescriptor,
+    static_cast< off_t >( offset - pageOffset ) );
+  const int error = errno;
+  // The mapping stays valid after the file is closed.
+  close( fileDescriptor );
+  if( mapping == MAP_FAILED )
+    {
+    itkGenericExceptionMacro( << "Cannot map " << fileName << ": " << std::strerror( error ) );
+    }
+
+  data = static_cast< char * >( mapping ) + pageOffset;
+  return std::shared_ptr< void >( mapping, [mappedBytes]( void *address ) { munmap( address, mappedBytes ); } );
+#endif
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImage< TPixel, VImageDimension >
+::SetTensor( const torch::Tensor & tensor )
+{
+  if( tensor.scalar_type() != Self::TorchValueType )
+    {
+    itkExceptionMacro( << "SetTensor() expects a tensor of type " << Self::TorchValueType
+      << " but got " << tensor.scalar_type() );
+    }
+  const std::vector< int64_t > torchSize = this->ComputeTorchSize();
+  if( tensor.sizes() != torch::IntArrayRef( torchSize ) )
+    {
+    itkExceptionMacro( << "SetTensor() expects a tensor of sizes " << torch::IntArrayRef( torchSize )
+      << " but got " << tensor.sizes() );
+    }
+
+  if( tensor.is_cuda() )
+    {
+    m_DeviceType = itkCUDA;
+    m_CudaDeviceNumber = tensor.device().index();
+    }
+  else
+    {
+    m_DeviceType = itkCPU;
+    m_CudaDeviceNumber = 0;
+    }
+  const torch::Tensor newTensor = tensor;
+  this->ReleaseTensor();
+  m_Tensor = newTensor;
   m_Allocated = true;
 }
 
@@ -188,29 +443,61 @@ TorchImage< TPixel, VImageDimension >
   // Replace the handle to the buffer. This is the safest thing to do,
   // since the same container can be shared by multiple images (e.g.
   // Grafted outputs and in place filters).
-  m_Tensor = torch::Tensor();
+  this->ReleaseTensor();
   m_Allocated = false;
 }
 
 template< typename TPixel, unsigned int VImageDimension >
 void
 TorchImage< TPixel, VImageDimension >
-::FillBufferPart( int CurrentDimensions, const SizeType &BufferSize, std::vector< at::indexing::TensorIndex > &TorchIndex, const PixelType &value )
+::ReleaseTensor()
 {
-  if( CurrentDimensions == 0 )
+  if( m_Poolable )
     {
-    TorchImagePixelHelper {m_Tensor, TorchIndex} = value;
+    // The pool takes the tensor only if no other image or view still
+    // shares its storage.
+    TorchTensorPool::GetInstance()->Release( m_Tensor );
+    m_Poolable = false;
     }
-  else
+  m_Tensor = torch::Tensor();
+  m_CopyOnWrite = false;
+  m_ReadOnly = false;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+bool
+TorchImage< TPixel, VImageDimension >
+::IsTensorShared() const
+{
+  return m_CopyOnWrite && m_Tensor.defined() && ( m_ReadOnly || m_Tensor.storage().use_count() > 1 );
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+bool
+TorchImage< TPixel, VImageDimension >
+::MakeTensorWritable( bool preservePixels )
+{
+  if( m_ReadOnly && !m_CopyOnWrite )
     {
-    // Slowest varying dimension in BufferSize is last
-    for( SizeValueType i = 0; i < BufferSize[CurrentDimensions-1]; ++i )
-      {
-      TorchIndex.push_back( static_cast< int64_t >( i ) );
-      FillBufferPart( CurrentDimensions-1, BufferSize, TorchIndex, value );
-      TorchIndex.pop_back();
-      }
+    itkExceptionMacro( << "The pixels of this TorchImage are memory mapped read-only" );
+    }
+  const bool shared = this->IsTensorShared();
+  m_CopyOnWrite = false;
+  if( !shared )
+    {
+    return false;
     }
+
+  TorchInstrumentationProbe probe( preservePixels ? TorchInstrumentationCounters::itkCopy
+    : TorchInstrumentationCounters::itkAllocation, &m_InstrumentationCounters, this );
+  const torch::Tensor storage = preservePixels ? m_Tensor.clone( at::MemoryFormat::Contiguous )
+    : torch::empty( m_Tensor.sizes(), m_Tensor.options() );
+  // set_() changes the storage of the tensor itself rather than this
+  // image's handle, so the images grafted from this one follow.
+  m_Tensor.set_( storage );
+  m_ReadOnly = false;
+  probe.Stop( storage.nbytes() );
+  return true;
 }
 
 template< typename TPixel, unsigned int VImageDimension >
@@ -218,7 +505,9 @@ void
 TorchImage< TPixel, VImageDimension >
 ::SetPixel( const IndexType & index, const PixelType & value )
 {
-  GetPixel( index ) = value;
+  this->MakeTensorWritable();
+  TorchImagePixelHelper pixel = static_cast< const Self * >( this )->GetPixel( index );
+  pixel = value;
 }
 
 template< typename TPixel, unsigned int VImageDimension >
@@ -226,12 +515,18 @@ typename TorchImage< TPixel, VImageDimension >::TorchImagePixelHelper
 TorchImage< TPixel, VImageDimension >
 ::GetPixel( const IndexType & index )
 {
-  std::vector< at::indexing::TensorIndex > TorchIndex;
-  for( unsigned int i = 0; i < Self::ImageDimension; ++i )
+  TorchImagePixelHelper pixel = static_cast< const Self * >( this )->GetPixel( index );
+  // Reading needs no pixels of this image's own, so the helper makes
+  // them writable only when it is written.
+  if( m_ReadOnly || this->IsTensorShared() )
     {
-    TorchIndex.push_back( static_cast< int64_t >( index[Self::ImageDimension-1-i] ) );
+    pixel.m_MakeWritable = [this, index]()
+      {
+      this->MakeTensorWritable();
+      return static_cast< const Self * >( this )->GetPixel( index );
+      };
     }
-  return TorchImagePixelHelper { m_Tensor, TorchIndex };
+  return pixel;
 }
 
 template< typename TPixel, unsigned int VImageDimension >
@@ -239,12 +534,31 @@ const typename TorchImage< TPixel, VImageDimension >::TorchImagePixelHelper
 TorchImage< TPixel, VImageDimension >
 ::GetPixel( const IndexType & index ) const
 {
+  // The tensor starts at the first index of the buffered region.
+  const IndexType &bufferedIndex = Self::GetBufferedRegion().GetIndex();
+  if( m_DirectCPUAccess && m_Tensor.is_cpu() )
+    {
+    // The index dimensions are in reverse order in the tensor, and the
+    // pixel component dimensions are consecutive.
+    const int64_t * const strides = m_Tensor.strides().data();
+    const int64_t * const indexStrides = strides + this->GetFirstIndexTorchDimension();
+    DeepScalarType *deepScalarPointer = m_Tensor.data_ptr< DeepScalarType >();
+    for( unsigned int i = 0; i < Self::ImageDimension; ++i )
+      {
+      deepScalarPointer += ( index[Self::ImageDimension-1-i] - bufferedIndex[Self::ImageDimension-1-i] ) * indexStrides[i];
+      }
+    return TorchImagePixelHelper { deepScalarPointer, strides + this->GetFirstComponentTorchDimension() };
+    }
+
   std::vector< at::indexing::TensorIndex > TorchIndex;
   for( unsigned int i = 0; i < Self::ImageDimension; ++i )
     {
-    TorchIndex.push_back( static_cast< int64_t >( index[Self::ImageDimension-1-i] ) );
+    TorchIndex.push_back( static_cast< int64_t >( index[Self::ImageDimension-1-i] - bufferedIndex[Self::ImageDimension-1-i] ) );
     }
-  return TorchImagePixelHelper { m_Tensor, TorchIndex };
+  // TorchPixelHelper appends the component indices after the index.
+  // It records its accesses with the TorchInstrumentation.
+  return TorchImagePixelHelper { Self::PermuteComponentLayout( m_Tensor, m_ComponentLayout, itkComponentsLast ), TorchIndex,
+    &m_InstrumentationCounters, this };
 }
 
 /** The pointer might be to GPU memory and, if so, cannot be directly
@@ -254,6 +568,7 @@ TPixel *
 TorchImage< TPixel, VImageDimension >
 ::GetBufferPointer()
 {
+  this->MakeTensorWritable();
   return reinterpret_cast< TPixel * >( m_Tensor.data_ptr< DeepScalarType >() );
 }
 
@@ -267,19 +582,254 @@ TorchImage< TPixel, VImageDimension >
   return reinterpret_cast< const TPixel * >( m_Tensor.data_ptr< DeepScalarType >() );
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+typename TorchImage< TPixel, VImageDimension >::Pointer
+TorchImage< TPixel, VImageDimension >
+::FromImage( ITKImageType *image )
+{
+  static_assert( sizeof( TPixel ) == TorchImagePixelHelper::SizeOf * sizeof( DeepScalarType ),
+    "The pixel type must consist of its deep scalars only" );
+
+  using PixelContainerPointer = typename ITKImageType::PixelContainerPointer;
+  const PixelContainerPointer pixelContainer = image->GetPixelContainer();
+  if( image->GetBufferPointer() == nullptr )
+    {
+    itkGenericExceptionMacro( << "TorchImage::FromImage() requires an allocated image" );
+    }
+
+  Pointer torchImage = Self::New();
+  torchImage->CopyInformation( image );
+  torchImage->SetBufferedRegion( image->GetBufferedRegion() );
+  torchImage->SetRequestedRegion( image->GetRequestedRegion() );
+  torchImage->m_DeviceType = itkCPU;
+  torchImage->m_CudaDeviceNumber = 0;
+
+  // The deleter keeps the pixel container alive for as long as the
+  // tensor's storage exists.
+  const auto deleter = [pixelContainer]( void * ) {};
+  torchImage->m_Tensor = torch::from_blob( image->GetBufferPointer(), torchImage->ComputeTorchSize(), deleter,
+    torch::dtype( Self::TorchValueType ).device( torch::kCPU ) );
+  torchImage->m_Allocated = true;
+  return torchImage;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+typename TorchImage< TPixel, VImageDimension >::ITKImagePointer
+TorchImage< TPixel, VImageDimension >
+::ToImage() const
+{
+  static_assert( sizeof( TPixel ) == TorchImagePixelHelper::SizeOf * sizeof( DeepScalarType ),
+    "The pixel type must consist of its deep scalars only" );
+
+  if( !m_Allocated )
+    {
+    itkExceptionMacro( << "ToImage() requires an allocated TorchImage" );
+    }
+  if( !m_Tensor.is_cpu() )
+    {
+    itkExceptionMacro( << "ToImage() requires a TorchImage whose tensor resides in CPU memory;"
+      << " call SetDevice( itkCPU ) first" );
+    }
+
+  using PixelContainerType = typename ITKImageType::PixelContainer;
+  using TorchPixelContainerType =
+    TorchImportImageContainer< typename PixelContainerType::ElementIdentifier, typename PixelContainerType::Element >;
+  typename TorchPixelContainerType::Pointer pixelContainer = TorchPixelContainerType::New();
+  // The itk::Image may be written, so when it would alias pixels that
+  // are still shared with a clone, this image copies them first.
+  if( this->IsTensorShared()
+    && Self::PermuteComponentLayout( m_Tensor, m_ComponentLayout, itkComponentsLast ).is_contiguous() )
+    {
+    const_cast< Self * >( this )->MakeTensorWritable();
+    }
+  TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkCopy, &m_InstrumentationCounters, this );
+  torch::Tensor tensor = Self::PermuteComponentLayout( m_Tensor, m_ComponentLayout, itkComponentsLast ).contiguous();
+  if( m_ReadOnly && tensor.data_ptr() == m_Tensor.data_ptr() )
+    {
+    // Writes to pages mapped read-only crash the process.
+    tensor = tensor.clone();
+    }
+  if( tensor.data_ptr() != m_Tensor.data_ptr() )
+    {
+    probe.Stop( tensor.nbytes() );
+    }
+  pixelContainer->SetTensor( tensor, this->GetBufferedRegion().GetNumberOfPixels() );
+
+  ITKImagePointer image = ITKImageType::New();
+  image->CopyInformation( this );
+  image->SetBufferedRegion( this->GetBufferedRegion() );
+  image->SetRequestedRegion( this->GetRequestedRegion() );
+  image->SetPixelContainer( pixelContainer );
+  return image;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+DLManagedTensor *
+TorchImage< TPixel, VImageDimension >
+::ToDLPack()
+{
+  if( !m_Allocated )
+    {
+    itkExceptionMacro( << "ToDLPack() requires an allocated TorchImage" );
+    }
+  this->MakeTensorWritable();
+  try
+    {
+    return at::toDLPack( m_Tensor );
+    }
+  catch( const c10::Error & error )
+    {
+    itkExceptionMacro( << "ToDLPack() cannot export a tensor of type " << m_Tensor.scalar_type() << ": "
+      << error.what_without_backtrace() );
+    }
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+typename TorchImage< TPixel, VImageDimension >::Pointer
+TorchImage< TPixel, VImageDimension >
+::FromDLPack( DLManagedTensor * dlManagedTensor, const ImageBase< VImageDimension > * geometry,
+  ComponentLayoutType componentLayout )
+{
+  if( dlManagedTensor == nullptr )
+    {
+    itkGenericExceptionMacro( << "TorchImage::FromDLPack() requires a DLPack tensor" );
+    }
+  // From here on the tensor owns dlManagedTensor.
+  torch::Tensor tensor;
+  try
+    {
+    tensor = at::fromDLPack( dlManagedTensor );
+    }
+  catch( const c10::Error & error )
+    {
+    if( dlManagedTensor->deleter != nullptr )
+      {
+      dlManagedTensor->deleter( dlManagedTensor );
+      }
+    itkGenericExceptionMacro( << "TorchImage::FromDLPack() cannot import the DLPack tensor: "
+      << error.what_without_backtrace() );
+    }
+  if( tensor.scalar_type() != Self::TorchValueType )
+    {
+    itkGenericExceptionMacro( << "TorchImage::FromDLPack() expects a tensor of type " << Self::TorchValueType
+      << " but got " << tensor.scalar_type() );
+    }
+  if( tensor.dim() != static_cast< int64_t >( Self::TorchDimension ) )
+    {
+    itkGenericExceptionMacro( << "TorchImage::FromDLPack() expects a tensor of " << Self::TorchDimension
+      << " dimensions but got " << tensor.sizes() );
+    }
+
+  Pointer image = Self::New();
+  image->SetComponentLayout( componentLayout );
+  if( geometry != nullptr )
+    {
+    const RegionType & region = geometry->GetBufferedRegion().GetNumberOfPixels() > 0
+      ? geometry->GetBufferedRegion() : geometry->GetLargestPossibleRegion();
+    image->CopyInformation( geometry );
+    image->SetBufferedRegion( region );
+    image->SetRequestedRegion( region );
+    }
+  else
+    {
+    // The index dimensions are in reverse order in the tensor.
+    SizeType size;
+    for( unsigned int i = 0; i < Self::ImageDimension; ++i )
+      {
+      size[i] = static_cast< SizeValueType >(
+        tensor.size( image->GetFirstIndexTorchDimension() + Self::ImageDimension - 1 - i ) );
+      }
+    image->SetRegions( size );
+    }
+  // SetTensor() checks the sizes and takes the device of the tensor.
+  image->SetTensor( tensor );
+  return image;
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 void
 TorchImage< TPixel, VImageDimension >
 ::Graft( const Self * data )
 {
   Superclass::Graft( data );
+  m_ComponentLayout = data->m_ComponentLayout;
   m_DeviceType = data->m_DeviceType;
   m_CudaDeviceNumber = data->m_CudaDeviceNumber;
+  // Sharing the tensor itself, whose reference count keeps the
+  // storage from being released or recycled while either image uses
+  // it, also shares any storage that MakeTensorWritable() gives it
+  // later.
+  const torch::Tensor tensor = data->m_Allocated ? data->m_Tensor : torch::Tensor();
   m_Allocated = data->m_Allocated;
-  if( m_Allocated )
+  this->ReleaseTensor();
+  m_Tensor = tensor;
+  m_CopyOnWrite = data->m_CopyOnWrite;
+  m_ReadOnly = data->m_ReadOnly;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImage< TPixel, VImageDimension >
+::GraftRegion( const Self * data, const RegionType & region )
+{
+  if( !data->m_Allocated )
+    {
+    itkExceptionMacro( << "GraftRegion() requires an allocated TorchImage" );
+    }
+  const RegionType &bufferedRegion = data->GetBufferedRegion();
+  if( !bufferedRegion.IsInside( region ) )
     {
-    m_Tensor = torch::from_blob( data->m_Tensor.data_ptr(), data->m_Tensor.sizes(), data->m_Tensor.options() );
+    itkExceptionMacro( << "Region " << region << " is outside of buffered region " << bufferedRegion );
     }
+
+  // A view must alias the pixels that data keeps, so data first stops
+  // sharing them with a clone.  That leaves its pixels as they are.
+  // The views of a read-only image are read-only too.
+  if( !data->m_ReadOnly || data->m_CopyOnWrite )
+    {
+    const_cast< Self * >( data )->MakeTensorWritable();
+    }
+  const torch::Tensor view = Self::NarrowToRegion( data->m_Tensor, data->m_ComponentLayout, bufferedRegion, region );
+
+  Superclass::Graft( data );
+  this->SetBufferedRegion( region );
+  this->SetRequestedRegion( region );
+  m_ComponentLayout = data->m_ComponentLayout;
+  m_DeviceType = data->m_DeviceType;
+  m_CudaDeviceNumber = data->m_CudaDeviceNumber;
+  m_Allocated = true;
+  this->ReleaseTensor();
+  m_Tensor = view;
+  m_ReadOnly = data->m_ReadOnly;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+torch::Tensor
+TorchImage< TPixel, VImageDimension >
+::NarrowToRegion( const torch::Tensor & tensor, ComponentLayoutType componentLayout, const RegionType & bufferedRegion,
+  const RegionType & region )
+{
+  // Narrow each index dimension of the tensor, which are in reverse
+  // order.  The pixel component dimensions are left untouched.
+  const int64_t firstIndexTorchDimension =
+    componentLayout == itkComponentsFirst ? tensor.dim() - Self::ImageDimension : 0;
+  torch::Tensor view = tensor;
+  for( unsigned int i = 0; i < Self::ImageDimension; ++i )
+    {
+    view = view.narrow( firstIndexTorchDimension + Self::ImageDimension-1-i,
+      region.GetIndex()[i] - bufferedRegion.GetIndex()[i], region.GetSize()[i] );
+    }
+  return view;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+typename TorchImage< TPixel, VImageDimension >::Pointer
+TorchImage< TPixel, VImageDimension >
+::CreateRegionView( const RegionType & region ) const
+{
+  Pointer regionView = Self::New();
+  regionView->GraftRegion( this, region );
+  return regionView;
 }
 
 template< typename TPixel, unsigned int VImageDimension >
@@ -305,6 +855,51 @@ TorchImage< TPixel, VImageDimension >
     }
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+LightObject::Pointer
+TorchImage< TPixel, VImageDimension >
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Pointer rval = dynamic_cast< Self * >( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+
+  rval->CopyInformation( this );
+  rval->SetBufferedRegion( this->GetBufferedRegion() );
+  rval->SetRequestedRegion( this->GetRequestedRegion() );
+  rval->m_DeviceType = m_DeviceType;
+  rval->m_CudaDeviceNumber = m_CudaDeviceNumber;
+  rval->m_DirectCPUAccess = m_DirectCPUAccess;
+  rval->m_ComponentLayout = m_ComponentLayout;
+  if( m_Allocated && !m_CopyOnWrite && m_Tensor.storage().use_count() > 1 )
+    {
+    // Region views, or other tensors over the same storage, would write
+    // to it without copying first, so the clone gets pixels of its own
+    // right away.
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkCopy, &rval->m_InstrumentationCounters, rval );
+    rval->m_Tensor = m_Tensor.clone( at::MemoryFormat::Contiguous );
+    rval->m_Allocated = true;
+    probe.Stop( rval->m_Tensor.nbytes() );
+    }
+  else if( m_Allocated )
+    {
+    // Otherwise only clones share the storage.  An alias is a tensor of
+    // its own that shares the storage, so that MakeTensorWritable() can
+    // tell the clones apart from the images grafted from them.
+    // A read-only image cannot be written, so it needs no copy of its
+    // own, but its clone copies the pixels on its first write.
+    rval->m_Tensor = m_Tensor.alias();
+    rval->m_Allocated = true;
+    rval->m_CopyOnWrite = true;
+    rval->m_ReadOnly = m_ReadOnly;
+    m_CopyOnWrite = !m_ReadOnly || m_CopyOnWrite;
+    }
+  return loPtr;
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 TorchImage< TPixel, VImageDimension >
 ::TorchImage()
@@ -312,11 +907,23 @@ TorchImage< TPixel, VImageDimension >
   m_DeviceType = itkCPU;
   m_CudaDeviceNumber = 0;
   m_Allocated = false;
+  m_DirectCPUAccess = true;
+  m_ComponentLayout = itkComponentsLast;
+  m_Poolable = false;
+  m_CopyOnWrite = false;
+  m_ReadOnly = false;
   m_Tensor = torch::Tensor();
   // SetDevice checks whether GPU exists
   this->SetDevice(itkCUDA, 0);
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+TorchImage< TPixel, VImageDimension >
+::~TorchImage()
+{
+  this->ReleaseTensor();
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 void
 TorchImage< TPixel, VImageDimension >
@@ -327,8 +934,15 @@ TorchImage< TPixel, VImageDimension >
     << indent << "m_DeviceType: " << m_DeviceType << std::endl
     << indent << "m_Allocated: " << m_Allocated << std::endl
     << indent << "m_CudaDeviceNumber: " << m_CudaDeviceNumber << std::endl
+    << indent << "m_DirectCPUAccess: " << m_DirectCPUAccess << std::endl
+    << indent << "m_ComponentLayout: " << m_ComponentLayout << std::endl
+    << indent << "m_Poolable: " << m_Poolable << std::endl
+    << indent << "m_CopyOnWrite: " << m_CopyOnWrite << std::endl
+    << indent << "m_ReadOnly: " << m_ReadOnly << std::endl
     // << indent << "m_Tensor: " << m_Tensor << std::endl
+    << indent << "m_InstrumentationCounters:" << std::endl
     ;
+  m_InstrumentationCounters.Print( os, indent.GetNextIndent() );
 }
 
 } // end namespace itk
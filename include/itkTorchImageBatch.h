@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageBatch_h
+#define itkTorchImageBatch_h
+
+#include "itkObject.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchImageBatch
+ *  \brief A batch of equally sized TorchImages stored in one tensor.
+ *
+ * TorchImageBatch owns a single contiguous tensor whose first
+ * dimension indexes the images of the batch and whose remaining
+ * dimensions are those of one TorchImage, as given by
+ * TorchImage::ComputeTorchSize().  For example, a batch of N images
+ * of type TorchImage< Vector< float, C >, 3 > has a tensor of sizes
+ * [N, D, H, W, C] with the default itkComponentsLast layout, and
+ * [N, C, D, H, W], as most models expect, with SetComponentLayout(
+ * itkComponentsFirst ).
+ *
+ * Each image of the batch is available as a TorchImage, via
+ * GetImage(), whose tensor is a view of one slice of the batch
+ * tensor.  Every such image has its own origin, spacing and
+ * direction.
+ *
+ * A batch is either allocated with Allocate(), or built from
+ * existing TorchImages with AppendImage() or Stack().  Each appended
+ * image is copied once, as it is appended, straight into its slice of
+ * the batch tensor on the device of the batch; its geometry is copied
+ * too.  The batch tensor keeps room for more images, like a
+ * std::vector, and grows its storage in place when that room runs
+ * out, so the images and tensors handed out before keep aliasing the
+ * batch.  Growing moves the pixels, though, which invalidates raw
+ * pointers to them, such as those of GetBufferPointer(), ToImage() and
+ * ToDLPack(); Reserve() room for all images up front to avoid it.
+ *
+ * \sa TorchImage
+ *
+ * \ingroup PyTorch
+ */
+template< typename TPixel, unsigned int VImageDimension = 2 >
+class ITK_TEMPLATE_EXPORT TorchImageBatch : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchImageBatch );
+
+  /** Standard class type aliases */
+  using Self = TorchImageBatch;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchImageBatch, Object );
+
+  static constexpr unsigned int ImageDimension = VImageDimension;
+
+  using ImageType = TorchImage< TPixel, VImageDimension >;
+  using ImagePointer = typename ImageType::Pointer;
+  using ImageConstPointer = typename ImageType::ConstPointer;
+  using PixelType = typename ImageType::PixelType;
+  using RegionType = typename ImageType::RegionType;
+  using SizeValueType = typename ImageType::SizeValueType;
+  using DeviceType = typename ImageType::DeviceType;
+  using TensorInitializer = typename ImageType::TensorInitializer;
+  using ComponentLayoutType = typename ImageType::ComponentLayoutType;
+
+  /** The region of each image of an allocated batch.  Images added
+   * with AppendImage() keep their own regions, which must all have
+   * the same size. */
+  itkSetMacro( Region, RegionType );
+  itkGetConstReferenceMacro( Region, RegionType );
+
+  /** The component layout of the batch tensor and of its images.
+   * Set it before Allocate(), AppendImage() or Stack(); appended images
+   * of the other layout are permuted as they are copied. */
+  itkSetMacro( ComponentLayout, ComponentLayoutType );
+  itkGetConstMacro( ComponentLayout, ComponentLayoutType );
+
+  /** Select the device for Allocate().  Returns false if the requested
+   * CUDA device does not exist. */
+  bool SetDevice( DeviceType deviceType, uint64_t cudaDeviceNumber = 0 );
+
+  /** Allocate a batch of numberOfImages images, each with the region
+   * set by SetRegion() and default geometry.  Any previous images of
+   * the batch are released. */
+  void Allocate( SizeValueType numberOfImages, TensorInitializer tensorInitializer = ImageType::itkEmpty );
+
+  /** Make room in the batch tensor for numberOfImages images, so that
+   * appending up to that many does not grow its storage.  Before the
+   * first image the room is made when it is appended. */
+  void Reserve( SizeValueType numberOfImages );
+
+  /** Number of images the batch tensor has room for. */
+  SizeValueType GetCapacity() const
+    {
+    return m_Tensor.defined() ? static_cast< SizeValueType >( m_Tensor.size( 0 ) ) : m_ReservedNumberOfImages;
+    }
+
+  /** Copy an image into the batch.  The first image sets the size of
+   * the images and the device of a batch that was not allocated; later
+   * images must have the same size and are copied to that device. */
+  void AppendImage( const ImageType *image );
+
+  /** Replace the batch with copies of the given images, with a single
+   * copy per image. */
+  void Stack( const std::vector< ImageConstPointer > & images );
+
+  /** Number of images in the batch. */
+  SizeValueType GetNumberOfImages() const
+    {
+    return static_cast< SizeValueType >( m_Images.size() );
+    }
+
+  /** Get one image of the batch.  Its tensor is a view of the batch
+   * tensor, so writes to the image are writes to the batch. */
+  ImageType *GetImage( SizeValueType imageNumber );
+
+  /** Get the batch tensor, with the image number as the first
+   * dimension.  It is a view of the images of the batch, without the
+   * room for more. */
+  torch::Tensor GetTensor() const;
+
+  /** Release the batch tensor and all images. */
+  void Initialize();
+
+protected:
+  TorchImageBatch();
+  ~TorchImageBatch() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** Grow the storage of the batch tensor in place to room for
+   * capacity images. */
+  void Grow( SizeValueType capacity );
+
+private:
+  RegionType m_Region;
+  ComponentLayoutType m_ComponentLayout;
+  DeviceType m_DeviceType;
+  uint64_t m_CudaDeviceNumber;
+
+  /** The images of the batch followed by the room for more */
+  torch::Tensor m_Tensor;
+  std::vector< ImagePointer > m_Images;
+  SizeValueType m_ReservedNumberOfImages;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchImageBatch.hxx"
+#endif
+
+#endif
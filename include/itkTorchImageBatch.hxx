@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageBatch_hxx
+#define itkTorchImageBatch_hxx
+
+#include "itkTorchImageBatch.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TPixel, unsigned int VImageDimension >
+TorchImageBatch< TPixel, VImageDimension >
+::TorchImageBatch()
+{
+  m_ComponentLayout = ImageType::itkComponentsLast;
+  m_DeviceType = ImageType::itkCPU;
+  m_CudaDeviceNumber = 0;
+  m_Tensor = torch::Tensor();
+  m_ReservedNumberOfImages = 0;
+  // SetDevice checks whether GPU exists
+  this->SetDevice( ImageType::itkCUDA, 0 );
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+bool
+TorchImageBatch< TPixel, VImageDimension >
+::SetDevice( DeviceType deviceType, uint64_t cudaDeviceNumber )
+{
+  switch( deviceType )
+    {
+    case ImageType::itkCUDA:
+      if ( !( torch::cuda::is_available() && cudaDeviceNumber < torch::cuda::device_count() ) )
+        {
+        return false;
+        }
+      break;
+    case ImageType::itkCPU:
+      if( cudaDeviceNumber != 0 )
+        {
+        return false;     // cudaDeviceNumber not supported for itkCPU.
+        }
+      break;
+    }
+
+  if( m_DeviceType != deviceType || m_CudaDeviceNumber != cudaDeviceNumber )
+    {
+    m_DeviceType = deviceType;
+    m_CudaDeviceNumber = cudaDeviceNumber;
+    this->Modified();
+    }
+  return true;
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::Allocate( SizeValueType numberOfImages, TensorInitializer tensorInitializer )
+{
+  this->Initialize();
+
+  // The batch dimension comes first, followed by the dimensions of
+  // one image.
+  ImagePointer image = ImageType::New();
+  image->SetComponentLayout( m_ComponentLayout );
+  image->SetRegions( m_Region );
+  std::vector< int64_t > batchSize = image->ComputeTorchSize();
+  batchSize.insert( batchSize.begin(), static_cast< int64_t >( numberOfImages ) );
+
+  c10::TensorOptions tensorOptions = torch::dtype( ImageType::TorchValueType ).layout( torch::kStrided ).requires_grad( false );
+  switch( m_DeviceType )
+    {
+    case ImageType::itkCUDA:
+      tensorOptions = tensorOptions.device( torch::kCUDA, m_CudaDeviceNumber );
+      break;
+    case ImageType::itkCPU:
+      tensorOptions = tensorOptions.device( torch::kCPU );
+      break;
+    }
+
+  switch( tensorInitializer )
+    {
+    case ImageType::itkEmpty:
+      m_Tensor = torch::empty( batchSize, tensorOptions );
+      break;
+    case ImageType::itkZeros:
+      m_Tensor = torch::zeros( batchSize, tensorOptions );
+      break;
+    case ImageType::itkOnes:
+      m_Tensor = torch::ones( batchSize, tensorOptions );
+      break;
+    case ImageType::itkRand:
+      m_Tensor = torch::rand( batchSize, tensorOptions );
+      break;
+    case ImageType::itkRandn:
+      m_Tensor = torch::randn( batchSize, tensorOptions );
+      break;
+    }
+
+  for( SizeValueType i = 0; i < numberOfImages; ++i )
+    {
+    if( i > 0 )
+      {
+      image = ImageType::New();
+      image->SetComponentLayout( m_ComponentLayout );
+      image->SetRegions( m_Region );
+      }
+    image->SetTensor( m_Tensor.select( 0, static_cast< int64_t >( i ) ) );
+    m_Images.push_back( image );
+    }
+  this->Modified();
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::Reserve( SizeValueType numberOfImages )
+{
+  if( !m_Tensor.defined() )
+    {
+    m_ReservedNumberOfImages = std::max( m_ReservedNumberOfImages, numberOfImages );
+    }
+  else if( numberOfImages > this->GetCapacity() )
+    {
+    this->Grow( numberOfImages );
+    }
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::Grow( SizeValueType capacity )
+{
+  // Resizing the storage, rather than stacking into a new tensor,
+  // keeps the StorageImpl that the images and the tensors handed out
+  // share, and the rows of the images where they were.
+  std::vector< int64_t > sizes = m_Tensor.sizes().vec();
+  sizes[0] = static_cast< int64_t >( capacity );
+  m_Tensor.resize_( sizes );
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::AppendImage( const ImageType *image )
+{
+  if( image == nullptr || !image->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "AppendImage() requires an allocated TorchImage" );
+    }
+  const torch::Tensor tensor =
+    ImageType::PermuteComponentLayout( image->GetTensor(), image->GetComponentLayout(), m_ComponentLayout );
+
+  if( !m_Tensor.defined() )
+    {
+    // The first image sets the sizes and the device of the batch.
+    std::vector< int64_t > batchSize = tensor.sizes().vec();
+    batchSize.insert( batchSize.begin(), static_cast< int64_t >( std::max< SizeValueType >( m_ReservedNumberOfImages, 1 ) ) );
+    m_Tensor = torch::empty( batchSize, tensor.options().requires_grad( false ) );
+    m_ReservedNumberOfImages = 0;
+    m_Region = image->GetBufferedRegion();
+    m_DeviceType = m_Tensor.is_cuda() ? ImageType::itkCUDA : ImageType::itkCPU;
+    m_CudaDeviceNumber = m_Tensor.is_cuda() ? m_Tensor.device().index() : 0;
+    }
+  else if( tensor.sizes() != m_Tensor.sizes().slice( 1 ) )
+    {
+    itkExceptionMacro( << "All images of a batch must have the same size; expected a tensor of sizes "
+      << m_Tensor.sizes().slice( 1 ) << " but got " << tensor.sizes() );
+    }
+  else if( m_Images.size() == this->GetCapacity() )
+    {
+    this->Grow( std::max< SizeValueType >( 2 * m_Images.size(), 1 ) );
+    }
+
+  // A copy to a CUDA batch need not wait for the device: later work on
+  // the batch is queued after it on the same stream, and a copy from
+  // pageable CPU memory has read the source before copy_() returns.
+  const int64_t imageNumber = static_cast< int64_t >( m_Images.size() );
+  const torch::Tensor slice = m_Tensor.select( 0, imageNumber );
+  slice.copy_( tensor, m_Tensor.is_cuda() );
+
+  ImagePointer batchImage = ImageType::New();
+  batchImage->SetComponentLayout( m_ComponentLayout );
+  batchImage->CopyInformation( image );
+  batchImage->SetBufferedRegion( image->GetBufferedRegion() );
+  batchImage->SetRequestedRegion( image->GetRequestedRegion() );
+  batchImage->SetTensor( slice );
+  m_Images.push_back( batchImage );
+  this->Modified();
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::Stack( const std::vector< ImageConstPointer > & images )
+{
+  this->Initialize();
+  this->Reserve( static_cast< SizeValueType >( images.size() ) );
+  for( const ImageConstPointer & image : images )
+    {
+    this->AppendImage( image );
+    }
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+typename TorchImageBatch< TPixel, VImageDimension >::ImageType *
+TorchImageBatch< TPixel, VImageDimension >
+::GetImage( SizeValueType imageNumber )
+{
+  if( imageNumber >= m_Images.size() )
+    {
+    itkExceptionMacro( << "Image number " << imageNumber << " is out of range for a batch of " << m_Images.size()
+      << " images" );
+    }
+  return m_Images[imageNumber];
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+torch::Tensor
+TorchImageBatch< TPixel, VImageDimension >
+::GetTensor() const
+{
+  if( !m_Tensor.defined() )
+    {
+    return m_Tensor;
+    }
+  return m_Tensor.narrow( 0, 0, static_cast< int64_t >( m_Images.size() ) );
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::Initialize()
+{
+  m_Tensor = torch::Tensor();
+  m_Images.clear();
+  m_ReservedNumberOfImages = 0;
+  this->Modified();
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+TorchImageBatch< TPixel, VImageDimension >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+  os
+    << indent << "m_Region: " << m_Region << std::endl
+    << indent << "m_ComponentLayout: " << m_ComponentLayout << std::endl
+    << indent << "m_DeviceType: " << m_DeviceType << std::endl
+    << indent << "m_CudaDeviceNumber: " << m_CudaDeviceNumber << std::endl
+    << indent << "Number of images: " << m_Images.size() << std::endl
+    << indent << "Capacity: " << this->GetCapacity() << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageFileReader_h
+#define itkTorchImageFileReader_h
+
+#include "itkImageSource.h"
+#include "itkImageIOBase.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchImageFileReader
+ *  \brief Read a file, through an ImageIO, directly into a TorchImage.
+ *
+ * TorchImageFileReader reads an image file into the torch::Tensor of
+ * its output TorchImage without an intermediate itk::Image.  When the
+ * file's component type is the deep scalar type of the TorchImage and
+ * the output tensor is a contiguous CPU tensor with the
+ * itkComponentsLast layout, the ImageIO reads straight into the
+ * tensor's storage.  Otherwise each slab is read into a temporary CPU
+ * tensor and copied into the output tensor, which converts the
+ * component type, places the pixel components as set by the output's
+ * component layout and, for CUDA outputs, uploads the slab.
+ *
+ * Set the device and component layout of the output with
+ * GetOutput()->SetDevice() and GetOutput()->SetComponentLayout()
+ * before updating the reader.
+ *
+ * If UseStreaming is on and the ImageIO can stream, only the
+ * requested region is read, in slabs of NumberOfSlicesPerSlab slices
+ * along the slowest varying dimension, which bounds the size of
+ * temporary buffers.  Otherwise the whole image is read.
+ *
+ * The number of components of the file must equal that of the pixel
+ * type.  Unsigned 16 and 32 bit components are converted without loss
+ * through wider signed types; unsigned 64 bit components are read as
+ * signed 64 bit integers because torch has no unsigned 64 bit dtype.
+ *
+ * \sa TorchImageFileWriter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TOutputImage >
+class ITK_TEMPLATE_EXPORT TorchImageFileReader : public ImageSource< TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchImageFileReader );
+
+  /** Standard class type aliases */
+  using Self = TorchImageFileReader;
+  using Superclass = ImageSource< TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchImageFileReader, ImageSource );
+
+  using OutputImageType = TOutputImage;
+  using OutputImagePointer = typename OutputImageType::Pointer;
+  using RegionType = typename OutputImageType::RegionType;
+  using SizeType = typename OutputImageType::SizeType;
+  using IndexType = typename OutputImageType::IndexType;
+  using DeepScalarType = typename OutputImageType::DeepScalarType;
+
+  static constexpr unsigned int ImageDimension = OutputImageType::ImageDimension;
+
+  /** The file to read. */
+  itkSetStringMacro( FileName );
+  itkGetStringMacro( FileName );
+
+  /** The ImageIO to read with.  If none is set, one is created by the
+   * ImageIOFactory for the file name each time the reader updates. */
+  void SetImageIO( ImageIOBase *imageIO );
+  itkGetModifiableObjectMacro( ImageIO, ImageIOBase );
+
+  /** Whether to read only the requested region, in slabs, if the
+   * ImageIO supports it.  Off by default. */
+  itkSetMacro( UseStreaming, bool );
+  itkGetConstMacro( UseStreaming, bool );
+  itkBooleanMacro( UseStreaming );
+
+  /** Number of slices along the slowest varying dimension read at a
+   * time when streaming.  Defaults to 16. */
+  itkSetClampMacro( NumberOfSlicesPerSlab, SizeValueType, 1, NumericTraits< SizeValueType >::max() );
+  itkGetConstMacro( NumberOfSlicesPerSlab, SizeValueType );
+
+  /** The torch dtype in which the ImageIO delivers components of a
+   * given type. */
+  static torch::ScalarType IOComponentScalarType( IOComponentEnum componentType, SizeValueType componentSize );
+
+protected:
+  TorchImageFileReader();
+  ~TorchImageFileReader() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** Read the image information and set the output's geometry and
+   * largest possible region. */
+  void GenerateOutputInformation() override;
+
+  /** Read the whole image unless streaming. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  void GenerateData() override;
+
+  /** Whether components read by the ImageIO, as returned by
+   * IOComponentScalarType(), must be converted to the values they
+   * represent. */
+  static bool IOComponentsNeedConversion( IOComponentEnum componentType, SizeValueType componentSize );
+
+  /** Convert components read by the ImageIO, as returned by
+   * IOComponentScalarType(), to the values they represent. */
+  static torch::Tensor ConvertIOComponents( const torch::Tensor & buffer, IOComponentEnum componentType );
+
+private:
+  std::string m_FileName;
+  ImageIOBase::Pointer m_ImageIO;
+  bool m_UserSpecifiedImageIO;
+  bool m_UseStreaming;
+  SizeValueType m_NumberOfSlicesPerSlab;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchImageFileReader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,305 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageFileReader_hxx
+#define itkTorchImageFileReader_hxx
+
+#include "itkTorchImageFileReader.h"
+#include "itkImageIOFactory.h"
+
+namespace itk
+{
+
+template< typename TOutputImage >
+TorchImageFileReader< TOutputImage >
+::TorchImageFileReader()
+{
+  m_UserSpecifiedImageIO = false;
+  m_UseStreaming = false;
+  m_NumberOfSlicesPerSlab = 16;
+}
+
+template< typename TOutputImage >
+void
+TorchImageFileReader< TOutputImage >
+::SetImageIO( ImageIOBase *imageIO )
+{
+  if( m_ImageIO != imageIO )
+    {
+    m_ImageIO = imageIO;
+    this->Modified();
+    }
+  m_UserSpecifiedImageIO = ( imageIO != nullptr );
+}
+
+template< typename TOutputImage >
+torch::ScalarType
+TorchImageFileReader< TOutputImage >
+::IOComponentScalarType( IOComponentEnum componentType, SizeValueType componentSize )
+{
+  switch( componentType )
+    {
+    case IOComponentEnum::FLOAT:
+      return torch::kFloat;
+    case IOComponentEnum::DOUBLE:
+      return torch::kDouble;
+    case IOComponentEnum::UCHAR:
+      return torch::kByte;
+    case IOComponentEnum::CHAR:
+    case IOComponentEnum::SHORT:
+    case IOComponentEnum::INT:
+    case IOComponentEnum::LONG:
+    case IOComponentEnum::LONGLONG:
+    case IOComponentEnum::USHORT:
+    case IOComponentEnum::UINT:
+    case IOComponentEnum::ULONG:
+    case IOComponentEnum::ULONGLONG:
+      // Unsigned components are read into a signed dtype of the same
+      // size and widened by ConvertIOComponents().
+      switch( componentSize )
+        {
+        case 1:
+          return torch::kChar;
+        case 2:
+          return torch::kShort;
+        case 4:
+          return torch::kInt;
+        case 8:
+          return torch::kLong;
+        default:
+          break;
+        }
+      break;
+    default:
+      break;
+    }
+  itkGenericExceptionMacro( << "Unsupported component type " << ImageIOBase::GetComponentTypeAsString( componentType )
+    << " of size " << componentSize );
+}
+
+template< typename TOutputImage >
+bool
+TorchImageFileReader< TOutputImage >
+::IOComponentsNeedConversion( IOComponentEnum componentType, SizeValueType componentSize )
+{
+  switch( componentType )
+    {
+    case IOComponentEnum::USHORT:
+    case IOComponentEnum::UINT:
+    case IOComponentEnum::ULONG:
+    case IOComponentEnum::ULONGLONG:
+      return componentSize == 2 || componentSize == 4;
+    default:
+      return false;
+    }
+}
+
+template< typename TOutputImage >
+torch::Tensor
+TorchImageFileReader< TOutputImage >
+::ConvertIOComponents( const torch::Tensor & buffer, IOComponentEnum componentType )
+{
+  if( !Self::IOComponentsNeedConversion( componentType, buffer.element_size() ) )
+    {
+    return buffer;
+    }
+  if( buffer.element_size() == 2 )
+    {
+    return buffer.to( torch::kInt ).bitwise_and( 0xFFFF );
+    }
+  return buffer.to( torch::kLong ).bitwise_and( static_cast< int64_t >( 0xFFFFFFFF ) );
+}
+
+template< typename TOutputImage >
+void
+TorchImageFileReader< TOutputImage >
+::GenerateOutputInformation()
+{
+  OutputImageType *output = this->GetOutput();
+
+  if( m_FileName.empty() )
+    {
+    itkExceptionMacro( << "FileName must be specified" );
+    }
+  if( !m_UserSpecifiedImageIO )
+    {
+    m_ImageIO = ImageIOFactory::CreateImageIO( m_FileName.c_str(), IOFileModeEnum::ReadMode );
+    if( m_ImageIO.IsNull() )
+      {
+      itkExceptionMacro( << "Could not create an ImageIO for reading " << m_FileName );
+      }
+    }
+  m_ImageIO->SetFileName( m_FileName );
+  m_ImageIO->ReadImageInformation();
+
+  constexpr unsigned int numberOfComponents = OutputImageType::TorchImagePixelHelper::NumberOfComponents;
+  if( m_ImageIO->GetNumberOfComponents() != numberOfComponents )
+    {
+    itkExceptionMacro( << m_FileName << " has " << m_ImageIO->GetNumberOfComponents()
+      << " components per pixel but the output pixel type has " << numberOfComponents );
+    }
+  Self::IOComponentScalarType( m_ImageIO->GetComponentType(), m_ImageIO->GetComponentSize() );
+
+  // Like ImageFileReader, extra dimensions of the file must have size
+  // one, and missing dimensions get size one.
+  const unsigned int ioDimension = m_ImageIO->GetNumberOfDimensions();
+  for( unsigned int i = ImageDimension; i < ioDimension; ++i )
+    {
+    if( m_ImageIO->GetDimensions( i ) != 1 )
+      {
+      itkExceptionMacro( << m_FileName << " has " << ioDimension << " dimensions, which cannot be read into an image of "
+        << ImageDimension << " dimensions" );
+      }
+    }
+
+  SizeType size;
+  typename OutputImageType::SpacingType spacing;
+  typename OutputImageType::PointType origin;
+  typename OutputImageType::DirectionType direction;
+  direction.SetIdentity();
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if( i < ioDimension )
+      {
+      size[i] = m_ImageIO->GetDimensions( i );
+      spacing[i] = m_ImageIO->GetSpacing( i );
+      origin[i] = m_ImageIO->GetOrigin( i );
+      const std::vector< double > axis = m_ImageIO->GetDirection( i );
+      for( unsigned int j = 0; j < ImageDimension && j < axis.size(); ++j )
+        {
+        direction[j][i] = axis[j];
+        }
+      }
+    else
+      {
+      size[i] = 1;
+      spacing[i] = 1.0;
+      origin[i] = 0.0;
+      }
+    }
+
+  output->SetSpacing( spacing );
+  output->SetOrigin( origin );
+  output->SetDirection( direction );
+  output->SetLargestPossibleRegion( RegionType( size ) );
+}
+
+template< typename TOutputImage >
+void
+TorchImageFileReader< TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  if( !( m_UseStreaming && m_ImageIO->CanStreamRead() ) )
+    {
+    output->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TOutputImage >
+void
+TorchImageFileReader< TOutputImage >
+::GenerateData()
+{
+  OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+  output->SetBufferedRegion( region );
+  output->Allocate();
+
+  // ImageIO delivers the pixel components last, so the tensor is
+  // filled through a view in that layout.  The slowest varying index
+  // dimension is then the first tensor dimension.
+  const torch::Tensor target =
+    OutputImageType::PermuteComponentLayout( output->GetTensor(), output->GetComponentLayout(), OutputImageType::itkComponentsLast );
+  const IOComponentEnum componentType = m_ImageIO->GetComponentType();
+  const torch::ScalarType ioScalarType = Self::IOComponentScalarType( componentType, m_ImageIO->GetComponentSize() );
+  const bool readDirectly = target.is_cpu() && target.is_contiguous() && ioScalarType == OutputImageType::TorchValueType
+    && !Self::IOComponentsNeedConversion( componentType, m_ImageIO->GetComponentSize() );
+
+  const bool streaming = m_UseStreaming && m_ImageIO->CanStreamRead();
+  m_ImageIO->SetUseStreamedReading( streaming );
+
+  constexpr unsigned int slabDimension = ImageDimension - 1;
+  const SizeValueType numberOfSlices = region.GetSize( slabDimension );
+  const SizeValueType slicesPerSlab = streaming ? m_NumberOfSlicesPerSlab : numberOfSlices;
+  const unsigned int ioDimension = m_ImageIO->GetNumberOfDimensions();
+  for( SizeValueType firstSlice = 0; firstSlice < numberOfSlices; firstSlice += slicesPerSlab )
+    {
+    const SizeValueType slabSlices = std::min( slicesPerSlab, numberOfSlices - firstSlice );
+    ImageIORegion ioRegion( ioDimension );
+    for( unsigned int i = 0; i < ioDimension; ++i )
+      {
+      if( i < ImageDimension )
+        {
+        ioRegion.SetIndex( i, region.GetIndex( i ) + ( i == slabDimension ? static_cast< IndexValueType >( firstSlice ) : 0 ) );
+        ioRegion.SetSize( i, i == slabDimension ? slabSlices : region.GetSize( i ) );
+        }
+      else
+        {
+        ioRegion.SetIndex( i, 0 );
+        ioRegion.SetSize( i, 1 );
+        }
+      }
+    // As for ImageFileReader, the ImageIO may only be able to read a
+    // larger region than the slab, which is then cropped.
+    const ImageIORegion streamableRegion = m_ImageIO->GenerateStreamableReadRegionFromRequestedRegion( ioRegion );
+    m_ImageIO->SetIORegion( streamableRegion );
+
+    torch::Tensor slab = target.narrow( 0, firstSlice, slabSlices );
+    if( readDirectly && streamableRegion == ioRegion )
+      {
+      m_ImageIO->Read( slab.data_ptr() );
+      }
+    else
+      {
+      std::vector< int64_t > bufferSizes;
+      for( unsigned int i = ioDimension; i > 0; --i )
+        {
+        bufferSizes.push_back( static_cast< int64_t >( streamableRegion.GetSize( i - 1 ) ) );
+        }
+      bufferSizes.insert( bufferSizes.end(), slab.sizes().begin() + ImageDimension, slab.sizes().end() );
+      const torch::Tensor buffer = torch::empty( bufferSizes, torch::dtype( ioScalarType ) );
+      m_ImageIO->Read( buffer.data_ptr() );
+      torch::Tensor cropped = buffer;
+      for( unsigned int i = 0; i < ioDimension; ++i )
+        {
+        cropped = cropped.narrow( ioDimension - 1 - i, ioRegion.GetIndex( i ) - streamableRegion.GetIndex( i ),
+          static_cast< int64_t >( ioRegion.GetSize( i ) ) );
+        }
+      slab.copy_( Self::ConvertIOComponents( cropped.reshape( slab.sizes() ), componentType ) );
+      }
+    this->UpdateProgress( static_cast< float >( firstSlice + slabSlices ) / numberOfSlices );
+    }
+}
+
+template< typename TOutputImage >
+void
+TorchImageFileReader< TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_FileName: " << m_FileName << std::endl
+    << indent << "m_UserSpecifiedImageIO: " << m_UserSpecifiedImageIO << std::endl
+    << indent << "m_UseStreaming: " << m_UseStreaming << std::endl
+    << indent << "m_NumberOfSlicesPerSlab: " << m_NumberOfSlicesPerSlab << std::endl
+    ;
+  itkPrintSelfObjectMacro( ImageIO );
+}
+
+} // end namespace itk
+
+#endif
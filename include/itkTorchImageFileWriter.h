@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageFileWriter_h
+#define itkTorchImageFileWriter_h
+
+#include "itkProcessObject.h"
+#include "itkImageIOBase.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchImageFileWriter
+ *  \brief Write a TorchImage, through an ImageIO, straight from its tensor.
+ *
+ * TorchImageFileWriter writes the buffered region of its input
+ * TorchImage without an intermediate itk::Image.  When the input
+ * tensor is a contiguous CPU tensor with the itkComponentsLast layout,
+ * the ImageIO writes straight from the tensor's storage.  Otherwise
+ * each slab is first copied into a temporary contiguous CPU tensor,
+ * which interleaves the pixel components and, for CUDA inputs,
+ * downloads the slab.  Boolean images are written as unsigned char.
+ *
+ * If UseStreaming is on and the ImageIO can stream, the image is
+ * written in slabs of NumberOfSlicesPerSlab slices along the slowest
+ * varying dimension, which bounds the size of temporary buffers.
+ * Otherwise it is written at once.
+ *
+ * The origin of the file is the physical location of the first index
+ * of the buffered region.
+ *
+ * \sa TorchImageFileReader
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage >
+class ITK_TEMPLATE_EXPORT TorchImageFileWriter : public ProcessObject
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchImageFileWriter );
+
+  /** Standard class type aliases */
+  using Self = TorchImageFileWriter;
+  using Superclass = ProcessObject;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchImageFileWriter, ProcessObject );
+
+  using InputImageType = TInputImage;
+  using RegionType = typename InputImageType::RegionType;
+  using PixelType = typename InputImageType::PixelType;
+  using DeepScalarType = typename InputImageType::DeepScalarType;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  /** Set/Get the image to write. */
+  void SetInput( const InputImageType *input );
+  const InputImageType * GetInput();
+
+  /** The file to write. */
+  itkSetStringMacro( FileName );
+  itkGetStringMacro( FileName );
+
+  /** The ImageIO to write with.  If none is set, one is created by the
+   * ImageIOFactory for the file name each time the writer writes. */
+  void SetImageIO( ImageIOBase *imageIO );
+  itkGetModifiableObjectMacro( ImageIO, ImageIOBase );
+
+  /** Whether the ImageIO compresses the pixel data.  Off by default. */
+  itkSetMacro( UseCompression, bool );
+  itkGetConstMacro( UseCompression, bool );
+  itkBooleanMacro( UseCompression );
+
+  /** Whether to write in slabs, if the ImageIO supports it.  Off by
+   * default. */
+  itkSetMacro( UseStreaming, bool );
+  itkGetConstMacro( UseStreaming, bool );
+  itkBooleanMacro( UseStreaming );
+
+  /** Number of slices along the slowest varying dimension written at a
+   * time when streaming.  Defaults to 16. */
+  itkSetClampMacro( NumberOfSlicesPerSlab, SizeValueType, 1, NumericTraits< SizeValueType >::max() );
+  itkGetConstMacro( NumberOfSlicesPerSlab, SizeValueType );
+
+  /** Bring the input up to date and write it. */
+  virtual void Write();
+
+  /** Aliased to Write(), as for ImageFileWriter. */
+  void Update() override
+    {
+    this->Write();
+    }
+
+protected:
+  TorchImageFileWriter();
+  ~TorchImageFileWriter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  void GenerateData() override;
+
+private:
+  std::string m_FileName;
+  ImageIOBase::Pointer m_ImageIO;
+  bool m_UserSpecifiedImageIO;
+  bool m_UseCompression;
+  bool m_UseStreaming;
+  SizeValueType m_NumberOfSlicesPerSlab;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchImageFileWriter.hxx"
+#endif
+
+#endif
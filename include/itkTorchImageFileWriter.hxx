@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageFileWriter_hxx
+#define itkTorchImageFileWriter_hxx
+
+#include "itkTorchImageFileWriter.h"
+#include "itkImageIOFactory.h"
+
+namespace itk
+{
+
+template< typename TInputImage >
+TorchImageFileWriter< TInputImage >
+::TorchImageFileWriter()
+{
+  m_UserSpecifiedImageIO = false;
+  m_UseCompression = false;
+  m_UseStreaming = false;
+  m_NumberOfSlicesPerSlab = 16;
+  this->SetNumberOfRequiredInputs( 1 );
+}
+
+template< typename TInputImage >
+void
+TorchImageFileWriter< TInputImage >
+::SetInput( const InputImageType *input )
+{
+  // ProcessObject is not const-correct, so the const_cast is required.
+  this->ProcessObject::SetNthInput( 0, const_cast< InputImageType * >( input ) );
+}
+
+template< typename TInputImage >
+const typename TorchImageFileWriter< TInputImage >::InputImageType *
+TorchImageFileWriter< TInputImage >
+::GetInput()
+{
+  return itkDynamicCastInDebugMode< const InputImageType * >( this->GetPrimaryInput() );
+}
+
+template< typename TInputImage >
+void
+TorchImageFileWriter< TInputImage >
+::SetImageIO( ImageIOBase *imageIO )
+{
+  if( m_ImageIO != imageIO )
+    {
+    m_ImageIO = imageIO;
+    this->Modified();
+    }
+  m_UserSpecifiedImageIO = ( imageIO != nullptr );
+}
+
+template< typename TInputImage >
+void
+TorchImageFileWriter< TInputImage >
+::Write()
+{
+  const InputImageType *input = this->GetInput();
+  if( input == nullptr )
+    {
+    itkExceptionMacro( << "No input to writer" );
+    }
+  if( m_FileName.empty() )
+    {
+    itkExceptionMacro( << "FileName must be specified" );
+    }
+  if( !m_UserSpecifiedImageIO )
+    {
+    m_ImageIO = ImageIOFactory::CreateImageIO( m_FileName.c_str(), IOFileModeEnum::WriteMode );
+    if( m_ImageIO.IsNull() )
+      {
+      itkExceptionMacro( << "Could not create an ImageIO for writing " << m_FileName );
+      }
+    }
+
+  // Bring the whole input up to date.
+  auto *nonConstInput = const_cast< InputImageType * >( input );
+  nonConstInput->UpdateOutputInformation();
+  nonConstInput->SetRequestedRegionToLargestPossibleRegion();
+  nonConstInput->Update();
+
+  this->InvokeEvent( StartEvent() );
+  this->UpdateProgress( 0.0f );
+  this->GenerateData();
+  this->UpdateProgress( 1.0f );
+  this->InvokeEvent( EndEvent() );
+
+  if( input->ShouldIReleaseData() )
+    {
+    nonConstInput->ReleaseData();
+    }
+}
+
+template< typename TInputImage >
+void
+TorchImageFileWriter< TInputImage >
+::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+  const RegionType region = input->GetBufferedRegion();
+
+  typename InputImageType::PointType origin;
+  input->TransformIndexToPhysicalPoint( region.GetIndex(), origin );
+  const typename InputImageType::DirectionType & direction = input->GetDirection();
+  m_ImageIO->SetNumberOfDimensions( ImageDimension );
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_ImageIO->SetDimensions( i, region.GetSize( i ) );
+    m_ImageIO->SetSpacing( i, input->GetSpacing()[i] );
+    m_ImageIO->SetOrigin( i, origin[i] );
+    std::vector< double > axis( ImageDimension );
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      axis[j] = direction[j][i];
+      }
+    m_ImageIO->SetDirection( i, axis );
+    }
+
+  // Torch booleans are one byte, which ImageIO writes as unsigned char.
+  constexpr bool isBoolean = std::is_same< DeepScalarType, bool >::value;
+  m_ImageIO->SetPixelTypeInfo( static_cast< const PixelType * >( nullptr ) );
+  if( isBoolean )
+    {
+    m_ImageIO->SetComponentType( IOComponentEnum::UCHAR );
+    }
+  m_ImageIO->SetUseCompression( m_UseCompression );
+  m_ImageIO->SetFileName( m_FileName );
+
+  const bool streaming = m_UseStreaming && m_ImageIO->CanStreamWrite();
+  m_ImageIO->SetUseStreamedWriting( streaming );
+
+  // ImageIO expects the pixel components last, so the tensor is written
+  // through a view in that layout.  The slowest varying index
+  // dimension is then the first tensor dimension.
+  const torch::Tensor source = InputImageType::PermuteComponentLayout( input->GetTensor(), input->GetComponentLayout(),
+    InputImageType::itkComponentsLast );
+  const bool writeDirectly = source.is_cpu() && source.is_contiguous() && !isBoolean;
+
+  constexpr unsigned int slabDimension = ImageDimension - 1;
+  const SizeValueType numberOfSlices = region.GetSize( slabDimension );
+  const SizeValueType slicesPerSlab = streaming ? m_NumberOfSlicesPerSlab : numberOfSlices;
+  for( SizeValueType firstSlice = 0; firstSlice < numberOfSlices; firstSlice += slicesPerSlab )
+    {
+    const SizeValueType slabSlices = std::min( slicesPerSlab, numberOfSlices - firstSlice );
+    ImageIORegion ioRegion( ImageDimension );
+    for( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      ioRegion.SetIndex( i, i == slabDimension ? static_cast< IndexValueType >( firstSlice ) : 0 );
+      ioRegion.SetSize( i, i == slabDimension ? slabSlices : region.GetSize( i ) );
+      }
+    m_ImageIO->SetIORegion( ioRegion );
+
+    torch::Tensor slab = source.narrow( 0, firstSlice, slabSlices );
+    if( !writeDirectly )
+      {
+      slab = slab.to( torch::kCPU, isBoolean ? torch::kByte : InputImageType::TorchValueType ).contiguous();
+      }
+    m_ImageIO->Write( slab.data_ptr() );
+    this->UpdateProgress( static_cast< float >( firstSlice + slabSlices ) / numberOfSlices );
+    }
+}
+
+template< typename TInputImage >
+void
+TorchImageFileWriter< TInputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_FileName: " << m_FileName << std::endl
+    << indent << "m_UserSpecifiedImageIO: " << m_UserSpecifiedImageIO << std::endl
+    << indent << "m_UseCompression: " << m_UseCompression << std::endl
+    << indent << "m_UseStreaming: " << m_UseStreaming << std::endl
+    << indent << "m_NumberOfSlicesPerSlab: " << m_NumberOfSlicesPerSlab << std::endl
+    ;
+  itkPrintSelfObjectMacro( ImageIO );
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageRegionConstIterator_h
+#define itkTorchImageRegionConstIterator_h
+
+#include <array>
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchImageRegionConstIterator
+ *  \brief A read-only iterator over a region of a TorchImage.
+ *
+ * TorchImageRegionConstIterator visits each pixel of a region in the
+ * same order as ImageRegionConstIterator, with the first index
+ * component varying the fastest.  It walks the torch::Tensor buffer
+ * directly through its strides, so it also works for tensors that
+ * are views with non-contiguous strides.  The index dimensions of the
+ * tensor are in reverse order and the pixel component dimensions
+ * follow or precede them, depending on the component layout of the
+ * image, as described for TorchImage::ComputeTorchSize().
+ *
+ * The tensor must reside in CPU memory; constructing an iterator over
+ * a TorchImage whose tensor is on a GPU throws an exception.  Use
+ * TorchImage::SetDevice( itkCPU ) to move it first.
+ *
+ * Get() returns a pixel value and Value() returns a
+ * TorchPixelHelper, which converts to a pixel value.
+ *
+ * \sa TorchImageRegionIterator
+ * \sa TorchImageScanlineConstIterator
+ *
+ * \ingroup PyTorch
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT TorchImageRegionConstIterator
+{
+public:
+  /** Standard class type aliases. */
+  using Self = TorchImageRegionConstIterator;
+
+  /** Dimension of the image that the iterator walks. */
+  static constexpr unsigned int ImageIteratorDimension = TImage::ImageDimension;
+
+  /** Image type alias support. */
+  using ImageType = TImage;
+  using IndexType = typename TImage::IndexType;
+  using IndexValueType = typename TImage::IndexValueType;
+  using SizeType = typename TImage::SizeType;
+  using OffsetValueType = typename TImage::OffsetValueType;
+  using RegionType = typename TImage::RegionType;
+  using PixelType = typename TImage::PixelType;
+  using PixelHelperType = typename TImage::TorchImagePixelHelper;
+  using DeepScalarType = typename TImage::DeepScalarType;
+  static constexpr unsigned int PixelDimension = TImage::PixelDimension;
+
+  /** Default constructor.  Needed since we provide a cast constructor. */
+  TorchImageRegionConstIterator();
+
+  /** Constructor establishes an iterator to walk a particular image
+   * and a particular region of that image. */
+  TorchImageRegionConstIterator( const ImageType *ptr, const RegionType & region );
+
+  /** Default destructor. */
+  virtual ~TorchImageRegionConstIterator() = default;
+
+  /** Move the iterator to the beginning of the region. */
+  void GoToBegin();
+
+  /** Is the iterator at the end of the region? */
+  bool IsAtEnd() const
+    {
+    return !m_Remaining;
+    }
+
+  /** Move to the next pixel, with the first index component varying
+   * the fastest. */
+  Self & operator++();
+
+  /** Get the index of the current pixel. */
+  const IndexType & GetIndex() const
+    {
+    return m_PositionIndex;
+    }
+
+  /** Move the iterator to an index within the region. */
+  void SetIndex( const IndexType & index );
+
+  /** Get the region that this iterator walks. */
+  const RegionType & GetRegion() const
+    {
+    return m_Region;
+    }
+
+  /** Get the pixel value. */
+  PixelType Get() const
+    {
+    return this->MakePixelHelper();
+    }
+
+  /** Return a proxy for the current pixel that converts to a pixel
+   * value. */
+  const PixelHelperType Value() const
+    {
+    return this->MakePixelHelper();
+    }
+
+  bool operator==( const Self & it ) const
+    {
+    return m_Position == it.m_Position;
+    }
+
+  bool operator!=( const Self & it ) const
+    {
+    return m_Position != it.m_Position;
+    }
+
+protected:
+  /** Recompute m_Position from m_PositionIndex */
+  void ComputePosition();
+
+  PixelHelperType MakePixelHelper() const
+    {
+    return PixelHelperType { m_Position, m_ComponentStrides.data() };
+    }
+
+  /** For the constructors of the iterators that write: copy the pixels
+   * of a copy-on-write image if they are still shared, and return the
+   * image. */
+  static ImageType * MakeWritable( ImageType *ptr )
+    {
+    if( ptr != nullptr )
+      {
+      ptr->MakeTensorWritable();
+      }
+    return ptr;
+    }
+
+  typename ImageType::ConstWeakPointer m_Image;
+
+  /** Keeps the buffer alive for the lifetime of the iterator. */
+  torch::Tensor m_Tensor;
+
+  RegionType m_Region;
+  IndexType m_PositionIndex;
+  IndexType m_BeginIndex;
+  IndexType m_EndIndex; // one past the last index, in each dimension
+  IndexType m_BufferedIndex;
+  bool m_Remaining;
+
+  /** Strides of the index dimensions, in ITK order, counted in deep
+   * scalars. */
+  std::array< OffsetValueType, ImageIteratorDimension > m_Strides;
+  /** Strides of the pixel component dimensions, outermost first. */
+  std::array< int64_t, PixelDimension > m_ComponentStrides;
+
+  /** The deep scalar at the first index of the buffered region */
+  DeepScalarType *m_Buffer;
+  DeepScalarType *m_Position;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchImageRegionConstIterator.hxx"
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageRegionConstIterator_hxx
+#define itkTorchImageRegionConstIterator_hxx
+
+#include "itkTorchImageRegionConstIterator.h"
+
+namespace itk
+{
+
+template< typename TImage >
+TorchImageRegionConstIterator< TImage >
+::TorchImageRegionConstIterator()
+{
+  m_PositionIndex.Fill( 0 );
+  m_BeginIndex.Fill( 0 );
+  m_EndIndex.Fill( 0 );
+  m_BufferedIndex.Fill( 0 );
+  m_Remaining = false;
+  m_Strides.fill( 0 );
+  m_ComponentStrides.fill( 0 );
+  m_Buffer = nullptr;
+  m_Position = nullptr;
+}
+
+template< typename TImage >
+TorchImageRegionConstIterator< TImage >
+::TorchImageRegionConstIterator( const ImageType *ptr, const RegionType & region )
+{
+  m_Image = ptr;
+  m_Tensor = ptr->GetTensor();
+  m_Region = region;
+
+  if( !m_Tensor.defined() )
+    {
+    itkGenericExceptionMacro( << "TorchImageRegionConstIterator requires an allocated TorchImage" );
+    }
+  if( !m_Tensor.is_cpu() )
+    {
+    itkGenericExceptionMacro( << "TorchImageRegionConstIterator requires a TorchImage whose tensor resides in CPU memory;"
+      << " call SetDevice( itkCPU ) first" );
+    }
+
+  const RegionType & bufferedRegion = ptr->GetBufferedRegion();
+  if( region.GetNumberOfPixels() > 0 && !bufferedRegion.IsInside( region ) )
+    {
+    itkGenericExceptionMacro( << "Region " << region << " is outside of buffered region " << bufferedRegion );
+    }
+
+  // The index dimensions are in reverse order in the tensor, and the
+  // pixel component dimensions are consecutive.
+  const int64_t * const strides = m_Tensor.strides().data();
+  const unsigned int firstIndexTorchDimension = ptr->GetFirstIndexTorchDimension();
+  const unsigned int firstComponentTorchDimension = ptr->GetFirstComponentTorchDimension();
+  for( unsigned int i = 0; i < ImageIteratorDimension; ++i )
+    {
+    m_Strides[i] = strides[firstIndexTorchDimension + ImageIteratorDimension - 1 - i];
+    }
+  for( unsigned int i = 0; i < PixelDimension; ++i )
+    {
+    m_ComponentStrides[i] = strides[firstComponentTorchDimension + i];
+    }
+
+  m_Buffer = m_Tensor.data_ptr< DeepScalarType >();
+  m_BufferedIndex = bufferedRegion.GetIndex();
+  m_BeginIndex = region.GetIndex();
+  for( unsigned int i = 0; i < ImageIteratorDimension; ++i )
+    {
+    m_EndIndex[i] = m_BeginIndex[i] + static_cast< IndexValueType >( region.GetSize()[i] );
+    }
+
+  this->GoToBegin();
+}
+
+template< typename TImage >
+void
+TorchImageRegionConstIterator< TImage >
+::GoToBegin()
+{
+  m_PositionIndex = m_BeginIndex;
+  m_Remaining = m_Region.GetNumberOfPixels() > 0;
+  this->ComputePosition();
+}
+
+template< typename TImage >
+void
+TorchImageRegionConstIterator< TImage >
+::SetIndex( const IndexType & index )
+{
+  m_PositionIndex = index;
+  m_Remaining = m_Region.IsInside( index );
+  this->ComputePosition();
+}
+
+template< typename TImage >
+void
+TorchImageRegionConstIterator< TImage >
+::ComputePosition()
+{
+  m_Position = m_Buffer;
+  for( unsigned int i = 0; i < ImageIteratorDimension; ++i )
+    {
+    m_Position += ( m_PositionIndex[i] - m_BufferedIndex[i] ) * m_Strides[i];
+    }
+}
+
+template< typename TImage >
+TorchImageRegionConstIterator< TImage > &
+TorchImageRegionConstIterator< TImage >
+::operator++()
+{
+  ++m_PositionIndex[0];
+  m_Position += m_Strides[0];
+  if( m_PositionIndex[0] < m_EndIndex[0] )
+    {
+    return *this;
+    }
+
+  // End of a line; carry into the slower varying dimensions.
+  for( unsigned int i = 0; i < ImageIteratorDimension - 1; ++i )
+    {
+    if( m_PositionIndex[i] < m_EndIndex[i] )
+      {
+      break;
+      }
+    m_PositionIndex[i] = m_BeginIndex[i];
+    ++m_PositionIndex[i + 1];
+    }
+  m_Remaining = m_PositionIndex[ImageIteratorDimension - 1] < m_EndIndex[ImageIteratorDimension - 1];
+  this->ComputePosition();
+  return *this;
+}
+
+} // end namespace itk
+
+#endif
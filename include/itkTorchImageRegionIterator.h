@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageRegionIterator_h
+#define itkTorchImageRegionIterator_h
+
+#include "itkTorchImageRegionConstIterator.h"
+
+namespace itk
+{
+/** \class TorchImageRegionIterator
+ *  \brief A read-write iterator over a region of a TorchImage.
+ *
+ * This is the read-write counterpart of
+ * TorchImageRegionConstIterator.  Set() writes a pixel value and
+ * Value() returns a TorchPixelHelper that can be used as an lvalue,
+ * in the same way as TorchImage::GetPixel().
+ *
+ * The tensor must reside in CPU memory.
+ *
+ * \sa TorchImageRegionConstIterator
+ *
+ * \ingroup PyTorch
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT TorchImageRegionIterator : public TorchImageRegionConstIterator< TImage >
+{
+public:
+  /** Standard class type aliases. */
+  using Self = TorchImageRegionIterator;
+  using Superclass = TorchImageRegionConstIterator< TImage >;
+
+  using ImageType = typename Superclass::ImageType;
+  using RegionType = typename Superclass::RegionType;
+  using PixelType = typename Superclass::PixelType;
+  using PixelHelperType = typename Superclass::PixelHelperType;
+
+  /** Default constructor.  Needed since we provide a cast constructor. */
+  TorchImageRegionIterator() = default;
+
+  /** Constructor establishes an iterator to walk a particular image
+   * and a particular region of that image.  The pixels of a
+   * copy-on-write image are copied first if they are still shared. */
+  TorchImageRegionIterator( ImageType *ptr, const RegionType & region ) : Superclass( Self::MakeWritable( ptr ), region )
+    {
+    }
+
+  /** Set the pixel value. */
+  void Set( const PixelType & value ) const
+    {
+    this->MakePixelHelper() = value;
+    }
+
+  /** Return a proxy for the current pixel that can be used as an
+   * lvalue. */
+  PixelHelperType Value() const
+    {
+    return this->MakePixelHelper();
+    }
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageScanlineConstIterator_h
+#define itkTorchImageScanlineConstIterator_h
+
+#include "itkTorchImageRegionConstIterator.h"
+
+namespace itk
+{
+/** \class TorchImageScanlineConstIterator
+ *  \brief A read-only iterator over a TorchImage region, one line at a time.
+ *
+ * As with ImageScanlineConstIterator, operator++ moves along the
+ * current line (the first index dimension) only, and NextLine()
+ * moves to the start of the next line.  Within a line, advancing is
+ * a single pointer increment by the stride of the first index
+ * dimension.
+ *
+ * \code
+ * it.GoToBegin();
+ * while( !it.IsAtEnd() )
+ *   {
+ *   while( !it.IsAtEndOfLine() )
+ *     {
+ *     value = it.Get();
+ *     ++it;
+ *     }
+ *   it.NextLine();
+ *   }
+ * \endcode
+ *
+ * The tensor must reside in CPU memory.
+ *
+ * \sa TorchImageRegionConstIterator
+ * \sa TorchImageScanlineIterator
+ *
+ * \ingroup PyTorch
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT TorchImageScanlineConstIterator : public TorchImageRegionConstIterator< TImage >
+{
+public:
+  /** Standard class type aliases. */
+  using Self = TorchImageScanlineConstIterator;
+  using Superclass = TorchImageRegionConstIterator< TImage >;
+
+  static constexpr unsigned int ImageIteratorDimension = Superclass::ImageIteratorDimension;
+  using ImageType = typename Superclass::ImageType;
+  using RegionType = typename Superclass::RegionType;
+
+  /** Default constructor.  Needed since we provide a cast constructor. */
+  TorchImageScanlineConstIterator() = default;
+
+  /** Constructor establishes an iterator to walk a particular image
+   * and a particular region of that image. */
+  TorchImageScanlineConstIterator( const ImageType *ptr, const RegionType & region ) : Superclass( ptr, region )
+    {
+    }
+
+  /** Is the iterator past the last pixel of the current line? */
+  bool IsAtEndOfLine() const
+    {
+    return this->m_PositionIndex[0] >= this->m_EndIndex[0];
+    }
+
+  /** Move to the first pixel of the current line. */
+  void GoToBeginOfLine()
+    {
+    this->m_Position -= ( this->m_PositionIndex[0] - this->m_BeginIndex[0] ) * this->m_Strides[0];
+    this->m_PositionIndex[0] = this->m_BeginIndex[0];
+    }
+
+  /** Move to the first pixel of the next line. */
+  void NextLine()
+    {
+    this->m_PositionIndex[0] = this->m_EndIndex[0];
+    --this->m_PositionIndex[0];
+    this->Superclass::operator++();
+    }
+
+  /** Move to the next pixel of the current line.  This does not move
+   * to the next line. */
+  Self & operator++()
+    {
+    ++this->m_PositionIndex[0];
+    this->m_Position += this->m_Strides[0];
+    return *this;
+    }
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageSerializer_h
+#define itkTorchImageSerializer_h
+
+#include "itkObject.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchImageSerializer
+ *  \brief Save and load TorchImages in the format of Python's torch.save.
+ *
+ * Save() writes the tensor and the meta information of a TorchImage,
+ * using libtorch's pickler, as a dictionary with the keys "tensor" (a
+ * CPU tensor, in the component layout of the image), "origin",
+ * "spacing", "direction" (row-major), "index" and "size" (of the
+ * buffered region), "largest_index" and "largest_size", "dtype",
+ * "component_sizes", "component_layout" ("last" or "first") and
+ * "device", so that torch.load( fileName ) returns all of them in
+ * Python.  Views are saved compactly.
+ *
+ * Load() restores an image saved by Save().  The tensor storage is
+ * read from the file straight into its final memory.  With MemoryMap
+ * on, it is instead memory mapped copy-on-write, as by
+ * TorchImage::AllocateFromFile(), so pages are read only when pixels
+ * are accessed; this is not supported on Windows.  The tensor is
+ * converted if its dtype is not the TorchValueType of the image, and
+ * moved to the saved CUDA device.  If that device does not exist, the
+ * image stays in CPU memory and a warning is emitted.
+ *
+ * The serializer keeps libtorch's serialization headers out of
+ * itkTorchImage.h; include this header where images are saved or
+ * loaded.
+ *
+ * \sa TorchImage
+ *
+ * \ingroup PyTorch
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT TorchImageSerializer : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchImageSerializer );
+
+  /** Standard class type aliases */
+  using Self = TorchImageSerializer;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchImageSerializer, Object );
+
+  using ImageType = TImage;
+  using RegionType = typename ImageType::RegionType;
+
+  static constexpr unsigned int ImageDimension = ImageType::ImageDimension;
+
+  /** Whether Load() memory maps the tensor storage rather than reading
+   * it.  Off by default. */
+  itkSetMacro( MemoryMap, bool );
+  itkGetConstMacro( MemoryMap, bool );
+  itkBooleanMacro( MemoryMap );
+
+  /** Save an allocated image to a file. */
+  void Save( const ImageType *image, const std::string & fileName ) const;
+
+  /** Load an image saved by Save() into image, replacing its tensor
+   * and meta information. */
+  void Load( ImageType *image, const std::string & fileName ) const;
+
+protected:
+  TorchImageSerializer() = default;
+  ~TorchImageSerializer() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** Find an uncompressed record of a zip archive, such as written by
+   * Save(), in memory.  The record name is relative to the archive's
+   * top directory.  Returns false if there is no such record. */
+  static bool FindStoredArchiveRecord( const char *archive, uint64_t archiveSize, const std::string & recordName,
+    uint64_t & dataOffset, uint64_t & dataSize );
+
+private:
+  bool m_MemoryMap{ false };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchImageSerializer.hxx"
+#endif
+
+#endif
@@ -0,0 +1,394 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImageSerializer_hxx
+#define itkTorchImageSerializer_hxx
+
+#include "itkTorchImageSerializer.h"
+
+#include <cstring>
+#include <fstream>
+#include <caffe2/serialize/inline_container.h>
+#include <torch/csrc/jit/serialization/pickle.h>
+#include <torch/csrc/jit/serialization/unpickler.h>
+
+namespace itk
+{
+
+template< typename TImage >
+constexpr unsigned int
+TorchImageSerializer< TImage >
+::ImageDimension;
+
+template< typename TImage >
+void
+TorchImageSerializer< TImage >
+::Save( const ImageType *image, const std::string & fileName ) const
+{
+  if( image == nullptr || !image->m_Allocated )
+    {
+    itkExceptionMacro( << "Save() requires an allocated TorchImage" );
+    }
+
+  // The pickler saves whole storages, so views are made compact first.
+  torch::Tensor tensor = image->m_Tensor;
+  if( !tensor.is_cpu() )
+    {
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkDeviceTransfer,
+      &image->m_InstrumentationCounters, image );
+    tensor = tensor.to( torch::kCPU );
+    probe.Stop( tensor.nbytes() );
+    }
+  if( !tensor.is_contiguous() || tensor.storage_offset() != 0
+    || tensor.storage().nbytes() != static_cast< size_t >( tensor.numel() * tensor.element_size() ) )
+    {
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkCopy, &image->m_InstrumentationCounters, image );
+    tensor = tensor.clone( at::MemoryFormat::Contiguous );
+    probe.Stop( tensor.nbytes() );
+    }
+
+  const RegionType & bufferedRegion = image->GetBufferedRegion();
+  const RegionType & largestRegion = image->GetLargestPossibleRegion();
+  std::vector< double > origin( ImageDimension );
+  std::vector< double > spacing( ImageDimension );
+  std::vector< double > direction( ImageDimension * ImageDimension );
+  std::vector< int64_t > index( ImageDimension );
+  std::vector< int64_t > size( ImageDimension );
+  std::vector< int64_t > largestIndex( ImageDimension );
+  std::vector< int64_t > largestSize( ImageDimension );
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    origin[i] = image->GetOrigin()[i];
+    spacing[i] = image->GetSpacing()[i];
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      direction[i * ImageDimension + j] = image->GetDirection()[i][j];
+      }
+    index[i] = bufferedRegion.GetIndex( i );
+    size[i] = static_cast< int64_t >( bufferedRegion.GetSize( i ) );
+    largestIndex[i] = largestRegion.GetIndex( i );
+    largestSize[i] = static_cast< int64_t >( largestRegion.GetSize( i ) );
+    }
+  std::vector< int64_t > componentSizes;
+  ImageType::TorchImagePixelHelper::AppendSizes( componentSizes );
+
+  c10::impl::GenericDict dictionary( c10::StringType::get(), c10::AnyType::get() );
+  dictionary.insert( "format", std::string( "itk.TorchImage" ) );
+  dictionary.insert( "version", static_cast< int64_t >( 1 ) );
+  dictionary.insert( "tensor", tensor );
+  dictionary.insert( "origin", origin );
+  dictionary.insert( "spacing", spacing );
+  dictionary.insert( "direction", direction );
+  dictionary.insert( "index", index );
+  dictionary.insert( "size", size );
+  dictionary.insert( "largest_index", largestIndex );
+  dictionary.insert( "largest_size", largestSize );
+  dictionary.insert( "dtype", std::string( c10::toString( ImageType::TorchValueType ) ) );
+  dictionary.insert( "component_sizes", componentSizes );
+  dictionary.insert( "component_layout",
+    std::string( image->m_ComponentLayout == ImageType::itkComponentsFirst ? "first" : "last" ) );
+  dictionary.insert( "device",
+    image->m_DeviceType == ImageType::itkCUDA ? "cuda:" + std::to_string( image->m_CudaDeviceNumber )
+    : std::string( "cpu" ) );
+
+  const std::vector< char > bytes = torch::jit::pickle_save( dictionary );
+  std::ofstream file( fileName, std::ios::binary | std::ios::trunc );
+  file.write( bytes.data(), static_cast< std::streamsize >( bytes.size() ) );
+  if( !file )
+    {
+    itkExceptionMacro( << "Cannot write " << fileName );
+    }
+}
+
+template< typename TImage >
+void
+TorchImageSerializer< TImage >
+::Load( ImageType *image, const std::string & fileName ) const
+{
+  if( image == nullptr )
+    {
+    itkExceptionMacro( << "Load() requires an image" );
+    }
+
+  // The archive is read through libtorch's unpickler, with the tensor
+  // storage records either read from the file directly into their
+  // final memory or, with MemoryMap, pointed into a mapping of the
+  // file.
+  caffe2::serialize::PyTorchStreamReader reader( fileName );
+  at::DataPtr pickleData;
+  size_t pickleSize = 0;
+  std::tie( pickleData, pickleSize ) = reader.getRecord( "data.pkl" );
+
+  std::shared_ptr< void > mapping;
+  const char *archive = nullptr;
+  uint64_t archiveSize = 0;
+  if( m_MemoryMap )
+    {
+    void *data = nullptr;
+    mapping = ImageType::MapFile( fileName, ImageType::itkMapCopyOnWrite, 0, archiveSize, data );
+    archive = static_cast< const char * >( data );
+    }
+
+  size_t picklePosition = 0;
+  const auto readPickle = [&pickleData, pickleSize, &picklePosition]( char *buffer, size_t length ) -> size_t
+    {
+    length = std::min( length, pickleSize - picklePosition );
+    std::memcpy( buffer, static_cast< const char * >( pickleData.get() ) + picklePosition, length );
+    picklePosition += length;
+    return length;
+    };
+  const auto readRecord = [&reader, &mapping, archive, archiveSize, &fileName]( const std::string & name )
+    -> at::DataPtr
+    {
+    const std::string recordName = "data/" + name;
+    if( !mapping )
+      {
+      return std::get< 0 >( reader.getRecord( recordName ) );
+      }
+    uint64_t dataOffset = 0;
+    uint64_t dataSize = 0;
+    if( !Self::FindStoredArchiveRecord( archive, archiveSize, recordName, dataOffset, dataSize ) )
+      {
+      itkGenericExceptionMacro( << "Cannot memory map record " << recordName << " of " << fileName
+        << "; it is missing or compressed" );
+      }
+    // Each storage holds a reference to the mapping.
+    return at::DataPtr( const_cast< char * >( archive ) + dataOffset, new std::shared_ptr< void >( mapping ),
+      []( void *context ) { delete static_cast< std::shared_ptr< void > * >( context ); }, at::Device( at::kCPU ) );
+    };
+  torch::jit::Unpickler unpickler( readPickle, nullptr, nullptr, readRecord, at::Device( at::kCPU ) );
+  const c10::IValue value = unpickler.parse_ivalue();
+
+  if( !value.isGenericDict() )
+    {
+    itkExceptionMacro( << fileName << " does not hold a TorchImage" );
+    }
+  const c10::impl::GenericDict dictionary = value.toGenericDict();
+  if( !dictionary.contains( "format" ) || dictionary.at( "format" ).toStringRef() != "itk.TorchImage" )
+    {
+    itkExceptionMacro( << fileName << " does not hold a TorchImage" );
+    }
+  std::vector< int64_t > componentSizes;
+  ImageType::TorchImagePixelHelper::AppendSizes( componentSizes );
+  if( dictionary.at( "component_sizes" ).toIntList().vec() != componentSizes )
+    {
+    itkExceptionMacro( << fileName << " holds pixels with components of sizes "
+      << dictionary.at( "component_sizes" ) << " but this image has " << torch::IntArrayRef( componentSizes ) );
+    }
+
+  const std::vector< double > origin = dictionary.at( "origin" ).toDoubleList().vec();
+  const std::vector< double > spacing = dictionary.at( "spacing" ).toDoubleList().vec();
+  const std::vector< double > direction = dictionary.at( "direction" ).toDoubleList().vec();
+  const std::vector< int64_t > index = dictionary.at( "index" ).toIntList().vec();
+  const std::vector< int64_t > size = dictionary.at( "size" ).toIntList().vec();
+  const std::vector< int64_t > largestIndex = dictionary.at( "largest_index" ).toIntList().vec();
+  const std::vector< int64_t > largestSize = dictionary.at( "largest_size" ).toIntList().vec();
+  if( origin.size() != ImageDimension || spacing.size() != ImageDimension
+    || direction.size() != ImageDimension * ImageDimension || index.size() != ImageDimension
+    || size.size() != ImageDimension || largestIndex.size() != ImageDimension || largestSize.size() != ImageDimension )
+    {
+    itkExceptionMacro( << fileName << " holds an image of another dimension than " << ImageDimension );
+    }
+
+  typename ImageType::PointType imageOrigin;
+  typename ImageType::SpacingType imageSpacing;
+  typename ImageType::DirectionType imageDirection;
+  RegionType bufferedRegion;
+  RegionType largestRegion;
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    imageOrigin[i] = origin[i];
+    imageSpacing[i] = spacing[i];
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      imageDirection[i][j] = direction[i * ImageDimension + j];
+      }
+    bufferedRegion.SetIndex( i, index[i] );
+    bufferedRegion.SetSize( i, static_cast< typename RegionType::SizeValueType >( size[i] ) );
+    largestRegion.SetIndex( i, largestIndex[i] );
+    largestRegion.SetSize( i, static_cast< typename RegionType::SizeValueType >( largestSize[i] ) );
+    }
+
+  image->ReleaseTensor();
+  image->m_Allocated = false;
+  image->SetComponentLayout( dictionary.at( "component_layout" ).toStringRef() == "first"
+    ? ImageType::itkComponentsFirst : ImageType::itkComponentsLast );
+  image->SetOrigin( imageOrigin );
+  image->SetSpacing( imageSpacing );
+  image->SetDirection( imageDirection );
+  image->SetLargestPossibleRegion( largestRegion );
+  image->SetBufferedRegion( bufferedRegion );
+  image->SetRequestedRegion( bufferedRegion );
+
+  torch::Tensor tensor = dictionary.at( "tensor" ).toTensor();
+  if( tensor.scalar_type() != ImageType::TorchValueType )
+    {
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkCopy, &image->m_InstrumentationCounters, image );
+    tensor = tensor.to( ImageType::TorchValueType );
+    probe.Stop( tensor.nbytes() );
+    }
+  image->SetTensor( tensor );
+
+  const std::string device = dictionary.at( "device" ).toStringRef();
+  if( device.compare( 0, 5, "cuda:" ) == 0
+    && !image->SetDevice( ImageType::itkCUDA, std::stoull( device.substr( 5 ) ) ) )
+    {
+    itkWarningMacro( << fileName << " was saved on " << device
+      << ", which does not exist here; the image stays in CPU memory" );
+    }
+}
+
+template< typename TImage >
+bool
+TorchImageSerializer< TImage >
+::FindStoredArchiveRecord( const char *archive, uint64_t archiveSize, const std::string & recordName,
+  uint64_t & dataOffset, uint64_t & dataSize )
+{
+  // Zip archives are little endian, as are all platforms libtorch
+  // supports.
+  const auto read16 = [archive]( uint64_t position )
+    {
+    uint16_t value;
+    std::memcpy( &value, archive + position, sizeof( value ) );
+    return static_cast< uint64_t >( value );
+    };
+  const auto read32 = [archive]( uint64_t position )
+    {
+    uint32_t value;
+    std::memcpy( &value, archive + position, sizeof( value ) );
+    return static_cast< uint64_t >( value );
+    };
+  const auto read64 = [archive]( uint64_t position )
+    {
+    uint64_t value;
+    std::memcpy( &value, archive + position, sizeof( value ) );
+    return value;
+    };
+  constexpr uint64_t overflow32 = 0xFFFFFFFF;
+
+  // The end of central directory record is at the end, before an
+  // optional comment.
+  constexpr uint64_t endRecordSize = 22;
+  if( archiveSize < endRecordSize )
+    {
+    return false;
+    }
+  uint64_t endRecord = archiveSize - endRecordSize;
+  while( read32( endRecord ) != 0x06054b50 )
+    {
+    if( endRecord == 0 || archiveSize - endRecord > endRecordSize + 0xFFFF )
+      {
+      return false;
+      }
+    --endRecord;
+    }
+  uint64_t numberOfEntries = read16( endRecord + 10 );
+  uint64_t position = read32( endRecord + 16 );
+  if( position == overflow32 || numberOfEntries == 0xFFFF )
+    {
+    // Zip64: the locator precedes the end of central directory record.
+    if( endRecord < 20 || read32( endRecord - 20 ) != 0x07064b50 )
+      {
+      return false;
+      }
+    const uint64_t zip64EndRecord = read64( endRecord - 20 + 8 );
+    if( zip64EndRecord + 56 > archiveSize || read32( zip64EndRecord ) != 0x06064b50 )
+      {
+      return false;
+      }
+    numberOfEntries = read64( zip64EndRecord + 32 );
+    position = read64( zip64EndRecord + 48 );
+    }
+
+  for( uint64_t entry = 0; entry < numberOfEntries; ++entry )
+    {
+    if( position + 46 > archiveSize || read32( position ) != 0x02014b50 )
+      {
+      return false;
+      }
+    const uint64_t compression = read16( position + 10 );
+    uint64_t size = read32( position + 24 );
+    const uint64_t nameLength = read16( position + 28 );
+    const uint64_t extraLength = read16( position + 30 );
+    const uint64_t commentLength = read16( position + 32 );
+    uint64_t localHeader = read32( position + 42 );
+    if( position + 46 + nameLength + extraLength > archiveSize )
+      {
+      return false;
+      }
+    const std::string name( archive + position + 46, nameLength );
+
+    // Names start with the archive's top directory.
+    const std::string::size_type slash = name.find( '/' );
+    if( slash != std::string::npos && name.compare( slash + 1, std::string::npos, recordName ) == 0 )
+      {
+      if( compression != 0 )
+        {
+        return false;
+        }
+      // Zip64 extended information holds the sizes and offset that
+      // do not fit in 32 bits, in this order.
+      uint64_t extra = position + 46 + nameLength;
+      const uint64_t extraEnd = extra + extraLength;
+      while( extra + 4 <= extraEnd )
+        {
+        const uint64_t extraId = read16( extra );
+        const uint64_t extraSize = read16( extra + 2 );
+        if( extraId == 0x0001 )
+          {
+          uint64_t field = extra + 4;
+          if( size == overflow32 )
+            {
+            size = read64( field );
+            field += 8;
+            }
+          if( read32( position + 20 ) == overflow32 )
+            {
+            field += 8;
+            }
+          if( localHeader == overflow32 )
+            {
+            localHeader = read64( field );
+            }
+          }
+        extra += 4 + extraSize;
+        }
+      if( localHeader + 30 > archiveSize || read32( localHeader ) != 0x04034b50 )
+        {
+        return false;
+        }
+      dataOffset = localHeader + 30 + read16( localHeader + 26 ) + read16( localHeader + 28 );
+      dataSize = size;
+      return dataOffset + dataSize <= archiveSize;
+      }
+    position += 46 + nameLength + extraLength + commentLength;
+    }
+  return false;
+}
+
+template< typename TImage >
+void
+TorchImageSerializer< TImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "m_MemoryMap: " << m_MemoryMap << std::endl;
+}
+
+} // end namespace itk
+
+#endif
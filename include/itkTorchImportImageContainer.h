@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchImportImageContainer_h
+#define itkTorchImportImageContainer_h
+
+#include <torch/torch.h>
+#include "itkImportImageContainer.h"
+
+namespace itk
+{
+/** \class TorchImportImageContainer
+ *  \brief An ImportImageContainer that borrows the memory of a torch::Tensor.
+ *
+ * The container points at the tensor's CPU memory without copying it
+ * and holds a reference to the tensor, so that the memory stays valid
+ * for as long as the container exists.  The container never frees
+ * the memory itself.  It is used by TorchImage::ToImage() to hand the
+ * pixel data of a TorchImage to an itk::Image.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TElementIdentifier, typename TElement >
+class ITK_TEMPLATE_EXPORT TorchImportImageContainer : public ImportImageContainer< TElementIdentifier, TElement >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchImportImageContainer );
+
+  /** Standard class type aliases. */
+  using Self = TorchImportImageContainer;
+  using Superclass = ImportImageContainer< TElementIdentifier, TElement >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using ElementIdentifier = TElementIdentifier;
+  using Element = TElement;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchImportImageContainer, ImportImageContainer );
+
+  /** Point the container at the memory of a contiguous CPU tensor,
+   * which holds numberOfElements elements, and keep a reference to
+   * the tensor. */
+  void SetTensor( const torch::Tensor & tensor, ElementIdentifier numberOfElements )
+    {
+    m_Tensor = tensor;
+    this->SetImportPointer( reinterpret_cast< TElement * >( tensor.data_ptr() ), numberOfElements, false );
+    }
+
+  const torch::Tensor & GetTensor() const
+    {
+    return m_Tensor;
+    }
+
+protected:
+  TorchImportImageContainer() = default;
+  ~TorchImportImageContainer() override = default;
+
+private:
+  torch::Tensor m_Tensor;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,417 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchInstrumentation_h
+#define itkTorchInstrumentation_h
+
+#include <atomic>
+#include <chrono>
+#include "itkEventObject.h"
+#include "itkIndent.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace itk
+{
+/** \class TorchInstrumentationCounters
+ *  \brief Counts, bytes and wall time of the operations of a TorchImage that allocate, move or copy pixels.
+ *
+ * The operations are
+ * - itkAllocation: Allocate(), whether the tensor comes from the
+ *   TorchTensorPool or is newly allocated, including its initializer;
+ * - itkDeviceTransfer: moving an allocated tensor between the CPU and
+ *   a GPU, or between GPUs, by SetDevice() or
+ *   TorchImageSerializer::Save();
+ * - itkCopy: a copy of the pixels that a call makes implicitly, by
+ *   SetComponentLayout(), ToImage(), TorchImageSerializer::Save() or
+ *   a dtype conversion in TorchImageSerializer::Load();
+ * - itkPixelProxyAccess: a read or write of a pixel through a
+ *   TorchPixelHelper that indexes the tensor with ATen, i.e. when
+ *   DirectCPUAccess is off or the tensor does not reside in CPU memory.
+ *   Each such access dispatches several ATen operations and creates
+ *   temporary tensors.
+ *
+ * All members are thread safe.
+ *
+ * \sa TorchInstrumentation
+ *
+ * \ingroup PyTorch
+ */
+class TorchInstrumentationCounters
+{
+public:
+  enum OperationType { itkAllocation, itkDeviceTransfer, itkCopy, itkPixelProxyAccess };
+  static constexpr unsigned int NumberOfOperations = 4;
+
+  TorchInstrumentationCounters()
+    {
+    this->Reset();
+    }
+  TorchInstrumentationCounters( const TorchInstrumentationCounters & ) = delete;
+  TorchInstrumentationCounters & operator=( const TorchInstrumentationCounters & ) = delete;
+
+  static const char * GetOperationName( OperationType operation )
+    {
+    static const char * const names[NumberOfOperations] =
+      { "Allocation", "DeviceTransfer", "Copy", "PixelProxyAccess" };
+    return names[operation];
+    }
+
+  /** Count one operation of numberOfBytes bytes that took seconds
+   * seconds of wall time. */
+  void Add( OperationType operation, uint64_t numberOfBytes, double seconds )
+    {
+    m_Counts[operation].fetch_add( 1, std::memory_order_relaxed );
+    m_NumberOfBytes[operation].fetch_add( numberOfBytes, std::memory_order_relaxed );
+    m_Nanoseconds[operation].fetch_add( static_cast< uint64_t >( seconds * 1e9 ), std::memory_order_relaxed );
+    }
+
+  /** Number of operations counted. */
+  uint64_t GetCount( OperationType operation ) const
+    {
+    return m_Counts[operation].load( std::memory_order_relaxed );
+    }
+
+  /** Bytes allocated, moved, copied or accessed by the operations. */
+  uint64_t GetNumberOfBytes( OperationType operation ) const
+    {
+    return m_NumberOfBytes[operation].load( std::memory_order_relaxed );
+    }
+
+  /** Wall time spent in the operations, in seconds. */
+  double GetSeconds( OperationType operation ) const
+    {
+    return 1e-9 * m_Nanoseconds[operation].load( std::memory_order_relaxed );
+    }
+
+  void Reset()
+    {
+    for( unsigned int i = 0; i < NumberOfOperations; ++i )
+      {
+      m_Counts[i] = 0;
+      m_NumberOfBytes[i] = 0;
+      m_Nanoseconds[i] = 0;
+      }
+    }
+
+  void Print( std::ostream & os, Indent indent ) const
+    {
+    for( unsigned int i = 0; i < NumberOfOperations; ++i )
+      {
+      const auto operation = static_cast< OperationType >( i );
+      os << indent << GetOperationName( operation ) << ": " << this->GetCount( operation ) << " times, "
+        << this->GetNumberOfBytes( operation ) << " bytes, " << this->GetSeconds( operation ) << " s" << std::endl;
+      }
+    }
+
+private:
+  std::atomic< uint64_t > m_Counts[NumberOfOperations];
+  std::atomic< uint64_t > m_NumberOfBytes[NumberOfOperations];
+  std::atomic< uint64_t > m_Nanoseconds[NumberOfOperations];
+};
+
+/** \class TorchInstrumentationEvent
+ *  \brief Base of the events that a TorchImage and the TorchInstrumentation invoke for each instrumented operation.
+ *
+ * An observer of TorchInstrumentationEvent receives the events of all
+ * operations; an observer of one of its subclasses, e.g.
+ * TorchDeviceTransferEvent, those of one operation.  The event carries
+ * the operation, its number of bytes and its wall time.
+ *
+ * \ingroup PyTorch
+ */
+class TorchInstrumentationEvent : public AnyEvent
+{
+public:
+  using Self = TorchInstrumentationEvent;
+  using Superclass = AnyEvent;
+  using OperationType = TorchInstrumentationCounters::OperationType;
+
+  TorchInstrumentationEvent() = default;
+  TorchInstrumentationEvent( OperationType operation, uint64_t numberOfBytes, double seconds )
+    : m_Operation( operation ),
+      m_NumberOfBytes( numberOfBytes ),
+      m_Seconds( seconds )
+    {
+    }
+  TorchInstrumentationEvent( const Self & ) = default;
+  ~TorchInstrumentationEvent() override = default;
+  Self & operator=( const Self & ) = delete;
+
+  const char * GetEventName() const override
+    {
+    return "TorchInstrumentationEvent";
+    }
+  bool CheckEvent( const EventObject * e ) const override
+    {
+    return dynamic_cast< const Self * >( e ) != nullptr;
+    }
+  EventObject * MakeObject() const override
+    {
+    return new Self;
+    }
+
+  OperationType GetOperation() const
+    {
+    return m_Operation;
+    }
+  uint64_t GetNumberOfBytes() const
+    {
+    return m_NumberOfBytes;
+    }
+  double GetSeconds() const
+    {
+    return m_Seconds;
+    }
+
+private:
+  OperationType m_Operation{ TorchInstrumentationCounters::itkAllocation };
+  uint64_t m_NumberOfBytes{ 0 };
+  double m_Seconds{ 0.0 };
+};
+
+/** Define an event for one instrumented operation. */
+#define itkTorchInstrumentationEventMacro( classname, operation )                   \
+  class classname : public TorchInstrumentationEvent                                \
+  {                                                                                 \
+  public:                                                                           \
+    using Self = classname;                                                         \
+    using Superclass = TorchInstrumentationEvent;                                   \
+    classname() = default;                                                          \
+    classname( uint64_t numberOfBytes, double seconds )                             \
+      : Superclass( TorchInstrumentationCounters::operation, numberOfBytes, seconds ) \
+      {                                                                             \
+      }                                                                             \
+    classname( const Self & ) = default;                                            \
+    ~classname() override = default;                                                \
+    Self & operator=( const Self & ) = delete;                                      \
+    const char * GetEventName() const override                                      \
+      {                                                                             \
+      return #classname;                                                            \
+      }                                                                             \
+    bool CheckEvent( const EventObject * e ) const override                         \
+      {                                                                             \
+      return dynamic_cast< const Self * >( e ) != nullptr;                          \
+      }                                                                             \
+    EventObject * MakeObject() const override                                       \
+      {                                                                             \
+      return new Self;                                                              \
+      }                                                                             \
+  }
+
+itkTorchInstrumentationEventMacro( TorchAllocationEvent, itkAllocation );
+itkTorchInstrumentationEventMacro( TorchDeviceTransferEvent, itkDeviceTransfer );
+itkTorchInstrumentationEventMacro( TorchCopyEvent, itkCopy );
+itkTorchInstrumentationEventMacro( TorchPixelProxyAccessEvent, itkPixelProxyAccess );
+
+#undef itkTorchInstrumentationEventMacro
+
+/** \class TorchInstrumentation
+ *  \brief Opt-in, per-process instrumentation of the allocations, device transfers, copies and pixel proxy accesses of TorchImages.
+ *
+ * When enabled, every TorchImage counts its instrumented operations,
+ * as listed for TorchInstrumentationCounters, both in its own counters
+ * and in the global counters of this object, and invokes the matching
+ * TorchInstrumentationEvent on itself and on this object, so that the
+ * usual Command observers can log them:
+ *
+ * \code
+ * itk::TorchInstrumentation::GetInstance()->EnabledOn();
+ * image->AddObserver( itk::TorchDeviceTransferEvent(), command );
+ * ...
+ * std::cout << image->GetInstrumentationCounters().GetCount( itk::TorchInstrumentationCounters::itkCopy );
+ * \endcode
+ *
+ * The instrumentation is disabled by default; disabled, it costs one
+ * atomic load per operation.  Wall times are those of the calling
+ * thread, which for operations on a GPU include only what the host
+ * waits for.
+ *
+ * All methods are thread safe.
+ *
+ * \ingroup PyTorch
+ */
+class TorchInstrumentation : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchInstrumentation );
+
+  /** Standard class type aliases */
+  using Self = TorchInstrumentation;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using OperationType = TorchInstrumentationCounters::OperationType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchInstrumentation, Object );
+
+  /** The instrumentation shared by all TorchImages of the process. */
+  static Self * GetInstance()
+    {
+    // Deliberately never destroyed, like the TorchTensorPool, so that
+    // images released during process exit can still use it.
+    static Self * const instance = []()
+      {
+      Pointer instrumentation = Self::New();
+      instrumentation->Register();
+      return instrumentation.GetPointer();
+      }();
+    return instance;
+    }
+
+  /** Enable or disable the instrumentation.  The counters keep their
+   * values while it is disabled. */
+  void SetEnabled( bool enabled )
+    {
+    if( m_Enabled.exchange( enabled ) != enabled )
+      {
+      this->Modified();
+      }
+    }
+  bool GetEnabled() const
+    {
+    return m_Enabled.load( std::memory_order_relaxed );
+    }
+  itkBooleanMacro( Enabled );
+
+  /** The counters of all TorchImages of the process. */
+  const TorchInstrumentationCounters & GetCounters() const
+    {
+    return m_Counters;
+    }
+
+  void ResetCounters()
+    {
+    m_Counters.Reset();
+    }
+
+  /** Count an operation in the global counters and in counters, and
+   * invoke its event on this object and on caller. */
+  void Record( OperationType operation, uint64_t numberOfBytes, double seconds, TorchInstrumentationCounters & counters,
+    const Object * caller ) const
+    {
+    m_Counters.Add( operation, numberOfBytes, seconds );
+    counters.Add( operation, numberOfBytes, seconds );
+    switch( operation )
+      {
+      case TorchInstrumentationCounters::itkAllocation:
+        Self::Invoke( TorchAllocationEvent( numberOfBytes, seconds ), caller );
+        break;
+      case TorchInstrumentationCounters::itkDeviceTransfer:
+        Self::Invoke( TorchDeviceTransferEvent( numberOfBytes, seconds ), caller );
+        break;
+      case TorchInstrumentationCounters::itkCopy:
+        Self::Invoke( TorchCopyEvent( numberOfBytes, seconds ), caller );
+        break;
+      case TorchInstrumentationCounters::itkPixelProxyAccess:
+        Self::Invoke( TorchPixelProxyAccessEvent( numberOfBytes, seconds ), caller );
+        break;
+      }
+    }
+
+protected:
+  TorchInstrumentation() = default;
+  ~TorchInstrumentation() override = default;
+
+  void PrintSelf( std::ostream & os, Indent indent ) const override
+    {
+    Superclass::PrintSelf( os, indent );
+    os << indent << "m_Enabled: " << m_Enabled.load() << std::endl
+      << indent << "m_Counters:" << std::endl;
+    m_Counters.Print( os, indent.GetNextIndent() );
+    }
+
+  void Invoke( const TorchInstrumentationEvent & event, const Object * caller ) const
+    {
+    this->InvokeEvent( event );
+    if( caller != nullptr )
+      {
+      caller->InvokeEvent( event );
+      }
+    }
+
+private:
+  std::atomic< bool > m_Enabled{ false };
+  mutable TorchInstrumentationCounters m_Counters;
+};
+
+/** \class TorchInstrumentationProbe
+ *  \brief Time one instrumented operation and record it with the TorchInstrumentation.
+ *
+ * The probe starts timing when it is constructed, if the
+ * instrumentation is enabled and counters are given, and records the
+ * operation when Stop() is called.  An operation that throws before
+ * Stop() is not recorded.
+ *
+ * \ingroup PyTorch
+ */
+class TorchInstrumentationProbe
+{
+public:
+  using OperationType = TorchInstrumentationCounters::OperationType;
+
+  TorchInstrumentationProbe( OperationType operation, TorchInstrumentationCounters * counters, const Object * caller )
+    : m_Operation( operation ),
+      m_Counters( counters != nullptr && TorchInstrumentation::GetInstance()->GetEnabled() ? counters : nullptr ),
+      m_Caller( caller )
+    {
+    if( m_Counters != nullptr )
+      {
+      m_Start = std::chrono::steady_clock::now();
+      }
+    }
+  TorchInstrumentationProbe( const TorchInstrumentationProbe & ) = delete;
+  TorchInstrumentationProbe & operator=( const TorchInstrumentationProbe & ) = delete;
+
+  /** Whether the operation is being timed. */
+  bool IsActive() const
+    {
+    return m_Counters != nullptr;
+    }
+
+  /** Record the operation, of numberOfBytes bytes. */
+  void Stop( uint64_t numberOfBytes )
+    {
+    if( m_Counters == nullptr )
+      {
+      return;
+      }
+    const std::chrono::duration< double > seconds = std::chrono::steady_clock::now() - m_Start;
+    TorchInstrumentation::GetInstance()->Record( m_Operation, numberOfBytes, seconds.count(), *m_Counters, m_Caller );
+    m_Counters = nullptr;
+    }
+
+  /** Forget the operation, e.g. because it did not copy after all. */
+  void Cancel()
+    {
+    m_Counters = nullptr;
+    }
+
+private:
+  OperationType m_Operation;
+  TorchInstrumentationCounters * m_Counters;
+  const Object * m_Caller;
+  std::chrono::steady_clock::time_point m_Start;
+};
+} // end namespace itk
+
+#endif
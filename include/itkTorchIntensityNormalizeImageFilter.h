@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchIntensityNormalizeImageFilter_h
+#define itkTorchIntensityNormalizeImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchIntensityNormalizeImageFilter
+ *  \brief Normalize the intensities of a TorchImage and cast them to another pixel type in one pass.
+ *
+ * Every normalization this filter offers is an affine map of the
+ * intensities, x * Scale + Shift, optionally clamped to
+ * [OutputMinimum, OutputMaximum]:
+ *
+ * - itkWindowLevel maps [WindowMinimum, WindowMaximum] to
+ *   [OutputMinimum, OutputMaximum] and clamps, as
+ *   IntensityWindowingImageFilter does.
+ * - itkMinMax maps the range of the input intensities to
+ *   [OutputMinimum, OutputMaximum], as RescaleIntensityImageFilter
+ *   does.
+ * - itkZScore subtracts the mean of the input intensities and divides
+ *   by their standard deviation.
+ * - itkPercentile maps [LowerPercentile, UpperPercentile] of the input
+ *   intensities to [OutputMinimum, OutputMaximum] and clamps.
+ *
+ * The statistics are computed with reductions over the input tensor,
+ * in a pass that precedes the normalization.  If a mask image is set,
+ * only the pixels where the mask is nonzero contribute to them; all
+ * pixels are normalized.  The components of vector pixels are pooled.
+ *
+ * The map is then applied in one ATen operation that reads the input
+ * in its own dtype and writes the output dtype straight into the
+ * output tensor, so no converted copy of the input is made.  On the
+ * CPU the tensors are processed in cache-sized slabs, so that the
+ * clamp, and for integer outputs the rounding, touch memory that is
+ * still in cache.  Integer outputs are rounded to the nearest integer
+ * and clamped to the range of the output pixel type.
+ *
+ * Scale and Shift can be queried after an update, e.g. to invert the
+ * normalization.  The output has the device and component layout of
+ * the input.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage,
+  typename TMaskImage = TorchImage< unsigned char, TInputImage::ImageDimension > >
+class ITK_TEMPLATE_EXPORT TorchIntensityNormalizeImageFilter : public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchIntensityNormalizeImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchIntensityNormalizeImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchIntensityNormalizeImageFilter, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using MaskImageType = TMaskImage;
+
+  static_assert( InputImageType::TorchImagePixelHelper::SizeOf == OutputImageType::TorchImagePixelHelper::SizeOf
+    && InputImageType::PixelDimension == OutputImageType::PixelDimension,
+    "TorchIntensityNormalizeImageFilter requires input and output pixels with the same components" );
+  static_assert( MaskImageType::PixelDimension == 0, "TorchIntensityNormalizeImageFilter requires a scalar mask" );
+
+  enum NormalizationType { itkWindowLevel, itkMinMax, itkZScore, itkPercentile };
+
+  /** The normalization to apply.  Defaults to itkMinMax. */
+  itkSetMacro( Normalization, NormalizationType );
+  itkGetConstMacro( Normalization, NormalizationType );
+
+  /** The input intensities mapped to OutputMinimum and OutputMaximum by
+   * itkWindowLevel. */
+  itkSetMacro( WindowMinimum, double );
+  itkGetConstMacro( WindowMinimum, double );
+  itkSetMacro( WindowMaximum, double );
+  itkGetConstMacro( WindowMaximum, double );
+
+  /** Set the window by its width and center, e.g. 400 and 40 for a
+   * soft tissue CT window. */
+  void SetWindowLevel( double window, double level );
+  double GetWindow() const
+    {
+    return m_WindowMaximum - m_WindowMinimum;
+    }
+  double GetLevel() const
+    {
+    return ( m_WindowMaximum + m_WindowMinimum ) / 2.0;
+    }
+
+  /** The percentiles, in [0, 100], mapped to OutputMinimum and
+   * OutputMaximum by itkPercentile.  Default to 0.5 and 99.5. */
+  itkSetClampMacro( LowerPercentile, double, 0.0, 100.0 );
+  itkGetConstMacro( LowerPercentile, double );
+  itkSetClampMacro( UpperPercentile, double, 0.0, 100.0 );
+  itkGetConstMacro( UpperPercentile, double );
+
+  /** The output range of itkWindowLevel, itkMinMax and itkPercentile.
+   * Defaults to [0, 1]. */
+  itkSetMacro( OutputMinimum, double );
+  itkGetConstMacro( OutputMinimum, double );
+  itkSetMacro( OutputMaximum, double );
+  itkGetConstMacro( OutputMaximum, double );
+
+  /** Set/Get the optional mask selecting the pixels whose statistics
+   * determine the normalization. */
+  itkSetInputMacro( MaskImage, MaskImageType );
+  itkGetInputMacro( MaskImage, MaskImageType );
+
+  /** The affine map applied by the last update. */
+  itkGetConstMacro( Scale, double );
+  itkGetConstMacro( Shift, double );
+
+protected:
+  TorchIntensityNormalizeImageFilter();
+  ~TorchIntensityNormalizeImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The whole image is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** The output takes the device and component layout of the input. */
+  void AllocateOutputs() override;
+
+  void GenerateData() override;
+
+  /** Compute m_Scale and m_Shift for the normalization, and whether
+   * the result is clamped to the output range. */
+  bool ComputeAffineMap();
+
+  /** The input intensities that the statistics are computed from,
+   * flattened. */
+  torch::Tensor GetStatisticsSample() const;
+
+private:
+  NormalizationType m_Normalization;
+  double m_WindowMinimum;
+  double m_WindowMaximum;
+  double m_LowerPercentile;
+  double m_UpperPercentile;
+  double m_OutputMinimum;
+  double m_OutputMaximum;
+  double m_Scale;
+  double m_Shift;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchIntensityNormalizeImageFilter.hxx"
+#endif
+
+#endif
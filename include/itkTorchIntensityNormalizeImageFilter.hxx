@@ -0,0 +1,259 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchIntensityNormalizeImageFilter_hxx
+#define itkTorchIntensityNormalizeImageFilter_hxx
+
+#include "itkTorchIntensityNormalizeImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+#include <cmath>
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::TorchIntensityNormalizeImageFilter()
+  : m_Normalization( itkMinMax ),
+    m_WindowMinimum( 0.0 ),
+    m_WindowMaximum( 1.0 ),
+    m_LowerPercentile( 0.5 ),
+    m_UpperPercentile( 99.5 ),
+    m_OutputMinimum( 0.0 ),
+    m_OutputMaximum( 1.0 ),
+    m_Scale( 1.0 ),
+    m_Shift( 0.0 )
+{
+  this->AddOptionalInputName( "MaskImage" );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::SetWindowLevel( double window, double level )
+{
+  this->SetWindowMinimum( level - window / 2.0 );
+  this->SetWindowMaximum( level + window / 2.0 );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::AllocateOutputs()
+{
+  this->GetOutput()->CopyTensorInformation( this->GetInput() );
+  Superclass::AllocateOutputs();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+torch::Tensor
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::GetStatisticsSample() const
+{
+  const InputImageType *input = this->GetInput();
+  torch::Tensor sample =
+    InputImageType::PermuteComponentLayout( input->GetTensor(), input->GetComponentLayout(), InputImageType::itkComponentsLast );
+
+  const MaskImageType *mask = this->GetMaskImage();
+  if( mask != nullptr )
+    {
+    if( mask->GetBufferedRegion() != input->GetBufferedRegion() || !mask->GetTensor().defined() )
+      {
+      itkExceptionMacro( << "The mask must be allocated with the buffered region of the input, "
+        << input->GetBufferedRegion() );
+      }
+    // Selecting by a mask of the index dimensions keeps all components
+    // of the selected pixels.
+    sample = sample.index( { mask->GetTensor().ne( 0 ).to( sample.device() ) } );
+    }
+  sample = sample.reshape( { -1 } );
+  if( sample.numel() == 0 )
+    {
+    itkExceptionMacro( << "There are no pixels to compute the normalization from" );
+    }
+  return sample;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+bool
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::ComputeAffineMap()
+{
+  double lower = 0.0;
+  double upper = 0.0;
+  switch( m_Normalization )
+    {
+    case itkWindowLevel:
+      lower = m_WindowMinimum;
+      upper = m_WindowMaximum;
+      break;
+    case itkMinMax:
+      {
+      const torch::Tensor sample = this->GetStatisticsSample();
+      lower = sample.min().item< double >();
+      upper = sample.max().item< double >();
+      break;
+      }
+    case itkPercentile:
+      {
+      // Nearest-rank percentiles, each found by a selection rather
+      // than a sort.
+      const torch::Tensor sample = this->GetStatisticsSample();
+      const auto percentile = [&sample]( double p )
+        {
+        const int64_t k = 1 + std::llround( p / 100.0 * static_cast< double >( sample.numel() - 1 ) );
+        return std::get< 0 >( sample.kthvalue( k ) ).item< double >();
+        };
+      lower = percentile( m_LowerPercentile );
+      upper = percentile( m_UpperPercentile );
+      break;
+      }
+    case itkZScore:
+      {
+      torch::Tensor sample = this->GetStatisticsSample();
+      if( !sample.is_floating_point() )
+        {
+        sample = sample.to( torch::kDouble );
+        }
+      // The unbiased estimate, as computed by StatisticsImageFilter.
+      const auto stdMean = torch::std_mean( sample, true );
+      const double sigma = std::get< 0 >( stdMean ).item< double >();
+      const double mean = std::get< 1 >( stdMean ).item< double >();
+      m_Scale = sigma > 0.0 ? 1.0 / sigma : 1.0;
+      m_Shift = -mean * m_Scale;
+      return false;
+      }
+    }
+
+  m_Scale = upper > lower ? ( m_OutputMaximum - m_OutputMinimum ) / ( upper - lower ) : 0.0;
+  m_Shift = m_OutputMinimum - lower * m_Scale;
+  return m_Normalization != itkMinMax;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  this->AllocateOutputs();
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+  bool clamp = this->ComputeAffineMap();
+
+  // Both tensors have the component layout of the input.
+  const torch::Tensor source = input->GetTensor();
+  torch::Tensor target = output->GetTensor();
+
+  // Integer outputs are computed in a floating point buffer, rounded
+  // and clamped to the range of the output pixel type.
+  const bool integerOutput = !target.is_floating_point();
+  double lower = m_OutputMinimum;
+  double upper = m_OutputMaximum;
+  if( integerOutput )
+    {
+    using OutputDeepScalarType = typename OutputImageType::DeepScalarType;
+    const double typeMinimum = static_cast< double >( NumericTraits< OutputDeepScalarType >::NonpositiveMin() );
+    const double typeMaximum = static_cast< double >( NumericTraits< OutputDeepScalarType >::max() );
+    lower = clamp ? std::max( lower, typeMinimum ) : typeMinimum;
+    upper = clamp ? std::min( upper, typeMaximum ) : typeMaximum;
+    clamp = true;
+    }
+  const torch::ScalarType computeType =
+    !integerOutput ? target.scalar_type() : ( target.element_size() <= 2 ? torch::kFloat : torch::kDouble );
+  // A zero-dimensional tensor, rather than a Scalar, so that integer
+  // inputs are promoted to computeType within the operation.
+  const torch::Tensor shift = torch::scalar_tensor( m_Shift, torch::dtype( computeType ).device( target.device() ) );
+
+  // On the CPU, slabs of this many elements stay in cache between the
+  // affine map and the clamp.  On a GPU the whole tensor is one slab.
+  constexpr int64_t slabElements = 1 << 16;
+  const int64_t numberOfRows = target.size( 0 );
+  int64_t rowsPerSlab = numberOfRows;
+  if( target.is_cpu() && numberOfRows > 0 )
+    {
+    const int64_t elementsPerRow = std::max< int64_t >( 1, target.numel() / numberOfRows );
+    rowsPerSlab = std::max< int64_t >( 1, slabElements / elementsPerRow );
+    }
+
+  torch::Tensor buffer;
+  for( int64_t firstRow = 0; firstRow < numberOfRows; firstRow += rowsPerSlab )
+    {
+    const int64_t slabRows = std::min( rowsPerSlab, numberOfRows - firstRow );
+    const torch::Tensor sourceSlab = source.narrow( 0, firstRow, slabRows );
+    torch::Tensor targetSlab = target.narrow( 0, firstRow, slabRows );
+    if( integerOutput )
+      {
+      if( !buffer.defined() )
+        {
+        std::vector< int64_t > bufferSize = sourceSlab.sizes().vec();
+        bufferSize[0] = rowsPerSlab;
+        buffer = torch::empty( bufferSize, torch::dtype( computeType ).device( target.device() ) );
+        }
+      torch::Tensor computed = buffer.narrow( 0, 0, slabRows );
+      at::add_out( computed, shift, sourceSlab, m_Scale );
+      computed.round_().clamp_( lower, upper );
+      targetSlab.copy_( computed );
+      }
+    else
+      {
+      at::add_out( targetSlab, shift, sourceSlab, m_Scale );
+      if( clamp )
+        {
+        targetSlab.clamp_( lower, upper );
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+TorchIntensityNormalizeImageFilter< TInputImage, TOutputImage, TMaskImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_Normalization: " << m_Normalization << std::endl
+    << indent << "m_WindowMinimum: " << m_WindowMinimum << std::endl
+    << indent << "m_WindowMaximum: " << m_WindowMaximum << std::endl
+    << indent << "m_LowerPercentile: " << m_LowerPercentile << std::endl
+    << indent << "m_UpperPercentile: " << m_UpperPercentile << std::endl
+    << indent << "m_OutputMinimum: " << m_OutputMinimum << std::endl
+    << indent << "m_OutputMaximum: " << m_OutputMaximum << std::endl
+    << indent << "m_Scale: " << m_Scale << std::endl
+    << indent << "m_Shift: " << m_Shift << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,213 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchLabelStatisticsImageFilter_h
+#define itkTorchLabelStatisticsImageFilter_h
+
+#include "itkHistogram.h"
+#include "itkImageToImageFilter.h"
+#include "itkTorchImage.h"
+
+#include <map>
+
+namespace itk
+{
+/** \class TorchLabelStatisticsImageFilter
+ *  \brief Compute the statistics of the intensities of a TorchImage within each label of a label TorchImage.
+ *
+ * For every label value present in the label image, the filter
+ * computes the count, sum, mean, variance and standard deviation,
+ * minimum and maximum of the intensities of its pixels, its bounding
+ * box and, if UseHistograms is on, a histogram of its intensities, as
+ * LabelStatisticsImageFilter does for an itk::Image.  As there, the
+ * variance is the unbiased estimate, the bounding box is given as
+ * [min0, max0, min1, max1, ...] in image indices, and intensities
+ * outside of the histogram bounds are counted in the end bins.
+ *
+ * Rather than updating the statistics of a label per pixel, the filter
+ * numbers the label values with torch::_unique and computes all
+ * statistics of all labels with a few whole-image reductions:
+ * bincount of the label numbers, weighted by the intensities and their
+ * squares, for the counts, sums and sums of squares; one sort of the
+ * intensities by label and value for the minima and maxima; and
+ * bincounts of the label numbers combined with the pixel coordinates
+ * or the histogram bins, for the bounding boxes and histograms.  Only
+ * the per-label results are copied from the device.
+ *
+ * The output is the intensity image, passed through.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TLabelImage >
+class ITK_TEMPLATE_EXPORT TorchLabelStatisticsImageFilter : public ImageToImageFilter< TInputImage, TInputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchLabelStatisticsImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchLabelStatisticsImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TInputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchLabelStatisticsImageFilter, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using LabelImageType = TLabelImage;
+  using LabelPixelType = typename LabelImageType::PixelType;
+  using RegionType = typename InputImageType::RegionType;
+  using IndexType = typename InputImageType::IndexType;
+  using IndexValueType = typename InputImageType::IndexValueType;
+  using SizeValueType = typename InputImageType::SizeValueType;
+  using RealType = double;
+  using BoundingBoxType = std::vector< IndexValueType >;
+  using HistogramType = Statistics::Histogram< RealType >;
+  using HistogramPointer = typename HistogramType::Pointer;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  static_assert( InputImageType::PixelDimension == 0, "TorchLabelStatisticsImageFilter requires scalar intensities" );
+  static_assert( LabelImageType::PixelDimension == 0 && std::is_integral< LabelPixelType >::value,
+    "TorchLabelStatisticsImageFilter requires scalar integer labels" );
+
+  /** The statistics of one label. */
+  struct LabelStatistics
+  {
+    SizeValueType m_Count = 0;
+    RealType m_Sum = 0.0;
+    RealType m_Mean = 0.0;
+    RealType m_Variance = 0.0;
+    RealType m_Sigma = 0.0;
+    RealType m_Minimum = NumericTraits< RealType >::max();
+    RealType m_Maximum = NumericTraits< RealType >::NonpositiveMin();
+    BoundingBoxType m_BoundingBox;
+    HistogramPointer m_Histogram;
+  };
+  using MapType = std::map< LabelPixelType, LabelStatistics >;
+  using ValidLabelValuesContainerType = std::vector< LabelPixelType >;
+
+  /** Set/Get the label image. */
+  itkSetInputMacro( LabelInput, LabelImageType );
+  itkGetInputMacro( LabelInput, LabelImageType );
+
+  /** Compute histograms of NumberOfBins bins between LowerBound and
+   * UpperBound.  Off by default; SetHistogramParameters() turns it on. */
+  itkSetMacro( UseHistograms, bool );
+  itkGetConstMacro( UseHistograms, bool );
+  itkBooleanMacro( UseHistograms );
+  void SetHistogramParameters( SizeValueType numberOfBins, RealType lowerBound, RealType upperBound );
+  itkGetConstMacro( NumberOfBins, SizeValueType );
+  itkGetConstMacro( LowerBound, RealType );
+  itkGetConstMacro( UpperBound, RealType );
+
+  /** The statistics of all labels of the last update. */
+  const MapType & GetLabelStatisticsMap() const
+    {
+    return m_LabelStatistics;
+    }
+
+  /** The label values present in the label image, in increasing
+   * order. */
+  ValidLabelValuesContainerType GetValidLabelValues() const;
+  SizeValueType GetNumberOfLabels() const
+    {
+    return static_cast< SizeValueType >( m_LabelStatistics.size() );
+    }
+  bool HasLabel( LabelPixelType label ) const
+    {
+    return m_LabelStatistics.find( label ) != m_LabelStatistics.end();
+    }
+
+  /** The statistics of one label.  Labels absent from the label image
+   * have a count of zero, a minimum of the largest RealType and a
+   * maximum of the smallest RealType. */
+  SizeValueType GetCount( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Count;
+    }
+  RealType GetSum( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Sum;
+    }
+  RealType GetMean( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Mean;
+    }
+  RealType GetVariance( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Variance;
+    }
+  RealType GetSigma( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Sigma;
+    }
+  RealType GetMinimum( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Minimum;
+    }
+  RealType GetMaximum( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Maximum;
+    }
+  const BoundingBoxType & GetBoundingBox( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_BoundingBox;
+    }
+  RegionType GetRegion( LabelPixelType label ) const;
+  HistogramPointer GetHistogram( LabelPixelType label ) const
+    {
+    return this->GetLabelStatistics( label ).m_Histogram;
+    }
+
+protected:
+  TorchLabelStatisticsImageFilter();
+  ~TorchLabelStatisticsImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The whole input and label images are needed. */
+  void GenerateInputRequestedRegion() override;
+
+  /** The whole output is produced. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** Pass the input through as the output. */
+  void AllocateOutputs() override;
+
+  void GenerateData() override;
+
+  const LabelStatistics & GetLabelStatistics( LabelPixelType label ) const;
+
+private:
+  bool m_UseHistograms;
+  SizeValueType m_NumberOfBins;
+  RealType m_LowerBound;
+  RealType m_UpperBound;
+
+  MapType m_LabelStatistics;
+  LabelStatistics m_AbsentLabelStatistics;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchLabelStatisticsImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,283 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchLabelStatisticsImageFilter_hxx
+#define itkTorchLabelStatisticsImageFilter_hxx
+
+#include "itkTorchLabelStatisticsImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+#include <cmath>
+
+namespace itk
+{
+
+template< typename TInputImage, typename TLabelImage >
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::TorchLabelStatisticsImageFilter()
+  : m_UseHistograms( false ),
+    m_NumberOfBins( 20 ),
+    m_LowerBound( NumericTraits< typename InputImageType::PixelType >::NonpositiveMin() ),
+    m_UpperBound( NumericTraits< typename InputImageType::PixelType >::max() )
+{
+  this->AddRequiredInputName( "LabelInput" );
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::SetHistogramParameters( SizeValueType numberOfBins, RealType lowerBound, RealType upperBound )
+{
+  m_NumberOfBins = numberOfBins;
+  m_LowerBound = lowerBound;
+  m_UpperBound = upperBound;
+  m_UseHistograms = true;
+  this->Modified();
+}
+
+template< typename TInputImage, typename TLabelImage >
+typename TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >::ValidLabelValuesContainerType
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::GetValidLabelValues() const
+{
+  ValidLabelValuesContainerType labels;
+  for( const auto & labelStatistics : m_LabelStatistics )
+    {
+    labels.push_back( labelStatistics.first );
+    }
+  return labels;
+}
+
+template< typename TInputImage, typename TLabelImage >
+const typename TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >::LabelStatistics &
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::GetLabelStatistics( LabelPixelType label ) const
+{
+  const auto labelStatistics = m_LabelStatistics.find( label );
+  return labelStatistics == m_LabelStatistics.end() ? m_AbsentLabelStatistics : labelStatistics->second;
+}
+
+template< typename TInputImage, typename TLabelImage >
+typename TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >::RegionType
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::GetRegion( LabelPixelType label ) const
+{
+  const BoundingBoxType & boundingBox = this->GetBoundingBox( label );
+  RegionType region;
+  if( boundingBox.empty() )
+    {
+    return region;
+    }
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    region.SetIndex( j, boundingBox[2 * j] );
+    region.SetSize( j, static_cast< SizeValueType >( boundingBox[2 * j + 1] - boundingBox[2 * j] + 1 ) );
+    }
+  return region;
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto *input = const_cast< InputImageType * >( this->GetInput() );
+  if( input != nullptr )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+  auto *labelInput = const_cast< LabelImageType * >( this->GetLabelInput() );
+  if( labelInput != nullptr )
+    {
+    labelInput->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::AllocateOutputs()
+{
+  this->GetOutput()->Graft( this->GetInput() );
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  this->AllocateOutputs();
+  m_LabelStatistics.clear();
+
+  const InputImageType *input = this->GetInput();
+  const LabelImageType *labelInput = this->GetLabelInput();
+  if( !input->GetTensor().defined() || !labelInput->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input and label TorchImages must be allocated" );
+    }
+  if( input->GetBufferedRegion().GetSize() != labelInput->GetBufferedRegion().GetSize() )
+    {
+    itkExceptionMacro( << "The label image has the buffered size " << labelInput->GetBufferedRegion().GetSize()
+      << " instead of " << input->GetBufferedRegion().GetSize() );
+    }
+  if( m_UseHistograms && !( m_NumberOfBins > 0 && m_LowerBound < m_UpperBound ) )
+    {
+    itkExceptionMacro( << "Histograms require at least one bin and LowerBound < UpperBound" );
+    }
+
+  const torch::Tensor & inputTensor = input->GetTensor();
+  const auto longOptions = torch::dtype( torch::kLong ).device( inputTensor.device() );
+  const torch::Tensor intensities = inputTensor.reshape( -1 ).to( torch::kDouble );
+  const int64_t numberOfPixels = intensities.numel();
+  if( numberOfPixels == 0 )
+    {
+    return;
+    }
+
+  // Number the label values 0 to K - 1; every statistic is then a
+  // reduction over the pixels grouped by their label number.
+  const auto uniqueLabels =
+    torch::_unique( labelInput->GetTensor().to( inputTensor.device() ).reshape( -1 ).to( torch::kLong ), true, true );
+  const torch::Tensor labelValues = std::get< 0 >( uniqueLabels );
+  const torch::Tensor labelNumbers = std::get< 1 >( uniqueLabels );
+  const int64_t numberOfLabels = labelValues.numel();
+
+  const torch::Tensor counts = torch::bincount( labelNumbers, torch::Tensor(), numberOfLabels );
+  const torch::Tensor sums = torch::bincount( labelNumbers, intensities, numberOfLabels );
+  const torch::Tensor sumsOfSquares = torch::bincount( labelNumbers, intensities * intensities, numberOfLabels );
+
+  // Sorting the pixels by intensity, and then by label number, makes
+  // the pixels of each label consecutive and in increasing intensity,
+  // so that the minimum and maximum are the ends of each run.
+  const torch::Tensor byIntensity = std::get< 1 >( intensities.sort() );
+  const torch::Tensor byLabel = std::get< 1 >(
+    ( labelNumbers.index_select( 0, byIntensity ) * numberOfPixels + torch::arange( numberOfPixels, longOptions ) ).sort() );
+  const torch::Tensor sorted = intensities.index_select( 0, byIntensity.index_select( 0, byLabel ) );
+  const torch::Tensor runEnds = counts.cumsum( 0 );
+  const torch::Tensor minima = sorted.index_select( 0, runEnds - counts );
+  const torch::Tensor maxima = sorted.index_select( 0, runEnds - 1 );
+
+  // The bounding boxes, along each dimension from the coordinates at
+  // which each label is present.
+  const torch::Tensor labelNumberImage = labelNumbers.view( inputTensor.sizes() );
+  std::vector< torch::Tensor > firstCoordinates( ImageDimension );
+  std::vector< torch::Tensor > lastCoordinates( ImageDimension );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const int64_t size = inputTensor.size( d );
+    std::vector< int64_t > shape( ImageDimension, 1 );
+    shape[d] = size;
+    const torch::Tensor coordinates = torch::arange( size, longOptions );
+    const torch::Tensor absent = torch::bincount( ( labelNumberImage * size + coordinates.view( shape ) ).reshape( -1 ),
+      torch::Tensor(), numberOfLabels * size ).view( { numberOfLabels, size } ).eq( 0 );
+    const torch::Tensor labelCoordinates = coordinates.expand( { numberOfLabels, size } );
+    firstCoordinates[d] = std::get< 0 >( labelCoordinates.masked_fill( absent, size ).min( 1 ) ).cpu();
+    lastCoordinates[d] = std::get< 0 >( labelCoordinates.masked_fill( absent, -1 ).max( 1 ) ).cpu();
+    }
+
+  torch::Tensor histograms;
+  if( m_UseHistograms )
+    {
+    const int64_t numberOfBins = m_NumberOfBins;
+    const torch::Tensor bins = ( ( intensities - m_LowerBound ) * ( numberOfBins / ( m_UpperBound - m_LowerBound ) ) )
+      .floor_().clamp_( 0, numberOfBins - 1 ).to( torch::kLong );
+    histograms = torch::bincount( labelNumbers * numberOfBins + bins, torch::Tensor(), numberOfLabels * numberOfBins )
+      .view( { numberOfLabels, numberOfBins } ).cpu();
+    }
+
+  // Only the per-label results leave the device.
+  const torch::Tensor labelValuesCPU = labelValues.cpu();
+  const torch::Tensor countsCPU = counts.cpu();
+  const torch::Tensor sumsCPU = sums.cpu();
+  const torch::Tensor sumsOfSquaresCPU = sumsOfSquares.cpu();
+  const torch::Tensor minimaCPU = minima.cpu();
+  const torch::Tensor maximaCPU = maxima.cpu();
+  const IndexType & bufferedIndex = input->GetBufferedRegion().GetIndex();
+  for( int64_t k = 0; k < numberOfLabels; ++k )
+    {
+    LabelStatistics labelStatistics;
+    labelStatistics.m_Count = static_cast< SizeValueType >( countsCPU[k].item< int64_t >() );
+    labelStatistics.m_Sum = sumsCPU[k].item< double >();
+    labelStatistics.m_Minimum = minimaCPU[k].item< double >();
+    labelStatistics.m_Maximum = maximaCPU[k].item< double >();
+    const double count = static_cast< double >( labelStatistics.m_Count );
+    labelStatistics.m_Mean = labelStatistics.m_Sum / count;
+    if( labelStatistics.m_Count > 1 )
+      {
+      labelStatistics.m_Variance =
+        ( sumsOfSquaresCPU[k].item< double >() - labelStatistics.m_Sum * labelStatistics.m_Sum / count ) / ( count - 1.0 );
+      }
+    labelStatistics.m_Sigma = std::sqrt( labelStatistics.m_Variance );
+    labelStatistics.m_BoundingBox.resize( 2 * ImageDimension );
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      const unsigned int d = ImageDimension - 1 - j;
+      labelStatistics.m_BoundingBox[2 * j] = bufferedIndex[j] + firstCoordinates[d][k].item< int64_t >();
+      labelStatistics.m_BoundingBox[2 * j + 1] = bufferedIndex[j] + lastCoordinates[d][k].item< int64_t >();
+      }
+    if( m_UseHistograms )
+      {
+      typename HistogramType::SizeType histogramSize( 1 );
+      histogramSize[0] = m_NumberOfBins;
+      typename HistogramType::MeasurementVectorType lowerBound( 1 );
+      lowerBound[0] = m_LowerBound;
+      typename HistogramType::MeasurementVectorType upperBound( 1 );
+      upperBound[0] = m_UpperBound;
+      labelStatistics.m_Histogram = HistogramType::New();
+      labelStatistics.m_Histogram->SetMeasurementVectorSize( 1 );
+      labelStatistics.m_Histogram->SetClipBinsAtEnds( false );
+      labelStatistics.m_Histogram->Initialize( histogramSize, lowerBound, upperBound );
+      const auto histogramAccessor = histograms.accessor< int64_t, 2 >();
+      for( SizeValueType b = 0; b < m_NumberOfBins; ++b )
+        {
+        labelStatistics.m_Histogram->SetFrequency( b, histogramAccessor[k][b] );
+        }
+      }
+    m_LabelStatistics.emplace( static_cast< LabelPixelType >( labelValuesCPU[k].item< int64_t >() ),
+      std::move( labelStatistics ) );
+    }
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+TorchLabelStatisticsImageFilter< TInputImage, TLabelImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_UseHistograms: " << m_UseHistograms << std::endl
+    << indent << "m_NumberOfBins: " << m_NumberOfBins << std::endl
+    << indent << "m_LowerBound: " << m_LowerBound << std::endl
+    << indent << "m_UpperBound: " << m_UpperBound << std::endl
+    << indent << "Number of labels: " << m_LabelStatistics.size() << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchMorphologyImageFilterBase_h
+#define itkTorchMorphologyImageFilterBase_h
+
+#include "itkImageToImageFilter.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchMorphologyImageFilterBase
+ *  \brief Base class for filters that dilate and erode a scalar TorchImage with a flat structuring element.
+ *
+ * The structuring element is a box or a ball of Radius pixels, or, with
+ * UsePhysicalRadius, of PhysicalRadius in the units of the spacing of
+ * the input, rounded down to whole pixels.  The ball is that of
+ * FlatStructuringElement::Ball(): the pixels at offsets o with
+ * sum_i ( o_i / ( r_i + 0.5 ) )^2 <= 1.
+ *
+ * Both elements are decomposed into lines along single tensor
+ * dimensions: the box into one line per dimension, applied in turn,
+ * and the ball into one line along x for each of its (y, z) offsets,
+ * with the lines of equal lengths computed once and the maximum (or
+ * minimum) taken over their shifts.  Short lines are one at::max_poolNd
+ * call; longer lines, and lines over integer tensors, are iterated as
+ * ceil(log2(length)) maxima of the tensor and a shifted copy of itself,
+ * each doubling the covered length, so that large radii cost
+ * logarithmically in the radius.
+ *
+ * Pixels outside of the image do not take part in the maxima and
+ * minima, which is the boundary condition of ITK's grayscale
+ * morphology filters.
+ *
+ * The output has the buffered region, device and component layout of
+ * the input.
+ *
+ * \sa TorchGrayscaleMorphologyImageFilter
+ * \sa TorchBinaryMorphologyImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchMorphologyImageFilterBase : public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchMorphologyImageFilterBase );
+
+  /** Standard class type aliases */
+  using Self = TorchMorphologyImageFilterBase;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchMorphologyImageFilterBase, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using RadiusType = typename InputImageType::SizeType;
+  using RadiusValueType = typename InputImageType::SizeValueType;
+  using PhysicalRadiusType = FixedArray< double, InputImageType::ImageDimension >;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  static_assert( ImageDimension >= 1 && ImageDimension <= 3, "ATen pools only 1, 2 and 3 dimensional images" );
+  static_assert( InputImageType::PixelDimension == 0 && OutputImageType::PixelDimension == 0,
+    "TorchMorphologyImageFilterBase requires scalar pixels" );
+
+  enum StructuringElementType { itkBox, itkBall };
+  enum OperationType { itkDilate, itkErode, itkOpen, itkClose };
+
+  /** The morphological operation.  Defaults to itkDilate. */
+  itkSetMacro( Operation, OperationType );
+  itkGetConstMacro( Operation, OperationType );
+
+  /** The shape of the structuring element.  Defaults to itkBox. */
+  itkSetMacro( StructuringElement, StructuringElementType );
+  itkGetConstMacro( StructuringElement, StructuringElementType );
+
+  /** The radius of the structuring element in pixels.  Defaults to 1. */
+  itkSetMacro( Radius, RadiusType );
+  itkGetConstReferenceMacro( Radius, RadiusType );
+  void SetRadius( RadiusValueType radius )
+    {
+    RadiusType radiusArray;
+    radiusArray.Fill( radius );
+    this->SetRadius( radiusArray );
+    }
+
+  /** The radius of the structuring element in physical units, used
+   * instead of Radius with UsePhysicalRadius.  Defaults to 1. */
+  itkSetMacro( PhysicalRadius, PhysicalRadiusType );
+  itkGetConstReferenceMacro( PhysicalRadius, PhysicalRadiusType );
+  itkSetMacro( UsePhysicalRadius, bool );
+  itkGetConstMacro( UsePhysicalRadius, bool );
+  itkBooleanMacro( UsePhysicalRadius );
+
+  /** The radius in pixels of the structuring element of the next
+   * update, from either Radius or PhysicalRadius and the spacing of the
+   * input. */
+  RadiusType GetPixelRadius() const;
+
+protected:
+  TorchMorphologyImageFilterBase();
+  ~TorchMorphologyImageFilterBase() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion() override;
+
+  /** The whole output is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** Dilate, or erode, a tensor of the index sizes in tensor order by
+   * the structuring element.  Pixels outside of the tensor have the
+   * value outsideValue, which for the dilation (erosion) of an image is
+   * the lowest (highest) value of its type. */
+  torch::Tensor Morph( const torch::Tensor & tensor, bool dilate, const torch::Scalar & outsideValue ) const;
+
+  /** Pad, or crop with a negative padding, a tensor of the index sizes
+   * in tensor order by the pixel radius on both sides of every
+   * dimension. */
+  torch::Tensor PadByRadius( const torch::Tensor & tensor, int64_t sign, const torch::Scalar & value ) const;
+
+  /** Set the output tensor from a tensor of the index sizes in tensor
+   * order. */
+  void SetOutputTensor( const torch::Tensor & tensor );
+
+  /** Dilate, or erode, along tensor dimension dimension by a line of
+   * 2 * radius + 1 pixels. */
+  static torch::Tensor MorphLine( const torch::Tensor & tensor, int64_t dimension, int64_t radius, bool dilate,
+    const torch::Scalar & outsideValue );
+
+private:
+  OperationType m_Operation;
+  StructuringElementType m_StructuringElement;
+  RadiusType m_Radius;
+  PhysicalRadiusType m_PhysicalRadius;
+  bool m_UsePhysicalRadius;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchMorphologyImageFilterBase.hxx"
+#endif
+
+#endif
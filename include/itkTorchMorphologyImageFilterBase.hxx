@@ -0,0 +1,287 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchMorphologyImageFilterBase_hxx
+#define itkTorchMorphologyImageFilterBase_hxx
+
+#include "itkTorchMorphologyImageFilterBase.h"
+
+#include <cmath>
+#include <map>
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::TorchMorphologyImageFilterBase()
+  : m_Operation( itkDilate ),
+    m_StructuringElement( itkBox ),
+    m_UsePhysicalRadius( false )
+{
+  m_Radius.Fill( 1 );
+  m_PhysicalRadius.Fill( 1.0 );
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename TorchMorphologyImageFilterBase< TInputImage, TOutputImage >::RadiusType
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::GetPixelRadius() const
+{
+  if( !m_UsePhysicalRadius )
+    {
+    return m_Radius;
+    }
+  const typename InputImageType::SpacingType & spacing = this->GetInput()->GetSpacing();
+  RadiusType radius;
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    // Allow for rounding errors in radii that are multiples of the
+    // spacing.
+    radius[j] = static_cast< RadiusValueType >( std::max( 0.0, std::floor( m_PhysicalRadius[j] / spacing[j] + 1e-6 ) ) );
+    }
+  return radius;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto *input = const_cast< InputImageType * >( this->GetInput() );
+  if( input != nullptr )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::MorphLine( const torch::Tensor & tensor, int64_t dimension, int64_t radius, bool dilate,
+  const torch::Scalar & outsideValue )
+{
+  if( radius == 0 )
+    {
+    return tensor;
+    }
+  const int64_t dimensions = tensor.dim();
+  const int64_t lineLength = 2 * radius + 1;
+
+  // Short lines over floating point tensors are one pooling, whose
+  // implicit padding takes no part in the maxima.
+  constexpr int64_t maximumPoolingRadius = 3;
+  if( tensor.is_floating_point() && radius <= maximumPoolingRadius )
+    {
+    std::vector< int64_t > kernelSize( dimensions, 1 );
+    kernelSize[dimension] = lineLength;
+    const std::vector< int64_t > stride( dimensions, 1 );
+    std::vector< int64_t > padding( dimensions, 0 );
+    padding[dimension] = radius;
+    const torch::Tensor batch = ( dilate ? tensor : -tensor ).unsqueeze( 0 ).unsqueeze( 0 );
+    torch::Tensor pooled;
+    switch( dimensions )
+      {
+      case 1:
+        pooled = at::max_pool1d( batch, kernelSize, stride, padding );
+        break;
+      case 2:
+        pooled = at::max_pool2d( batch, kernelSize, stride, padding );
+        break;
+      default:
+        pooled = at::max_pool3d( batch, kernelSize, stride, padding );
+        break;
+      }
+    pooled = pooled.squeeze( 0 ).squeeze( 0 );
+    return dilate ? pooled : pooled.neg_();
+    }
+
+  // Otherwise the line is built up from lines of half its length or
+  // less: the maximum of a line of n pixels and its shift by s <= n
+  // pixels is a line of n + s pixels.
+  std::vector< int64_t > padding( 2 * dimensions, 0 );
+  padding[2 * ( dimensions - 1 - dimension )] = radius;
+  padding[2 * ( dimensions - 1 - dimension ) + 1] = radius;
+  torch::Tensor result = at::constant_pad_nd( tensor, padding, outsideValue );
+  int64_t length = result.size( dimension );
+  for( int64_t covered = 1; covered < lineLength; )
+    {
+    const int64_t step = std::min( covered, lineLength - covered );
+    length -= step;
+    const torch::Tensor first = result.narrow( dimension, 0, length );
+    const torch::Tensor shifted = result.narrow( dimension, step, length );
+    result = dilate ? torch::max( first, shifted ) : torch::min( first, shifted );
+    covered += step;
+    }
+  return result;
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::Morph( const torch::Tensor & tensor, bool dilate, const torch::Scalar & outsideValue ) const
+{
+  const RadiusType pixelRadius = this->GetPixelRadius();
+  std::vector< int64_t > radius( ImageDimension );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    radius[d] = pixelRadius[ImageDimension - 1 - d];
+    }
+
+  if( m_StructuringElement == itkBox )
+    {
+    torch::Tensor result = tensor;
+    for( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      result = Self::MorphLine( result, d, radius[d], dilate, outsideValue );
+      }
+    return result;
+    }
+
+  // The ball is the union of the lines along the last tensor dimension,
+  // x, that it contains at each of its offsets in the other dimensions.
+  constexpr unsigned int lineDimension = ImageDimension - 1;
+  std::vector< int64_t > padding( 2 * ImageDimension, 0 );
+  for( unsigned int d = 0; d < lineDimension; ++d )
+    {
+    padding[2 * ( ImageDimension - 1 - d )] = radius[d];
+    padding[2 * ( ImageDimension - 1 - d ) + 1] = radius[d];
+    }
+  const torch::Tensor padded = at::constant_pad_nd( tensor, padding, outsideValue );
+  const auto squaredNormalized = []( int64_t offset, int64_t r )
+    {
+    const double normalized = offset / ( r + 0.5 );
+    return normalized * normalized;
+    };
+
+  std::map< int64_t, torch::Tensor > lines;
+  torch::Tensor result;
+  std::vector< int64_t > offset( lineDimension );
+  for( unsigned int d = 0; d < lineDimension; ++d )
+    {
+    offset[d] = -radius[d];
+    }
+  bool more = true;
+  while( more )
+    {
+    double distance = 0.0;
+    for( unsigned int d = 0; d < lineDimension; ++d )
+      {
+      distance += squaredNormalized( offset[d], radius[d] );
+      }
+    if( distance <= 1.0 )
+      {
+      int64_t halfLength = 0;
+      while( halfLength < radius[lineDimension]
+        && distance + squaredNormalized( halfLength + 1, radius[lineDimension] ) <= 1.0 )
+        {
+        ++halfLength;
+        }
+      auto line = lines.find( halfLength );
+      if( line == lines.end() )
+        {
+        line = lines.emplace( halfLength,
+          Self::MorphLine( padded, lineDimension, halfLength, dilate, outsideValue ) ).first;
+        }
+      torch::Tensor shifted = line->second;
+      for( unsigned int d = 0; d < lineDimension; ++d )
+        {
+        shifted = shifted.narrow( d, radius[d] + offset[d], tensor.size( d ) );
+        }
+      if( !result.defined() )
+        {
+        result = shifted;
+        }
+      else
+        {
+        result = dilate ? torch::max( result, shifted ) : torch::min( result, shifted );
+        }
+      }
+
+    // The next offset, with the last dimension varying fastest.
+    more = false;
+    for( unsigned int d = lineDimension; d-- > 0; )
+      {
+      if( offset[d] < radius[d] )
+        {
+        ++offset[d];
+        more = true;
+        break;
+        }
+      offset[d] = -radius[d];
+      }
+    }
+  return result;
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::PadByRadius( const torch::Tensor & tensor, int64_t sign, const torch::Scalar & value ) const
+{
+  const RadiusType pixelRadius = this->GetPixelRadius();
+  // constant_pad_nd() lists the paddings of the last dimension first,
+  // which is index dimension 0.
+  std::vector< int64_t > padding;
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    padding.push_back( sign * static_cast< int64_t >( pixelRadius[j] ) );
+    padding.push_back( sign * static_cast< int64_t >( pixelRadius[j] ) );
+    }
+  return at::constant_pad_nd( tensor, padding, value );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::SetOutputTensor( const torch::Tensor & tensor )
+{
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  output->CopyTensorInformation( input );
+  output->SetBufferedRegion( input->GetBufferedRegion() );
+  output->SetTensor( tensor.to( OutputImageType::TorchValueType ).contiguous() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchMorphologyImageFilterBase< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_Operation: " << m_Operation << std::endl
+    << indent << "m_StructuringElement: " << m_StructuringElement << std::endl
+    << indent << "m_Radius: " << m_Radius << std::endl
+    << indent << "m_PhysicalRadius: " << m_PhysicalRadius << std::endl
+    << indent << "m_UsePhysicalRadius: " << m_UsePhysicalRadius << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
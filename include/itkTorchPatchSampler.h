@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchPatchSampler_h
+#define itkTorchPatchSampler_h
+
+#include "itkObject.h"
+#include "itkTorchImage.h"
+
+#include <random>
+
+namespace itk
+{
+/** \class TorchPatchSampler
+ *  \brief Cut many patches of a TorchImage, and of its label image, into one stacked tensor.
+ *
+ * Sample() returns the patches as one tensor whose first dimension
+ * indexes the patches and whose remaining dimensions are those of a
+ * TorchImage of PatchSize, in the component layout of the image, as
+ * for TorchImageBatch.  The patch starts are chosen by:
+ *
+ * - itkGridSampling: a regular grid, every Stride pixels, of the
+ *   patches that fit in the image.
+ * - itkRandomSampling: NumberOfPatches starts drawn uniformly among
+ *   those whose patch fits in the image.
+ * - itkLabelBalancedSampling: NumberOfPatches patches centered, as far
+ *   as they fit in the image, on pixels drawn uniformly among the
+ *   nonzero pixels of the label image for a fraction PositiveFraction
+ *   of them, and among its zero pixels for the rest.  Positive patches
+ *   come first.  If the label image has no pixels of one kind, all
+ *   patches are of the other kind.
+ *
+ * The patches are gathered with a single indexing operation from a
+ * view of the image as all of its patches, made with unfold, so that
+ * no per-patch copies or index arithmetic are needed, also on a CUDA
+ * device.  If a label image is set, the same patches of it are
+ * available from GetLabelPatches().  The first pixel of each patch is
+ * available as an index of the image and as a physical point.
+ *
+ * The positions of the nonzero and zero pixels of the label image are
+ * found once and kept until the label image is modified; call
+ * Modified() on the label image after writing to its tensor.  For
+ * data loaders with many workers, give each sampler its own Seed.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TImage, typename TLabelImage = TorchImage< unsigned char, TImage::ImageDimension > >
+class ITK_TEMPLATE_EXPORT TorchPatchSampler : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchPatchSampler );
+
+  /** Standard class type aliases */
+  using Self = TorchPatchSampler;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchPatchSampler, Object );
+
+  using ImageType = TImage;
+  using LabelImageType = TLabelImage;
+  using SizeType = typename ImageType::SizeType;
+  using SizeValueType = typename ImageType::SizeValueType;
+  using IndexType = typename ImageType::IndexType;
+  using PointType = typename ImageType::PointType;
+
+  static constexpr unsigned int ImageDimension = ImageType::ImageDimension;
+
+  static_assert( LabelImageType::ImageDimension == ImageDimension && LabelImageType::PixelDimension == 0,
+    "TorchPatchSampler requires a scalar label image of the dimension of the image" );
+
+  enum SamplingType { itkGridSampling, itkRandomSampling, itkLabelBalancedSampling };
+
+  /** The image to cut patches from. */
+  itkSetConstObjectMacro( Image, ImageType );
+  itkGetConstObjectMacro( Image, ImageType );
+
+  /** The label image, required by itkLabelBalancedSampling and
+   * optional otherwise.  It must have the buffered size of the image. */
+  itkSetConstObjectMacro( LabelImage, LabelImageType );
+  itkGetConstObjectMacro( LabelImage, LabelImageType );
+
+  /** The size of the patches. */
+  itkSetMacro( PatchSize, SizeType );
+  itkGetConstReferenceMacro( PatchSize, SizeType );
+
+  /** The sampling.  Defaults to itkGridSampling. */
+  itkSetMacro( Sampling, SamplingType );
+  itkGetConstMacro( Sampling, SamplingType );
+
+  /** The distance between the starts of grid patches.  A stride of
+   * zero in a dimension, the default, is the patch size. */
+  itkSetMacro( Stride, SizeType );
+  itkGetConstReferenceMacro( Stride, SizeType );
+
+  /** The number of random and label-balanced patches.  Defaults to 1. */
+  itkSetMacro( NumberOfPatches, SizeValueType );
+  itkGetConstMacro( NumberOfPatches, SizeValueType );
+
+  /** The fraction of label-balanced patches centered on nonzero labels.
+   * Defaults to 0.5. */
+  itkSetClampMacro( PositiveFraction, double, 0.0, 1.0 );
+  itkGetConstMacro( PositiveFraction, double );
+
+  /** Seed the random generator. */
+  void SetSeed( uint64_t seed );
+  itkGetConstMacro( Seed, uint64_t );
+
+  /** Cut the patches of the image, and of the label image if set, and
+   * return those of the image. */
+  torch::Tensor Sample();
+
+  /** The patches of the label image cut by the last Sample(). */
+  const torch::Tensor & GetLabelPatches() const
+    {
+    return m_LabelPatches;
+    }
+
+  /** The first pixel of each patch of the last Sample(). */
+  const std::vector< IndexType > & GetPatchIndices() const
+    {
+    return m_PatchIndices;
+    }
+  const std::vector< PointType > & GetPatchOrigins() const
+    {
+    return m_PatchOrigins;
+    }
+
+protected:
+  TorchPatchSampler();
+  ~TorchPatchSampler() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The patch starts, as rows of tensor coordinates of the buffered
+   * region, in the order of the tensor dimensions. */
+  torch::Tensor ComputeGridStarts( const std::vector< int64_t > & imageSize, const std::vector< int64_t > & patchSize ) const;
+  torch::Tensor ComputeRandomStarts( const std::vector< int64_t > & imageSize, const std::vector< int64_t > & patchSize,
+    SizeValueType numberOfPatches );
+  torch::Tensor ComputeLabelBalancedStarts( const std::vector< int64_t > & imageSize,
+    const std::vector< int64_t > & patchSize );
+
+  /** Gather the patches at the given starts of a tensor with
+   * leadingDimensions component dimensions before the spatial ones,
+   * into a tensor of sizes [N, components..., patch...]. */
+  static torch::Tensor GatherPatches( const torch::Tensor & tensor, int64_t leadingDimensions,
+    const std::vector< int64_t > & patchSize, const torch::Tensor & starts );
+
+private:
+  typename ImageType::ConstPointer m_Image;
+  typename LabelImageType::ConstPointer m_LabelImage;
+  SizeType m_PatchSize;
+  SamplingType m_Sampling;
+  SizeType m_Stride;
+  SizeValueType m_NumberOfPatches;
+  double m_PositiveFraction;
+  uint64_t m_Seed;
+  std::mt19937_64 m_Generator;
+
+  // The coordinates of the nonzero and zero labels, as of the
+  // modification time m_LabelCoordinatesTime of m_LabelCoordinatesImage.
+  const LabelImageType *m_LabelCoordinatesImage;
+  ModifiedTimeType m_LabelCoordinatesTime;
+  torch::Tensor m_PositiveCoordinates;
+  torch::Tensor m_NegativeCoordinates;
+
+  torch::Tensor m_LabelPatches;
+  std::vector< IndexType > m_PatchIndices;
+  std::vector< PointType > m_PatchOrigins;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchPatchSampler.hxx"
+#endif
+
+#endif
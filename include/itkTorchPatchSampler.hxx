@@ -0,0 +1,287 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchPatchSampler_hxx
+#define itkTorchPatchSampler_hxx
+
+#include "itkTorchPatchSampler.h"
+
+#include <cmath>
+
+namespace itk
+{
+
+template< typename TImage, typename TLabelImage >
+TorchPatchSampler< TImage, TLabelImage >
+::TorchPatchSampler()
+  : m_Sampling( itkGridSampling ),
+    m_NumberOfPatches( 1 ),
+    m_PositiveFraction( 0.5 ),
+    m_Seed( 0 ),
+    m_Generator( 0 ),
+    m_LabelCoordinatesImage( nullptr ),
+    m_LabelCoordinatesTime( 0 )
+{
+  m_PatchSize.Fill( 0 );
+  m_Stride.Fill( 0 );
+}
+
+template< typename TImage, typename TLabelImage >
+void
+TorchPatchSampler< TImage, TLabelImage >
+::SetSeed( uint64_t seed )
+{
+  m_Seed = seed;
+  m_Generator.seed( seed );
+  this->Modified();
+}
+
+template< typename TImage, typename TLabelImage >
+torch::Tensor
+TorchPatchSampler< TImage, TLabelImage >
+::ComputeGridStarts( const std::vector< int64_t > & imageSize, const std::vector< int64_t > & patchSize ) const
+{
+  // The starts along each dimension, combined with the last dimension
+  // varying fastest.
+  torch::Tensor starts = torch::zeros( { 1, 0 }, torch::kLong );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const SizeValueType requestedStride = m_Stride[ImageDimension - 1 - d];
+    const int64_t stride = requestedStride == 0 ? patchSize[d] : static_cast< int64_t >( requestedStride );
+    const torch::Tensor dimensionStarts = torch::arange( 0, imageSize[d] - patchSize[d] + 1, stride, torch::kLong );
+    const int64_t previousCount = starts.size( 0 );
+    const int64_t count = dimensionStarts.size( 0 );
+    starts = torch::cat( { starts.repeat_interleave( count, 0 ),
+      dimensionStarts.repeat( previousCount ).unsqueeze( 1 ) }, 1 );
+    }
+  return starts;
+}
+
+template< typename TImage, typename TLabelImage >
+torch::Tensor
+TorchPatchSampler< TImage, TLabelImage >
+::ComputeRandomStarts( const std::vector< int64_t > & imageSize, const std::vector< int64_t > & patchSize,
+  SizeValueType numberOfPatches )
+{
+  torch::Tensor starts = torch::empty( { static_cast< int64_t >( numberOfPatches ), ImageDimension }, torch::kLong );
+  auto startsAccessor = starts.accessor< int64_t, 2 >();
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    std::uniform_int_distribution< int64_t > distribution( 0, imageSize[d] - patchSize[d] );
+    for( SizeValueType i = 0; i < numberOfPatches; ++i )
+      {
+      startsAccessor[i][d] = distribution( m_Generator );
+      }
+    }
+  return starts;
+}
+
+template< typename TImage, typename TLabelImage >
+torch::Tensor
+TorchPatchSampler< TImage, TLabelImage >
+::ComputeLabelBalancedStarts( const std::vector< int64_t > & imageSize, const std::vector< int64_t > & patchSize )
+{
+  const LabelImageType *labelImage = m_LabelImage.GetPointer();
+  if( m_LabelCoordinatesImage != labelImage || m_LabelCoordinatesTime != labelImage->GetMTime() )
+    {
+    const torch::Tensor positive = labelImage->GetTensor().ne( 0 );
+    m_PositiveCoordinates = positive.nonzero().cpu();
+    m_NegativeCoordinates = positive.logical_not().nonzero().cpu();
+    m_LabelCoordinatesImage = labelImage;
+    m_LabelCoordinatesTime = labelImage->GetMTime();
+    }
+
+  SizeValueType numberOfPositives = std::llround( m_NumberOfPatches * m_PositiveFraction );
+  if( m_PositiveCoordinates.size( 0 ) == 0 )
+    {
+    numberOfPositives = 0;
+    }
+  else if( m_NegativeCoordinates.size( 0 ) == 0 )
+    {
+    numberOfPositives = m_NumberOfPatches;
+    }
+  const auto drawCenters = [this]( const torch::Tensor & coordinates, SizeValueType count )
+    {
+    torch::Tensor rows = torch::empty( { static_cast< int64_t >( count ) }, torch::kLong );
+    if( count > 0 )
+      {
+      std::uniform_int_distribution< int64_t > distribution( 0, coordinates.size( 0 ) - 1 );
+      auto rowsAccessor = rows.accessor< int64_t, 1 >();
+      for( SizeValueType i = 0; i < count; ++i )
+        {
+        rowsAccessor[i] = distribution( m_Generator );
+        }
+      }
+    return coordinates.index_select( 0, rows );
+    };
+  const torch::Tensor centers = torch::cat( { drawCenters( m_PositiveCoordinates, numberOfPositives ),
+    drawCenters( m_NegativeCoordinates, m_NumberOfPatches - numberOfPositives ) } );
+
+  // Center the patches on the drawn pixels, as far as they fit.
+  const torch::Tensor halfPatch = torch::tensor( patchSize, torch::kLong ).floor_divide( 2 );
+  const torch::Tensor lastStart = torch::tensor( imageSize, torch::kLong ) - torch::tensor( patchSize, torch::kLong );
+  return torch::min( ( centers - halfPatch ).clamp_min( 0 ), lastStart );
+}
+
+template< typename TImage, typename TLabelImage >
+torch::Tensor
+TorchPatchSampler< TImage, TLabelImage >
+::GatherPatches( const torch::Tensor & tensor, int64_t leadingDimensions, const std::vector< int64_t > & patchSize,
+  const torch::Tensor & starts )
+{
+  // A view of all patches, of sizes [components..., starts..., patch...].
+  torch::Tensor patches = tensor;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    patches = patches.unfold( leadingDimensions + d, patchSize[d], 1 );
+    }
+  std::vector< torch::indexing::TensorIndex > indices( leadingDimensions, torch::indexing::Slice() );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    indices.emplace_back( starts.select( 1, d ) );
+    }
+  // Sizes [components..., N, patch...], with the patch number moved to
+  // the front.
+  patches = patches.index( indices );
+  std::vector< int64_t > permutation{ leadingDimensions };
+  for( int64_t d = 0; d < patches.dim(); ++d )
+    {
+    if( d != leadingDimensions )
+      {
+      permutation.push_back( d );
+      }
+    }
+  return patches.permute( permutation );
+}
+
+template< typename TImage, typename TLabelImage >
+torch::Tensor
+TorchPatchSampler< TImage, TLabelImage >
+::Sample()
+{
+  if( m_Image.IsNull() || !m_Image->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "Sample() requires an allocated image" );
+    }
+  const typename ImageType::RegionType & region = m_Image->GetBufferedRegion();
+  std::vector< int64_t > imageSize;
+  std::vector< int64_t > patchSize;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const unsigned int i = ImageDimension - 1 - d;
+    if( m_PatchSize[i] == 0 || m_PatchSize[i] > region.GetSize( i ) )
+      {
+      itkExceptionMacro( << "PatchSize " << m_PatchSize << " does not fit in the buffered size " << region.GetSize()
+        << " of the image" );
+      }
+    imageSize.push_back( region.GetSize( i ) );
+    patchSize.push_back( m_PatchSize[i] );
+    }
+  if( m_LabelImage.IsNotNull() && m_LabelImage->GetBufferedRegion().GetSize() != region.GetSize() )
+    {
+    itkExceptionMacro( << "The label image has the buffered size " << m_LabelImage->GetBufferedRegion().GetSize()
+      << " instead of " << region.GetSize() );
+    }
+
+  torch::Tensor starts;
+  switch( m_Sampling )
+    {
+    case itkGridSampling:
+      starts = this->ComputeGridStarts( imageSize, patchSize );
+      break;
+    case itkRandomSampling:
+      starts = this->ComputeRandomStarts( imageSize, patchSize, m_NumberOfPatches );
+      break;
+    case itkLabelBalancedSampling:
+      if( m_LabelImage.IsNull() || !m_LabelImage->GetTensor().defined() )
+        {
+        itkExceptionMacro( << "itkLabelBalancedSampling requires an allocated label image" );
+        }
+      starts = this->ComputeLabelBalancedStarts( imageSize, patchSize );
+      break;
+    }
+
+  const auto startsAccessor = starts.accessor< int64_t, 2 >();
+  m_PatchIndices.clear();
+  m_PatchOrigins.clear();
+  for( int64_t p = 0; p < starts.size( 0 ); ++p )
+    {
+    IndexType index = region.GetIndex();
+    for( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      index[ImageDimension - 1 - d] += startsAccessor[p][d];
+      }
+    PointType origin;
+    m_Image->TransformIndexToPhysicalPoint( index, origin );
+    m_PatchIndices.push_back( index );
+    m_PatchOrigins.push_back( origin );
+    }
+
+  // Gather with the components first, and move them back after the
+  // patch dimensions for itkComponentsLast.
+  const torch::Tensor tensor = ImageType::PermuteComponentLayout( m_Image->GetTensor(), m_Image->GetComponentLayout(),
+    ImageType::itkComponentsFirst );
+  torch::Tensor patches =
+    Self::GatherPatches( tensor, ImageType::PixelDimension, patchSize, starts.to( tensor.device() ) );
+  if( m_Image->GetComponentLayout() == ImageType::itkComponentsLast && ImageType::PixelDimension > 0 )
+    {
+    std::vector< int64_t > permutation{ 0 };
+    for( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      permutation.push_back( 1 + ImageType::PixelDimension + d );
+      }
+    for( unsigned int c = 0; c < ImageType::PixelDimension; ++c )
+      {
+      permutation.push_back( 1 + c );
+      }
+    patches = patches.permute( permutation );
+    }
+
+  if( m_LabelImage.IsNotNull() && m_LabelImage->GetTensor().defined() )
+    {
+    const torch::Tensor & labelTensor = m_LabelImage->GetTensor();
+    m_LabelPatches = Self::GatherPatches( labelTensor, 0, patchSize, starts.to( labelTensor.device() ) ).contiguous();
+    }
+  else
+    {
+    m_LabelPatches = torch::Tensor();
+    }
+  return patches.contiguous();
+}
+
+template< typename TImage, typename TLabelImage >
+void
+TorchPatchSampler< TImage, TLabelImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  itkPrintSelfObjectMacro( Image );
+  itkPrintSelfObjectMacro( LabelImage );
+  os
+    << indent << "m_PatchSize: " << m_PatchSize << std::endl
+    << indent << "m_Sampling: " << m_Sampling << std::endl
+    << indent << "m_Stride: " << m_Stride << std::endl
+    << indent << "m_NumberOfPatches: " << m_NumberOfPatches << std::endl
+    << indent << "m_PositiveFraction: " << m_PositiveFraction << std::endl
+    << indent << "m_Seed: " << m_Seed << std::endl
+    << indent << "m_PatchIndices: " << m_PatchIndices.size() << " patches" << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
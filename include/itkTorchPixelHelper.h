@@ -18,10 +18,14 @@
 #ifndef itkTorchPixelHelper_h
 #define itkTorchPixelHelper_h
 
+#include <functional>
 #include <torch/torch.h>
+#include "itkTorchInstrumentation.h"
 
 namespace itk
 {
+template< typename TImage > class TorchImageRegionConstIterator;
+
 /** \class TorchPixelHelper
  *  \brief Converts between ITK vector pixel types and torch scalar pixel types.
  *
@@ -68,6 +72,19 @@ public:
  * allows templated code that is syntactically correct for the
  * ordinary Image case to also work with the TorchImage case.
  *
+ * A helper either addresses its pixel through a torch::Tensor and a
+ * list of TensorIndex values, which works on any device, or, for
+ * CPU-resident tensors, through a direct pointer to the pixel's first
+ * deep scalar and the strides of the pixel's component dimensions.
+ * The direct form skips the ATen dispatch and temporary tensors of
+ * the indexed form.  Like a reference into an itk::Image buffer, a
+ * direct helper is invalidated when the image's buffer is replaced.
+ *
+ * A helper returned by the non-const TorchImage::GetPixel() of an
+ * image whose pixels are still shared with a clone reads the shared
+ * pixels, and has the image copy them (see
+ * TorchImage::MakeTensorWritable()) on its first write.
+ *
  * This is the specialization of TorchPixelHelper for pixel types that
  * are already scalars.
  *
@@ -86,30 +103,78 @@ public:
 
   TorchPixelHelper &operator=( const PixelType &value )
     {
-    m_Tensor.index( m_TorchIndex ).fill_( value );
+    if( m_MakeWritable )
+      {
+      *this = m_MakeWritable();
+      }
+    if( m_DeepScalarPointer != nullptr )
+      {
+      *m_DeepScalarPointer = value;
+      }
+    else
+      {
+      TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkPixelProxyAccess, m_Counters, m_Caller );
+      m_Tensor.index( m_TorchIndex ).fill_( value );
+      probe.Stop( sizeof( DeepScalarType ) );
+      }
     return *this;
     }
 
   operator PixelType() const
     {
-    return m_Tensor.index( m_TorchIndex ).item< DeepScalarType >();
+    if( m_DeepScalarPointer != nullptr )
+      {
+      return *m_DeepScalarPointer;
+      }
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkPixelProxyAccess, m_Counters, m_Caller );
+    const PixelType response = m_Tensor.index( m_TorchIndex ).item< DeepScalarType >();
+    probe.Stop( sizeof( DeepScalarType ) );
+    return response;
     }
 
 protected:
   template< typename NTPixelType, typename Void > friend class TorchPixelHelper;
   template< typename NTPixelType, unsigned int NVImageDimension > friend class TorchImage;
+  template< typename TImage > friend class TorchImageRegionConstIterator;
 
   static void AppendSizes( std::vector< int64_t > & itkNotUsed( size ) )
     {
     // Nothing to append
     }
 
-  TorchPixelHelper( torch::Tensor Tensor, std::vector< at::indexing::TensorIndex > &TorchIndex ) : m_Tensor( Tensor ), m_TorchIndex( TorchIndex )
+  /** Write the value into SizeOf consecutive deep scalars. */
+  static void CopyToDeepScalars( const PixelType &value, DeepScalarType *deepScalars )
+    {
+    *deepScalars = value;
+    }
+
+  /** Indexed access.  The accesses of a helper with counters, which
+   * TorchImage::GetPixel() passes for itself, are instrumented; those
+   * of the helpers of the components are not. */
+  TorchPixelHelper( torch::Tensor Tensor, std::vector< at::indexing::TensorIndex > &TorchIndex, TorchInstrumentationCounters *Counters = nullptr, const Object *Caller = nullptr ) : m_Tensor( Tensor ), m_TorchIndex( TorchIndex ), m_DeepScalarPointer( nullptr ), m_ComponentStrides( nullptr ), m_Counters( Counters ), m_Caller( Caller )
+    {
+    }
+
+  /** Direct access to CPU memory.  A scalar pixel has no component
+   * strides. */
+  TorchPixelHelper( DeepScalarType *DeepScalarPointer, const int64_t *ComponentStrides ) : m_DeepScalarPointer( DeepScalarPointer ), m_ComponentStrides( ComponentStrides ), m_Counters( nullptr ), m_Caller( nullptr )
     {
     }
 
   torch::Tensor m_Tensor;
   std::vector< at::indexing::TensorIndex > m_TorchIndex;
+
+  /** Non-null only for direct access to CPU memory */
+  DeepScalarType *m_DeepScalarPointer;
+  const int64_t *m_ComponentStrides;
+
+  /** Non-null only for instrumented indexed access */
+  TorchInstrumentationCounters *m_Counters;
+  const Object *m_Caller;
+
+  /** Set only while the pixels are shared: makes the image's pixels
+   * writable and returns a helper for the pixel in them */
+  std::function< Self() > m_MakeWritable;
 };
 
 /** \class TorchPixelHelper
@@ -127,6 +192,12 @@ protected:
  * allows templated code that is syntactically correct for the
  * ordinary Image case to also work with the TorchImage case.
  *
+ * A helper either addresses its pixel through a torch::Tensor and a
+ * list of TensorIndex values, or, for CPU-resident tensors, through a
+ * direct pointer to the pixel's first deep scalar and the strides of
+ * the pixel's component dimensions.  As for scalar pixels, a helper
+ * of a shared image has the image copy its pixels on its first write.
+ *
  * This is the specialization of TorchPixelHelper for pixel types that
  * are known "vector" types.
  *
@@ -150,30 +221,55 @@ public:
 
   TorchPixelHelper &operator=( const PixelType &value )
     {
+    if( m_MakeWritable )
+      {
+      *this = m_MakeWritable();
+      }
+    if( m_DeepScalarPointer != nullptr )
+      {
+      for( unsigned int i = 0; i < Self::NumberOfComponents; ++i )
+        {
+        NextTorchPixelHelper { m_DeepScalarPointer + i * m_ComponentStrides[0], m_ComponentStrides + 1 } = value[i];
+        }
+      return *this;
+      }
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkPixelProxyAccess, m_Counters, m_Caller );
     for( unsigned int i = 0; i < Self::NumberOfComponents; ++i )
       {
       m_TorchIndex.push_back( static_cast< int64_t >( i ) );
       NextTorchPixelHelper { m_Tensor, m_TorchIndex } = value[i];
       m_TorchIndex.pop_back();
       }
+    probe.Stop( Self::SizeOf * sizeof( DeepScalarType ) );
     return *this;
     }
 
   operator PixelType() const
     {
     PixelType response;
+    if( m_DeepScalarPointer != nullptr )
+      {
+      for( unsigned int i = 0; i < Self::NumberOfComponents; ++i )
+        {
+        response[i] = NextTorchPixelHelper { m_DeepScalarPointer + i * m_ComponentStrides[0], m_ComponentStrides + 1 };
+        }
+      return response;
+      }
+    TorchInstrumentationProbe probe( TorchInstrumentationCounters::itkPixelProxyAccess, m_Counters, m_Caller );
     for( unsigned int i = 0; i < Self::NumberOfComponents; ++i )
       {
       m_TorchIndex.push_back( static_cast< int64_t >( i ) );
       response[i] = NextTorchPixelHelper { m_Tensor, m_TorchIndex };
       m_TorchIndex.pop_back();
       }
+    probe.Stop( Self::SizeOf * sizeof( DeepScalarType ) );
     return response;
     }
 
 protected:
   template< typename NTPixelType, typename Void > friend class TorchPixelHelper;
   template< typename NTPixelType, unsigned int NVImageDimension > friend class TorchImage;
+  template< typename TImage > friend class TorchImageRegionConstIterator;
 
   static void AppendSizes( std::vector< int64_t > &size )
     {
@@ -181,12 +277,44 @@ protected:
     NextTorchPixelHelper::AppendSizes( size );
     }
 
-  TorchPixelHelper( torch::Tensor Tensor, std::vector< at::indexing::TensorIndex > &TorchIndex ) : m_Tensor( Tensor ), m_TorchIndex( TorchIndex )
+  /** Write the value into SizeOf consecutive deep scalars, with the
+   * last component dimension varying the fastest, as in the torch
+   * buffer. */
+  static void CopyToDeepScalars( const PixelType &value, DeepScalarType *deepScalars )
+    {
+    for( unsigned int i = 0; i < Self::NumberOfComponents; ++i )
+      {
+      NextTorchPixelHelper::CopyToDeepScalars( value[i], deepScalars + i * NextTorchPixelHelper::SizeOf );
+      }
+    }
+
+  /** Indexed access.  The accesses of a helper with counters, which
+   * TorchImage::GetPixel() passes for itself, are instrumented; those
+   * of the helpers of the components are not. */
+  TorchPixelHelper( torch::Tensor Tensor, std::vector< at::indexing::TensorIndex > &TorchIndex, TorchInstrumentationCounters *Counters = nullptr, const Object *Caller = nullptr ) : m_Tensor( Tensor ), m_TorchIndex( TorchIndex ), m_DeepScalarPointer( nullptr ), m_ComponentStrides( nullptr ), m_Counters( Counters ), m_Caller( Caller )
+    {
+    }
+
+  /** Direct access to CPU memory.  ComponentStrides has one entry per
+   * component dimension, outermost first. */
+  TorchPixelHelper( DeepScalarType *DeepScalarPointer, const int64_t *ComponentStrides ) : m_DeepScalarPointer( DeepScalarPointer ), m_ComponentStrides( ComponentStrides ), m_Counters( nullptr ), m_Caller( nullptr )
     {
     }
 
   torch::Tensor m_Tensor;
   mutable std::vector< at::indexing::TensorIndex > m_TorchIndex;
+
+  /** Non-null only for direct access to CPU memory */
+  DeepScalarType *m_DeepScalarPointer;
+  const int64_t *m_ComponentStrides;
+
+  /** Non-null only for instrumented indexed access */
+  TorchInstrumentationCounters *m_Counters;
+  const Object *m_Caller;
+
+  /** Set only while the pixels are shared: makes the image's pixels
+   * writable and returns a helper for the pixel in them */
+  std::function< Self() > m_MakeWritable;
 };
 } // end namespace itk
 
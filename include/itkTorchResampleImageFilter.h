@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchResampleImageFilter_h
+#define itkTorchResampleImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkMatrixOffsetTransformBase.h"
+#include "itkTorchImage.h"
+
+namespace itk
+{
+/** \class TorchResampleImageFilter
+ *  \brief Resample a TorchImage onto another grid through an affine transform, with one grid_sample call.
+ *
+ * Like ResampleImageFilter, the filter maps the physical point of each
+ * output pixel through the transform into the input image, and
+ * interpolates the input there.  The transform is any
+ * MatrixOffsetTransformBase, such as AffineTransform or
+ * Euler3DTransform, so that the whole chain from output index to input
+ * continuous index is one affine map, computed in double precision
+ * from the geometry of the output grid, the transform and the
+ * geometry of the input.  The sampling grid of at::grid_sampler is
+ * computed from it, and all pixel components are sampled by one
+ * grid_sampler call on the device of the input.
+ *
+ * As with ITK's interpolators, points within half a pixel outside of
+ * the buffered region of the input are interpolated from the border
+ * pixels, and points farther out get DefaultPixelValue.
+ * itkLinearInterpolation matches LinearInterpolateImageFunction and
+ * itkNearestInterpolation matches NearestNeighborInterpolateImageFunction
+ * except at exact halfway points.  itkBicubicInterpolation, for 2D
+ * images only, is PyTorch's bicubic convolution, which has no
+ * equivalent ITK interpolator.
+ *
+ * The sampling is computed in the deep scalar type of the output if
+ * it is a floating point type, and in float otherwise; values are then
+ * converted to the output type as by static_cast.  The output has the
+ * device and component layout of the input.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchResampleImageFilter : public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchResampleImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchResampleImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchResampleImageFilter, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using PixelType = typename OutputImageType::PixelType;
+  using SizeType = typename OutputImageType::SizeType;
+  using IndexType = typename OutputImageType::IndexType;
+  using PointType = typename OutputImageType::PointType;
+  using SpacingType = typename OutputImageType::SpacingType;
+  using DirectionType = typename OutputImageType::DirectionType;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  static_assert( ImageDimension == 2 || ImageDimension == 3, "grid_sample resamples only 2 and 3 dimensional images" );
+  static_assert( InputImageType::TorchImagePixelHelper::SizeOf == OutputImageType::TorchImagePixelHelper::SizeOf
+    && InputImageType::PixelDimension == OutputImageType::PixelDimension,
+    "TorchResampleImageFilter requires input and output pixels with the same components" );
+
+  using TransformType = MatrixOffsetTransformBase< double, ImageDimension, ImageDimension >;
+  using ImageBaseType = ImageBase< ImageDimension >;
+
+  enum InterpolationType { itkLinearInterpolation, itkNearestInterpolation, itkBicubicInterpolation };
+
+  /** The transform from output to input physical space.  Defaults to
+   * the identity. */
+  itkSetConstObjectMacro( Transform, TransformType );
+  itkGetConstObjectMacro( Transform, TransformType );
+
+  /** The interpolation.  Defaults to itkLinearInterpolation. */
+  itkSetMacro( Interpolation, InterpolationType );
+  itkGetConstMacro( Interpolation, InterpolationType );
+
+  /** The value of output pixels that map outside of the input.
+   * Defaults to zero. */
+  itkSetMacro( DefaultPixelValue, PixelType );
+  itkGetConstReferenceMacro( DefaultPixelValue, PixelType );
+
+  /** The output grid. */
+  itkSetMacro( Size, SizeType );
+  itkGetConstReferenceMacro( Size, SizeType );
+  itkSetMacro( OutputStartIndex, IndexType );
+  itkGetConstReferenceMacro( OutputStartIndex, IndexType );
+  itkSetMacro( OutputOrigin, PointType );
+  itkGetConstReferenceMacro( OutputOrigin, PointType );
+  itkSetMacro( OutputSpacing, SpacingType );
+  itkGetConstReferenceMacro( OutputSpacing, SpacingType );
+  itkSetMacro( OutputDirection, DirectionType );
+  itkGetConstReferenceMacro( OutputDirection, DirectionType );
+
+  /** Take the output grid from the largest possible region and geometry
+   * of an image. */
+  void SetOutputParametersFromImage( const ImageBaseType *image );
+
+  /** Include the transform's modification time. */
+  ModifiedTimeType GetMTime() const override;
+
+protected:
+  TorchResampleImageFilter();
+  ~TorchResampleImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** Set the geometry and largest possible region of the output from
+   * the output grid. */
+  void GenerateOutputInformation() override;
+
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion() override;
+
+  /** The whole output is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** The input need not occupy the physical space of the output. */
+  void VerifyInputInformation() ITKv5_CONST override {}
+
+  void GenerateData() override;
+
+private:
+  typename TransformType::ConstPointer m_Transform;
+  InterpolationType m_Interpolation;
+  PixelType m_DefaultPixelValue;
+  SizeType m_Size;
+  IndexType m_OutputStartIndex;
+  PointType m_OutputOrigin;
+  SpacingType m_OutputSpacing;
+  DirectionType m_OutputDirection;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchResampleImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,243 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchResampleImageFilter_hxx
+#define itkTorchResampleImageFilter_hxx
+
+#include "itkTorchResampleImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::TorchResampleImageFilter()
+  : m_Transform( TransformType::New().GetPointer() ),
+    m_Interpolation( itkLinearInterpolation ),
+    m_DefaultPixelValue( NumericTraits< PixelType >::ZeroValue() )
+{
+  m_Size.Fill( 0 );
+  m_OutputStartIndex.Fill( 0 );
+  m_OutputOrigin.Fill( 0.0 );
+  m_OutputSpacing.Fill( 1.0 );
+  m_OutputDirection.SetIdentity();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::SetOutputParametersFromImage( const ImageBaseType *image )
+{
+  this->SetOutputOrigin( image->GetOrigin() );
+  this->SetOutputSpacing( image->GetSpacing() );
+  this->SetOutputDirection( image->GetDirection() );
+  this->SetOutputStartIndex( image->GetLargestPossibleRegion().GetIndex() );
+  this->SetSize( image->GetLargestPossibleRegion().GetSize() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+ModifiedTimeType
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::GetMTime() const
+{
+  ModifiedTimeType latestTime = Superclass::GetMTime();
+  if( m_Transform.IsNotNull() )
+    {
+    latestTime = std::max( latestTime, m_Transform->GetMTime() );
+    }
+  return latestTime;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  OutputImageType *output = this->GetOutput();
+  output->SetLargestPossibleRegion( typename OutputImageType::RegionType( m_OutputStartIndex, m_Size ) );
+  output->SetOrigin( m_OutputOrigin );
+  output->SetSpacing( m_OutputSpacing );
+  output->SetDirection( m_OutputDirection );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto *input = const_cast< InputImageType * >( this->GetInput() );
+  if( input != nullptr )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+  if( m_Interpolation == itkBicubicInterpolation && ImageDimension != 2 )
+    {
+    itkExceptionMacro( << "Bicubic interpolation is available for 2D images only" );
+    }
+  constexpr torch::ScalarType computeType =
+    std::is_floating_point< typename OutputImageType::DeepScalarType >::value ? OutputImageType::TorchValueType : torch::kFloat;
+  const torch::Device device = input->GetTensor().device();
+
+  // The input as a batch of one, with the pixel components as channels.
+  const torch::Tensor tensor =
+    InputImageType::PermuteComponentLayout( input->GetTensor(), input->GetComponentLayout(), InputImageType::itkComponentsFirst );
+  std::vector< int64_t > batchSize{ 1, InputImageType::TorchImagePixelHelper::SizeOf };
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    batchSize.push_back( tensor.size( InputImageType::PixelDimension + d ) );
+    }
+  const torch::Tensor batch = tensor.reshape( batchSize ).to( computeType );
+
+  // The affine map from an output index k, counted from the start of
+  // the output region, to the continuous index c of the input,
+  // counted from the start of its buffered region: c = A k + b.
+  const typename TransformType::MatrixType & matrix = m_Transform->GetMatrix();
+  const auto & inputPointToIndex = input->GetPhysicalPointToIndex();
+  const auto outputIndexToPoint = output->GetIndexToPhysicalPoint();
+  const auto A = inputPointToIndex * matrix * outputIndexToPoint;
+  Vector< double, ImageDimension > outputStart;
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    outputStart[j] = m_OutputStartIndex[j];
+    }
+  Vector< double, ImageDimension > b = inputPointToIndex
+    * ( matrix * ( m_OutputOrigin.GetVectorFromOrigin() + outputIndexToPoint * outputStart ) + m_Transform->GetOffset()
+      - input->GetOrigin().GetVectorFromOrigin() );
+  const typename InputImageType::RegionType & inputRegion = input->GetBufferedRegion();
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    b[j] -= inputRegion.GetIndex( j );
+    }
+
+  // The continuous index of every output pixel, in double precision,
+  // in the (x, y, z) order of grid_sampler's grid.
+  const auto doubleOptions = torch::dtype( torch::kDouble ).device( device );
+  torch::Tensor continuousIndex = torch::tensor( std::vector< double >( b.GetDataPointer(), b.GetDataPointer() + ImageDimension ), doubleOptions );
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    std::vector< int64_t > shape( ImageDimension + 1, 1 );
+    shape[ImageDimension - 1 - j] = m_Size[j];
+    std::vector< double > column( ImageDimension );
+    for( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      column[i] = A[i][j];
+      }
+    continuousIndex = continuousIndex
+      + torch::arange( static_cast< int64_t >( m_Size[j] ), doubleOptions ).view( shape ) * torch::tensor( column, doubleOptions );
+    }
+
+  // As for ITK's interpolators, points within half a pixel of the
+  // buffered region are inside, and are interpolated from the border
+  // pixels by grid_sampler's border padding.
+  std::vector< double > upperBound( ImageDimension );
+  std::vector< double > normalizingScale( ImageDimension );
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    const double size = inputRegion.GetSize( j );
+    upperBound[j] = size - 0.5;
+    normalizingScale[j] = size > 1.0 ? 2.0 / ( size - 1.0 ) : 0.0;
+    }
+  const torch::Tensor inside =
+    continuousIndex.ge( -0.5 ).logical_and_( continuousIndex.lt( torch::tensor( upperBound, doubleOptions ) ) ).all( -1 );
+  // With align_corners, -1 and 1 are the centers of the first and last
+  // pixels.
+  const torch::Tensor grid =
+    ( continuousIndex * torch::tensor( normalizingScale, doubleOptions ) - 1.0 ).to( computeType ).unsqueeze( 0 );
+
+  int64_t interpolationMode = 0;
+  switch( m_Interpolation )
+    {
+    case itkLinearInterpolation:
+      interpolationMode = 0;
+      break;
+    case itkNearestInterpolation:
+      interpolationMode = 1;
+      break;
+    case itkBicubicInterpolation:
+      interpolationMode = 2;
+      break;
+    }
+  constexpr int64_t borderPadding = 1;
+  torch::Tensor sampled = at::grid_sampler( batch, grid, interpolationMode, borderPadding, true );
+
+  std::vector< int64_t > channelSize( 2 + ImageDimension, 1 );
+  channelSize[1] = OutputImageType::TorchImagePixelHelper::SizeOf;
+  const torch::Tensor defaultValue = OutputImageType::PixelToTensor( m_DefaultPixelValue, OutputImageType::itkComponentsLast )
+    .reshape( channelSize ).to( device, computeType );
+  sampled = torch::where( inside.unsqueeze( 0 ).unsqueeze( 0 ), sampled, defaultValue );
+
+  // Back from a batch to the layout of the output.
+  std::vector< int64_t > tensorSize;
+  OutputImageType::TorchImagePixelHelper::AppendSizes( tensorSize );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tensorSize.push_back( sampled.size( 2 + d ) );
+    }
+  output->CopyTensorInformation( input );
+  output->SetBufferedRegion( output->GetLargestPossibleRegion() );
+  output->SetTensor( OutputImageType::PermuteComponentLayout( sampled.reshape( tensorSize ).to( OutputImageType::TorchValueType ),
+    OutputImageType::itkComponentsFirst, output->GetComponentLayout() ).contiguous() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchResampleImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_Interpolation: " << m_Interpolation << std::endl
+    << indent << "m_DefaultPixelValue: "
+    << static_cast< typename NumericTraits< PixelType >::PrintType >( m_DefaultPixelValue ) << std::endl
+    << indent << "m_Size: " << m_Size << std::endl
+    << indent << "m_OutputStartIndex: " << m_OutputStartIndex << std::endl
+    << indent << "m_OutputOrigin: " << m_OutputOrigin << std::endl
+    << indent << "m_OutputSpacing: " << m_OutputSpacing << std::endl
+    << indent << "m_OutputDirection: " << m_OutputDirection << std::endl
+    ;
+  itkPrintSelfObjectMacro( Transform );
+}
+
+} // end namespace itk
+
+#endif
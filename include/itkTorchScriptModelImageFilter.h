@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchScriptModelImageFilter_h
+#define itkTorchScriptModelImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkTorchImage.h"
+#include <torch/script.h>
+
+namespace itk
+{
+/** \class TorchScriptModelImageFilter
+ *  \brief Run a TorchScript model over a TorchImage in overlapping patches, blending the patch outputs.
+ *
+ * The model is a TorchScript module, either loaded from the file set
+ * with SetModelFileName(), once, at the first update, or given with
+ * SetModule().  Its forward method takes a float tensor of sizes
+ * [B, C, spatial...] and returns one of sizes [B, C', spatial...],
+ * where C and C' are the numbers of components of the input and
+ * output pixels, and the spatial sizes are those of a patch in tensor
+ * order, e.g. [z, y, x] in 3D.
+ *
+ * The input is tiled with patches of PatchSize, which overlap by the
+ * fraction Overlap of their size; the last patch of each row is
+ * aligned with the end of the image.  An image smaller than a patch is
+ * padded with zeros.  The patches are stacked in batches of BatchSize
+ * and each batch is run through the model with gradients disabled.
+ * The patch outputs are summed into the output with a weight map,
+ * either constant or a Gaussian centered on the patch with a standard
+ * deviation of GaussianSigmaScale times the patch size, and the sum
+ * is divided by the sum of the weights.  The Gaussian weights reduce
+ * the seams of models that are less accurate near the patch borders.
+ *
+ * The time spent extracting patches, in the model, and blending is
+ * measured at each update.  On a CUDA device, whose kernels run
+ * asynchronously, a step may be charged for the completion of the
+ * kernels of the previous one.
+ *
+ * The output has the geometry, device and component layout of the
+ * input.
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class ITK_TEMPLATE_EXPORT TorchScriptModelImageFilter : public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchScriptModelImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchScriptModelImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchScriptModelImageFilter, ImageToImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using SizeType = typename InputImageType::SizeType;
+  using SizeValueType = typename InputImageType::SizeValueType;
+  using ModuleType = torch::jit::script::Module;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  enum BlendingType { itkConstantBlending, itkGaussianBlending };
+
+  /** The file of the TorchScript module, as written by
+   * torch.jit.save.  It is loaded at the next update. */
+  void SetModelFileName( const std::string & fileName );
+  itkGetStringMacro( ModelFileName );
+
+  /** Set the module directly, instead of from a file. */
+  void SetModule( const ModuleType & module );
+  const ModuleType & GetModule() const
+    {
+    return m_Module;
+    }
+
+  /** The size of the patches.  A size of zero in a dimension, the
+   * default, makes the patches span the image in that dimension. */
+  itkSetMacro( PatchSize, SizeType );
+  itkGetConstReferenceMacro( PatchSize, SizeType );
+
+  /** The fraction of a patch shared with its neighbor, in [0, 1].
+   * Defaults to 0.25. */
+  itkSetClampMacro( Overlap, double, 0.0, 1.0 );
+  itkGetConstMacro( Overlap, double );
+
+  /** The number of patches per model call.  Defaults to 4. */
+  itkSetClampMacro( BatchSize, unsigned int, 1, NumericTraits< unsigned int >::max() );
+  itkGetConstMacro( BatchSize, unsigned int );
+
+  /** The weights of the patch outputs.  Defaults to
+   * itkGaussianBlending. */
+  itkSetMacro( Blending, BlendingType );
+  itkGetConstMacro( Blending, BlendingType );
+
+  /** The standard deviation of the Gaussian weights, as a fraction of
+   * the patch size.  Defaults to 0.125. */
+  itkSetMacro( GaussianSigmaScale, double );
+  itkGetConstMacro( GaussianSigmaScale, double );
+
+  /** The number of patches of the last update. */
+  itkGetConstMacro( NumberOfPatches, SizeValueType );
+
+  /** The time, in seconds, of each step of the last update. */
+  double GetExtractionTime() const
+    {
+    return m_ExtractionProbe.GetTotal();
+    }
+  double GetInferenceTime() const
+    {
+    return m_InferenceProbe.GetTotal();
+    }
+  double GetBlendingTime() const
+    {
+    return m_BlendingProbe.GetTotal();
+    }
+
+protected:
+  TorchScriptModelImageFilter();
+  ~TorchScriptModelImageFilter() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion() override;
+
+  /** The whole output is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  void GenerateData() override;
+
+  /** The weight map of a patch, of the patch sizes in tensor order. */
+  torch::Tensor ComputeWeights( const std::vector< int64_t > & patchSize, const torch::TensorOptions & options ) const;
+
+  /** The start of each patch along a dimension of the given size. */
+  static std::vector< int64_t > ComputePatchStarts( int64_t size, int64_t patchSize, double overlap );
+
+private:
+  std::string m_ModelFileName;
+  ModuleType m_Module;
+  bool m_ModuleLoaded;
+  SizeType m_PatchSize;
+  double m_Overlap;
+  unsigned int m_BatchSize;
+  BlendingType m_Blending;
+  double m_GaussianSigmaScale;
+
+  SizeValueType m_NumberOfPatches;
+  TimeProbe m_ExtractionProbe;
+  TimeProbe m_InferenceProbe;
+  TimeProbe m_BlendingProbe;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchScriptModelImageFilter.hxx"
+#endif
+
+#endif
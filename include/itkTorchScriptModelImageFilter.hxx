@@ -0,0 +1,312 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchScriptModelImageFilter_hxx
+#define itkTorchScriptModelImageFilter_hxx
+
+#include "itkTorchScriptModelImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+#include <cmath>
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::TorchScriptModelImageFilter()
+  : m_ModuleLoaded( false ),
+    m_Overlap( 0.25 ),
+    m_BatchSize( 4 ),
+    m_Blending( itkGaussianBlending ),
+    m_GaussianSigmaScale( 0.125 ),
+    m_NumberOfPatches( 0 )
+{
+  m_PatchSize.Fill( 0 );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::SetModelFileName( const std::string & fileName )
+{
+  if( fileName != m_ModelFileName || !m_ModuleLoaded )
+    {
+    m_ModelFileName = fileName;
+    m_ModuleLoaded = false;
+    this->Modified();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::SetModule( const ModuleType & module )
+{
+  m_Module = module;
+  m_ModuleLoaded = true;
+  m_ModelFileName.clear();
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto *input = const_cast< InputImageType * >( this->GetInput() );
+  if( input != nullptr )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage >
+std::vector< int64_t >
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::ComputePatchStarts( int64_t size, int64_t patchSize, double overlap )
+{
+  const int64_t step = std::max< int64_t >( 1, std::llround( patchSize * ( 1.0 - overlap ) ) );
+  std::vector< int64_t > starts;
+  for( int64_t start = 0; start + patchSize < size; start += step )
+    {
+    starts.push_back( start );
+    }
+  starts.push_back( size - patchSize );
+  return starts;
+}
+
+template< typename TInputImage, typename TOutputImage >
+torch::Tensor
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::ComputeWeights( const std::vector< int64_t > & patchSize, const torch::TensorOptions & options ) const
+{
+  torch::Tensor weights = torch::ones( patchSize, options );
+  if( m_Blending == itkConstantBlending )
+    {
+    return weights;
+    }
+  if( m_GaussianSigmaScale <= 0.0 )
+    {
+    itkExceptionMacro( << "GaussianSigmaScale must be positive, not " << m_GaussianSigmaScale );
+    }
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const double sigma = m_GaussianSigmaScale * patchSize[d];
+    const torch::Tensor x = torch::arange( patchSize[d], options ) - ( patchSize[d] - 1 ) / 2.0;
+    std::vector< int64_t > shape( ImageDimension, 1 );
+    shape[d] = patchSize[d];
+    weights.mul_( torch::exp( x * x / ( -2.0 * sigma * sigma ) ).view( shape ) );
+    }
+  // Keep the weights of the patch corners from underflowing to zero,
+  // which would leave corners of the image without any weight.
+  return weights.clamp_min_( 1e-6 );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const TorchIntraOpThreadsGuard threadsGuard( this );
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+  if( !m_ModuleLoaded )
+    {
+    if( m_ModelFileName.empty() )
+      {
+      itkExceptionMacro( << "Neither a model file name nor a module is set" );
+      }
+    try
+      {
+      m_Module = torch::jit::load( m_ModelFileName );
+      }
+    catch( const c10::Error & error )
+      {
+      itkExceptionMacro( << "Cannot load TorchScript module " << m_ModelFileName << ": "
+        << error.what_without_backtrace() );
+      }
+    m_ModuleLoaded = true;
+    }
+  const torch::Device device = input->GetTensor().device();
+  m_Module.eval();
+  m_Module.to( device );
+  torch::NoGradGuard noGradGuard;
+
+  m_ExtractionProbe.Reset();
+  m_InferenceProbe.Reset();
+  m_BlendingProbe.Reset();
+  m_ExtractionProbe.Start();
+
+  // The input as channels of float images, padded with zeros to at
+  // least the patch size.
+  constexpr int64_t inputChannels = InputImageType::TorchImagePixelHelper::SizeOf;
+  constexpr int64_t outputChannels = OutputImageType::TorchImagePixelHelper::SizeOf;
+  const torch::Tensor tensor =
+    InputImageType::PermuteComponentLayout( input->GetTensor(), input->GetComponentLayout(), InputImageType::itkComponentsFirst );
+  std::vector< int64_t > channelsSize{ inputChannels };
+  std::vector< int64_t > imageSize;
+  std::vector< int64_t > patchSize;
+  std::vector< int64_t > paddedSize;
+  std::vector< int64_t > padding;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const int64_t size = tensor.size( InputImageType::PixelDimension + d );
+    const SizeValueType requestedPatchSize = m_PatchSize[ImageDimension - 1 - d];
+    channelsSize.push_back( size );
+    imageSize.push_back( size );
+    patchSize.push_back( requestedPatchSize == 0 ? size : static_cast< int64_t >( requestedPatchSize ) );
+    paddedSize.push_back( std::max( size, patchSize.back() ) );
+    }
+  // Padding is given from the last dimension backwards.
+  for( unsigned int d = ImageDimension; d-- > 0; )
+    {
+    padding.push_back( 0 );
+    padding.push_back( paddedSize[d] - imageSize[d] );
+    }
+  torch::Tensor image = tensor.reshape( channelsSize ).to( torch::kFloat );
+  if( paddedSize != imageSize )
+    {
+    image = at::constant_pad_nd( image, padding, 0.0 );
+    }
+
+  std::vector< std::vector< int64_t > > starts;
+  m_NumberOfPatches = 1;
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    starts.push_back( Self::ComputePatchStarts( paddedSize[d], patchSize[d], m_Overlap ) );
+    m_NumberOfPatches *= starts.back().size();
+    }
+  const auto floatOptions = torch::dtype( torch::kFloat ).device( device );
+  const torch::Tensor weights = this->ComputeWeights( patchSize, floatOptions );
+  std::vector< int64_t > accumulatedSize{ outputChannels };
+  accumulatedSize.insert( accumulatedSize.end(), paddedSize.begin(), paddedSize.end() );
+  torch::Tensor accumulated = torch::zeros( accumulatedSize, floatOptions );
+  torch::Tensor weightSum = torch::zeros( paddedSize, floatOptions );
+  m_ExtractionProbe.Stop();
+
+  // The start of patch number p, with the last tensor dimension
+  // varying fastest.
+  const auto patchStart = [&starts]( SizeValueType p ) -> std::vector< int64_t >
+    {
+    std::vector< int64_t > start( ImageDimension );
+    for( unsigned int d = ImageDimension; d-- > 0; )
+      {
+      start[d] = starts[d][p % starts[d].size()];
+      p /= starts[d].size();
+      }
+    return start;
+    };
+  const auto patchView = [&patchSize]( torch::Tensor view, const std::vector< int64_t > & start, int64_t firstDimension )
+    {
+    for( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      view = view.narrow( firstDimension + d, start[d], patchSize[d] );
+      }
+    return view;
+    };
+
+  for( SizeValueType first = 0; first < m_NumberOfPatches; first += m_BatchSize )
+    {
+    const SizeValueType count = std::min< SizeValueType >( m_BatchSize, m_NumberOfPatches - first );
+    m_ExtractionProbe.Start();
+    std::vector< std::vector< int64_t > > batchStarts;
+    std::vector< torch::Tensor > patches;
+    for( SizeValueType p = first; p < first + count; ++p )
+      {
+      batchStarts.push_back( patchStart( p ) );
+      patches.push_back( patchView( image, batchStarts.back(), 1 ) );
+      }
+    const torch::Tensor batch = torch::stack( patches );
+    m_ExtractionProbe.Stop();
+
+    m_InferenceProbe.Start();
+    const torch::Tensor result = m_Module.forward( { batch } ).toTensor();
+    m_InferenceProbe.Stop();
+
+    std::vector< int64_t > expectedSize{ static_cast< int64_t >( count ), outputChannels };
+    expectedSize.insert( expectedSize.end(), patchSize.begin(), patchSize.end() );
+    if( !result.sizes().equals( expectedSize ) )
+      {
+      itkExceptionMacro( << "The model returned a tensor of sizes " << result.sizes() << " instead of "
+        << torch::IntArrayRef( expectedSize ) );
+      }
+
+    m_BlendingProbe.Start();
+    const torch::Tensor weighted = result.to( torch::kFloat ) * weights;
+    for( SizeValueType k = 0; k < count; ++k )
+      {
+      patchView( accumulated, batchStarts[k], 1 ).add_( weighted[k] );
+      patchView( weightSum, batchStarts[k], 0 ).add_( weights );
+      }
+    m_BlendingProbe.Stop();
+    }
+
+  m_BlendingProbe.Start();
+  accumulated.div_( weightSum );
+  std::vector< int64_t > tensorSize;
+  OutputImageType::TorchImagePixelHelper::AppendSizes( tensorSize );
+  for( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    accumulated = accumulated.narrow( 1 + d, 0, imageSize[d] );
+    tensorSize.push_back( imageSize[d] );
+    }
+  output->CopyTensorInformation( input );
+  output->SetBufferedRegion( output->GetLargestPossibleRegion() );
+  output->SetTensor( OutputImageType::PermuteComponentLayout( accumulated.reshape( tensorSize ).to( OutputImageType::TorchValueType ),
+    OutputImageType::itkComponentsFirst, output->GetComponentLayout() ).contiguous() );
+  m_BlendingProbe.Stop();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+TorchScriptModelImageFilter< TInputImage, TOutputImage >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os
+    << indent << "m_ModelFileName: " << m_ModelFileName << std::endl
+    << indent << "m_ModuleLoaded: " << m_ModuleLoaded << std::endl
+    << indent << "m_PatchSize: " << m_PatchSize << std::endl
+    << indent << "m_Overlap: " << m_Overlap << std::endl
+    << indent << "m_BatchSize: " << m_BatchSize << std::endl
+    << indent << "m_Blending: " << m_Blending << std::endl
+    << indent << "m_GaussianSigmaScale: " << m_GaussianSigmaScale << std::endl
+    << indent << "m_NumberOfPatches: " << m_NumberOfPatches << std::endl
+    << indent << "ExtractionTime: " << this->GetExtractionTime() << std::endl
+    << indent << "InferenceTime: " << this->GetInferenceTime() << std::endl
+    << indent << "BlendingTime: " << this->GetBlendingTime() << std::endl
+    ;
+}
+
+} // end namespace itk
+
+#endif
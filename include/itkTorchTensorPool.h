@@ -0,0 +1,294 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchTensorPool_h
+#define itkTorchTensorPool_h
+
+#include <list>
+#include <mutex>
+#include <torch/torch.h>
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace itk
+{
+/** \class TorchTensorPool
+ *  \brief A per-process pool of tensors that TorchImage recycles.
+ *
+ * When the pool is enabled, TorchImage::Allocate() takes a tensor of
+ * the right dtype, device and sizes from the pool, if there is one,
+ * instead of allocating new memory.  TorchImage::Initialize(),
+ * re-allocation and destruction return the tensor to the pool,
+ * provided that no other tensor, image or view still shares its
+ * storage.  This avoids repeated allocation, page faults and, for
+ * GPUs, device synchronization when images of the same shape are
+ * created and released over and over.
+ *
+ * The pool is disabled by default.  It holds at most
+ * MaximumNumberOfBytes bytes; the least recently returned tensors are
+ * released first when a returned tensor would exceed that.  Trim()
+ * releases pooled tensors explicitly.  The numbers of hits and misses
+ * of Acquire() tell how well the pool works for an application.
+ *
+ * \code
+ * itk::TorchTensorPool::GetInstance()->EnabledOn();
+ * \endcode
+ *
+ * All methods are thread safe.
+ *
+ * \ingroup PyTorch
+ */
+class TorchTensorPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchTensorPool );
+
+  /** Standard class type aliases */
+  using Self = TorchTensorPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchTensorPool, Object );
+
+  /** The pool shared by all TorchImages of the process. */
+  static Self * GetInstance()
+    {
+    // Deliberately never destroyed, so that pooled tensors are not
+    // released after the torch allocators during process exit.
+    static Self * const instance = []()
+      {
+      Pointer pool = Self::New();
+      pool->Register();
+      return pool.GetPointer();
+      }();
+    return instance;
+    }
+
+  /** Enable or disable the pool.  Disabling it releases all pooled
+   * tensors. */
+  void SetEnabled( bool enabled )
+    {
+      {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      if( m_Enabled == enabled )
+        {
+        return;
+        }
+      m_Enabled = enabled;
+      }
+    if( !enabled )
+      {
+      this->Trim();
+      }
+    this->Modified();
+    }
+  bool GetEnabled() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return m_Enabled;
+    }
+  itkBooleanMacro( Enabled );
+
+  /** The maximum number of bytes held by the pool.  Lowering it
+   * releases pooled tensors as needed. */
+  void SetMaximumNumberOfBytes( uint64_t maximumNumberOfBytes )
+    {
+      {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      m_MaximumNumberOfBytes = maximumNumberOfBytes;
+      }
+    this->Trim( maximumNumberOfBytes );
+    this->Modified();
+    }
+  uint64_t GetMaximumNumberOfBytes() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return m_MaximumNumberOfBytes;
+    }
+
+  /** Return an uninitialized tensor with the given sizes and options,
+   * from the pool if it holds a matching one and newly allocated
+   * otherwise. */
+  torch::Tensor Acquire( torch::IntArrayRef sizes, const c10::TensorOptions & tensorOptions )
+    {
+      {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      if( m_Enabled )
+        {
+        // Search the most recently returned tensors first.
+        for( auto entry = m_Entries.rbegin(); entry != m_Entries.rend(); ++entry )
+          {
+          const torch::Tensor & tensor = *entry;
+          if( tensor.scalar_type() == c10::typeMetaToScalarType( tensorOptions.dtype() )
+            && tensor.device() == tensorOptions.device() && tensor.sizes() == sizes )
+            {
+            torch::Tensor result = tensor;
+            m_NumberOfBytes -= Self::NumberOfBytes( result );
+            m_Entries.erase( std::next( entry ).base() );
+            ++m_NumberOfHits;
+            return result;
+            }
+          }
+        ++m_NumberOfMisses;
+        }
+      }
+    return torch::empty( sizes, tensorOptions );
+    }
+
+  /** Offer a tensor to the pool.  The pool takes it, and resets the
+   * handle, only if the pool is enabled, the tensor is the sole user
+   * of its whole storage, and it fits within MaximumNumberOfBytes.
+   * Returns whether the pool took the tensor. */
+  bool Release( torch::Tensor & tensor )
+    {
+    if( !tensor.defined() || tensor.use_count() != 1 || tensor.storage().use_count() != 1
+      || tensor.storage_offset() != 0 || !tensor.is_contiguous() || tensor.requires_grad()
+      || static_cast< size_t >( Self::NumberOfBytes( tensor ) ) != tensor.storage().nbytes() )
+      {
+      return false;
+      }
+    const uint64_t numberOfBytes = Self::NumberOfBytes( tensor );
+
+    // Tensors evicted from the pool are released outside of the lock.
+    std::list< torch::Tensor > evicted;
+      {
+      std::lock_guard< std::mutex > lock( m_Mutex );
+      if( !m_Enabled || numberOfBytes > m_MaximumNumberOfBytes )
+        {
+        return false;
+        }
+      while( m_NumberOfBytes + numberOfBytes > m_MaximumNumberOfBytes )
+        {
+        m_NumberOfBytes -= Self::NumberOfBytes( m_Entries.front() );
+        evicted.splice( evicted.end(), m_Entries, m_Entries.begin() );
+        }
+      m_Entries.push_back( std::move( tensor ) );
+      m_NumberOfBytes += numberOfBytes;
+      ++m_NumberOfReleases;
+      }
+    tensor = torch::Tensor();
+    return true;
+    }
+
+  /** Release all pooled tensors. */
+  void Trim()
+    {
+    this->Trim( 0 );
+    }
+
+  /** Release the least recently returned tensors until the pool holds
+   * no more than maximumNumberOfBytes bytes. */
+  void Trim( uint64_t maximumNumberOfBytes )
+    {
+    std::list< torch::Tensor > evicted;
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    while( m_NumberOfBytes > maximumNumberOfBytes )
+      {
+      m_NumberOfBytes -= Self::NumberOfBytes( m_Entries.front() );
+      evicted.splice( evicted.end(), m_Entries, m_Entries.begin() );
+      }
+    }
+
+  /** Number of calls of Acquire() served from the pool. */
+  uint64_t GetNumberOfHits() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return m_NumberOfHits;
+    }
+
+  /** Number of calls of Acquire() that allocated a new tensor while
+   * the pool was enabled. */
+  uint64_t GetNumberOfMisses() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return m_NumberOfMisses;
+    }
+
+  /** Number of tensors that the pool took from Release(). */
+  uint64_t GetNumberOfReleases() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return m_NumberOfReleases;
+    }
+
+  /** Number of bytes held by the pool. */
+  uint64_t GetNumberOfBytes() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return m_NumberOfBytes;
+    }
+
+  /** Number of tensors held by the pool. */
+  SizeValueType GetNumberOfTensors() const
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    return static_cast< SizeValueType >( m_Entries.size() );
+    }
+
+  /** Reset the hit, miss and release counters. */
+  void ResetCounters()
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    m_NumberOfHits = 0;
+    m_NumberOfMisses = 0;
+    m_NumberOfReleases = 0;
+    }
+
+protected:
+  TorchTensorPool() = default;
+  ~TorchTensorPool() override = default;
+
+  void PrintSelf( std::ostream & os, Indent indent ) const override
+    {
+    Superclass::PrintSelf( os, indent );
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    os
+      << indent << "m_Enabled: " << m_Enabled << std::endl
+      << indent << "m_MaximumNumberOfBytes: " << m_MaximumNumberOfBytes << std::endl
+      << indent << "m_NumberOfBytes: " << m_NumberOfBytes << std::endl
+      << indent << "Number of tensors: " << m_Entries.size() << std::endl
+      << indent << "m_NumberOfHits: " << m_NumberOfHits << std::endl
+      << indent << "m_NumberOfMisses: " << m_NumberOfMisses << std::endl
+      << indent << "m_NumberOfReleases: " << m_NumberOfReleases << std::endl
+      ;
+    }
+
+  static uint64_t NumberOfBytes( const torch::Tensor & tensor )
+    {
+    return static_cast< uint64_t >( tensor.numel() ) * static_cast< uint64_t >( tensor.element_size() );
+    }
+
+private:
+  mutable std::mutex m_Mutex;
+  bool m_Enabled{ false };
+  uint64_t m_MaximumNumberOfBytes{ uint64_t( 1 ) << 30 };
+  uint64_t m_NumberOfBytes{ 0 };
+  uint64_t m_NumberOfHits{ 0 };
+  uint64_t m_NumberOfMisses{ 0 };
+  uint64_t m_NumberOfReleases{ 0 };
+
+  /** Pooled tensors, least recently returned first */
+  std::list< torch::Tensor > m_Entries;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchThreadingPolicy_h
+#define itkTorchThreadingPolicy_h
+
+#include <algorithm>
+#include <atomic>
+#include <torch/torch.h>
+#if AT_PARALLEL_OPENMP
+#include <omp.h>
+#endif
+#include "itkMultiThreaderBase.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkProcessObject.h"
+
+namespace itk
+{
+/** \class TorchThreadingPolicy
+ *  \brief The per-process policy that shares the cores between ITK's threads and ATen's thread pools.
+ *
+ * ATen parallelizes each operation over its own intra-op threads, and
+ * ITK filters over the threads of their MultiThreaderBase.  Left
+ * alone, both size themselves to all cores, and ATen operations run
+ * from ITK threads oversubscribe the machine.  The policy decides how
+ * many intra-op threads an operation gets:
+ *
+ * - With itkIntraOpParallelism, the default, TorchImage filters run
+ *   their operations on the whole image from the calling thread with
+ *   as many intra-op threads as the filter has work units, but no more
+ *   than the MaximumNumberOfThreads of its multithreader.  Both
+ *   default to ITK's global default number of threads, and
+ *   SetNumberOfWorkUnits() overrides them per filter.
+ * - With itkWorkUnitParallelism, filters whose pixels are independent
+ *   of each other, TorchUnaryImageFilter and TorchBinaryImageFilter,
+ *   let their multithreader split the image region of CPU tensors
+ *   instead, and each work unit runs the operation on narrowed views
+ *   of the tensors with a single intra-op thread.  The other filters
+ *   run as with itkIntraOpParallelism.
+ *
+ * ApplyGlobalDefaultNumberOfThreads() sets ATen's intra-op and
+ * inter-op thread counts from ITK's global default number of threads,
+ * for the operations run outside of TorchImage filters.
+ *
+ * The numbers of intra-op threads per filter and per work unit are
+ * set by TorchIntraOpThreadsGuard, and only with ATen's OpenMP
+ * backend, the default of libtorch, where the number is a setting of
+ * the calling thread.  ATen's native backend shares one pool of
+ * intra-op threads, sized at the first parallel operation, among all
+ * threads, and filters leave it as it is.
+ *
+ * \code
+ * itk::TorchThreadingPolicy::GetInstance()->SetParallelism( itk::TorchThreadingPolicy::itkWorkUnitParallelism );
+ * \endcode
+ *
+ * All methods are thread safe.
+ *
+ * \sa TorchIntraOpThreadsGuard
+ *
+ * \ingroup PyTorch
+ */
+class TorchThreadingPolicy : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchThreadingPolicy );
+
+  /** Standard class type aliases */
+  using Self = TorchThreadingPolicy;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchThreadingPolicy, Object );
+
+  enum ParallelismType { itkIntraOpParallelism, itkWorkUnitParallelism };
+
+  /** The policy shared by all TorchImage filters of the process. */
+  static Self * GetInstance()
+    {
+    // Deliberately never destroyed, like TorchTensorPool.
+    static Self * const instance = []()
+      {
+      Pointer policy = Self::New();
+      policy->Register();
+      return policy.GetPointer();
+      }();
+    return instance;
+    }
+
+  /** How TorchImage filters parallelize.  Defaults to
+   * itkIntraOpParallelism. */
+  void SetParallelism( ParallelismType parallelism )
+    {
+    if( m_Parallelism.exchange( parallelism ) != parallelism )
+      {
+      this->Modified();
+      }
+    }
+  ParallelismType GetParallelism() const
+    {
+    return m_Parallelism;
+    }
+
+  /** Set ATen's process-wide numbers of intra-op and inter-op threads
+   * to ITK's global default number of threads.  ATen lets the inter-op threads be set only once, before
+   * any inter-op work; later calls leave them as they are. */
+  void ApplyGlobalDefaultNumberOfThreads()
+    {
+    const int numberOfThreads = static_cast< int >( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() );
+    at::set_num_threads( numberOfThreads );
+    bool expected = false;
+    if( m_InterOpThreadsSet.compare_exchange_strong( expected, true ) )
+      {
+      try
+        {
+        at::set_num_interop_threads( numberOfThreads );
+        }
+      catch( const c10::Error & error )
+        {
+        itkWarningMacro( << "The number of inter-op threads is already fixed: " << error.what_without_backtrace() );
+        }
+      }
+    }
+
+  /** The number of intra-op threads for the operations of a filter on
+   * whole images. */
+  int GetNumberOfIntraOpThreads( const ProcessObject * filter ) const
+    {
+    const ThreadIdType numberOfThreads =
+      std::min( filter->GetNumberOfWorkUnits(), filter->GetMultiThreader()->GetMaximumNumberOfThreads() );
+    return std::max( static_cast< int >( numberOfThreads ), 1 );
+    }
+
+  /** Whether a filter whose pixels are independent of each other should
+   * split the region of a tensor among its work units. */
+  bool SplitsRegion( const ProcessObject * filter, const torch::Tensor & tensor ) const
+    {
+    return m_Parallelism == itkWorkUnitParallelism && tensor.device().is_cpu() && filter->GetNumberOfWorkUnits() > 1;
+    }
+
+protected:
+  TorchThreadingPolicy() = default;
+  ~TorchThreadingPolicy() override = default;
+
+  void PrintSelf( std::ostream & os, Indent indent ) const override
+    {
+    Superclass::PrintSelf( os, indent );
+    os
+      << indent << "m_Parallelism: " << m_Parallelism.load() << std::endl
+      << indent << "m_InterOpThreadsSet: " << m_InterOpThreadsSet.load() << std::endl
+      << indent << "Intra-op threads of this thread: " << at::get_num_threads() << std::endl
+      << indent << "Inter-op threads: " << at::get_num_interop_threads() << std::endl
+      ;
+    }
+
+private:
+  std::atomic< ParallelismType > m_Parallelism{ itkIntraOpParallelism };
+  std::atomic< bool > m_InterOpThreadsSet{ false };
+};
+
+/** \class TorchIntraOpThreadsGuard
+ *  \brief Set the OpenMP number of threads of the calling thread for the lifetime of the guard.
+ *
+ * With ATen's OpenMP backend, the guard sets the OpenMP number of
+ * threads of the calling thread only, which ATen operations started
+ * from the thread use as their number of intra-op threads, and
+ * restores the previous number on destruction.  It does not call
+ * at::set_num_threads(), which also sets the process-wide numbers of
+ * ATen and MKL, so guards in concurrent work units do not race.  With
+ * the other backends, whose number of intra-op threads is
+ * process-wide, the guard does nothing.
+ *
+ * TorchImage filters hold a guard for the filter, with the number of
+ * threads given by TorchThreadingPolicy, while they compute, and one
+ * for a single thread in each work unit of a split region.
+ *
+ * \ingroup PyTorch
+ */
+class TorchIntraOpThreadsGuard
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchIntraOpThreadsGuard );
+
+  // Reading the number first also lets ATen initialize the setting of
+  // a new thread, which would otherwise overwrite the guard's at the
+  // first parallel operation.
+  explicit TorchIntraOpThreadsGuard( int numberOfThreads )
+    : m_PreviousNumberOfThreads( at::get_num_threads() )
+    {
+#if AT_PARALLEL_OPENMP
+    if( numberOfThreads != m_PreviousNumberOfThreads )
+      {
+      omp_set_num_threads( numberOfThreads );
+      }
+#else
+    (void)numberOfThreads;
+#endif
+    }
+
+  explicit TorchIntraOpThreadsGuard( const ProcessObject * filter )
+    : TorchIntraOpThreadsGuard( TorchThreadingPolicy::GetInstance()->GetNumberOfIntraOpThreads( filter ) )
+    {
+    }
+
+  ~TorchIntraOpThreadsGuard()
+    {
+#if AT_PARALLEL_OPENMP
+    if( omp_get_max_threads() != m_PreviousNumberOfThreads )
+      {
+      omp_set_num_threads( m_PreviousNumberOfThreads );
+      }
+#endif
+    }
+
+private:
+  const int m_PreviousNumberOfThreads;
+};
+} // end namespace itk
+
+#endif
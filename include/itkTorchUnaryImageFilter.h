@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchUnaryImageFilter_h
+#define itkTorchUnaryImageFilter_h
+
+#include "itkInPlaceImageFilter.h"
+#include "itkTorchImage.h"
+#include "itkTorchFunctors.h"
+
+namespace itk
+{
+/** \class TorchUnaryImageFilter
+ *  \brief Apply a tensor functor to a TorchImage.
+ *
+ * TorchUnaryImageFilter computes its output by applying a functor from
+ * the TorchFunctor namespace to the whole tensor of its input, as one
+ * vectorized ATen operation on the device of the input, rather than
+ * one pixel at a time.  The output has the device and component
+ * layout of the input.  The components of vector pixels are computed
+ * like any other tensor elements.
+ *
+ * If the deep scalar types of the input and output differ, the input
+ * tensor is converted to that of the output before the functor is
+ * applied.
+ *
+ * With InPlace on and equal input and output types, the functor
+ * writes into the tensor of the input, which becomes the output, and
+ * no tensor is allocated.
+ *
+ * The whole image is always computed: as one operation with the
+ * number of ATen threads given by TorchThreadingPolicy or, with its
+ * itkWorkUnitParallelism and a CPU tensor, split by the multithreader
+ * of the filter into regions whose narrowed views are computed by one
+ * ATen thread each.
+ *
+ * \sa TorchBinaryImageFilter
+ *
+ * \ingroup PyTorch
+ */
+template< typename TInputImage, typename TOutputImage, typename TFunctor >
+class ITK_TEMPLATE_EXPORT TorchUnaryImageFilter : public InPlaceImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN( TorchUnaryImageFilter );
+
+  /** Standard class type aliases */
+  using Self = TorchUnaryImageFilter;
+  using Superclass = InPlaceImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TorchUnaryImageFilter, InPlaceImageFilter );
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using FunctorType = TFunctor;
+
+  static_assert( InputImageType::TorchImagePixelHelper::SizeOf == OutputImageType::TorchImagePixelHelper::SizeOf
+    && InputImageType::PixelDimension == OutputImageType::PixelDimension,
+    "TorchUnaryImageFilter requires input and output pixels with the same components" );
+
+  /** Get the functor object.  The functor is returned by reference so
+   * that its parameters can be set; call Modified() afterwards. */
+  FunctorType & GetFunctor()
+    {
+    return m_Functor;
+    }
+  const FunctorType & GetFunctor() const
+    {
+    return m_Functor;
+    }
+
+  /** Set the functor object. */
+  void SetFunctor( const FunctorType & functor )
+    {
+    m_Functor = functor;
+    this->Modified();
+    }
+
+protected:
+  TorchUnaryImageFilter() = default;
+  ~TorchUnaryImageFilter() override = default;
+
+  /** The whole image is computed. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  /** The output takes the device and component layout of the input. */
+  void AllocateOutputs() override;
+
+  void GenerateData() override;
+
+private:
+  FunctorType m_Functor;
+};
+
+/** Unary TorchImage filters of the functors in TorchFunctor.  The
+ * functor parameters are set through GetFunctor(). */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+using TorchAbsImageFilter = TorchUnaryImageFilter< TInputImage, TOutputImage, TorchFunctor::Abs >;
+template< typename TInputImage, typename TOutputImage = TInputImage >
+using TorchExpImageFilter = TorchUnaryImageFilter< TInputImage, TOutputImage, TorchFunctor::Exp >;
+template< typename TInputImage, typename TOutputImage = TInputImage >
+using TorchLogImageFilter = TorchUnaryImageFilter< TInputImage, TOutputImage, TorchFunctor::Log >;
+template< typename TInputImage, typename TOutputImage = TInputImage >
+using TorchClampImageFilter = TorchUnaryImageFilter< TInputImage, TOutputImage, TorchFunctor::Clamp >;
+template< typename TInputImage, typename TOutputImage = TInputImage >
+using TorchThresholdImageFilter = TorchUnaryImageFilter< TInputImage, TOutputImage, TorchFunctor::Threshold >;
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTorchUnaryImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchUnaryImageFilter_hxx
+#define itkTorchUnaryImageFilter_hxx
+
+#include "itkTorchUnaryImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage, typename TFunctor >
+void
+TorchUnaryImageFilter< TInputImage, TOutputImage, TFunctor >
+::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TFunctor >
+void
+TorchUnaryImageFilter< TInputImage, TOutputImage, TFunctor >
+::AllocateOutputs()
+{
+  // When running in place, the graft of the input replaces these.
+  this->GetOutput()->CopyTensorInformation( this->GetInput() );
+  Superclass::AllocateOutputs();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TFunctor >
+void
+TorchUnaryImageFilter< TInputImage, TOutputImage, TFunctor >
+::GenerateData()
+{
+  this->AllocateOutputs();
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  if( !input->GetTensor().defined() )
+    {
+    itkExceptionMacro( << "The input TorchImage is not allocated" );
+    }
+
+  // Running in place on a clone, or on the source of one, writes to
+  // pixels of the output's own.
+  if( this->GetRunningInPlace() )
+    {
+    output->MakeTensorWritable();
+    }
+
+  // When running in place the output tensor is an alias of the input
+  // tensor, and is passed as both so that functors can tell.
+  torch::Tensor target = output->GetTensor();
+  const torch::Tensor source =
+    this->GetRunningInPlace() ? target : input->GetTensor().to( OutputImageType::TorchValueType );
+  if( TorchThreadingPolicy::GetInstance()->SplitsRegion( this, target ) )
+    {
+    const typename OutputImageType::RegionType bufferedRegion = output->GetBufferedRegion();
+    const auto componentLayout = output->GetComponentLayout();
+    this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+    this->GetMultiThreader()->template ParallelizeImageRegion< OutputImageType::ImageDimension >( bufferedRegion,
+      [&]( const typename OutputImageType::RegionType & region )
+        {
+        const TorchIntraOpThreadsGuard threadsGuard( 1 );
+        torch::Tensor targetRegion = OutputImageType::NarrowToRegion( target, componentLayout, bufferedRegion, region );
+        m_Functor( targetRegion, this->GetRunningInPlace()
+          ? targetRegion : OutputImageType::NarrowToRegion( source, componentLayout, bufferedRegion, region ) );
+        }, this );
+    }
+  else
+    {
+    const TorchIntraOpThreadsGuard threadsGuard( this );
+    m_Functor( target, source );
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -14,12 +14,21 @@ file(READ "${MY_CURRENT_DIR}/README.md" DOCUMENTATION)
 itk_module(PyTorch
   DEPENDS
     ITKCommon
+    ITKIOImageBase
     ITKStatistics
+    ITKTransform
   COMPILE_DEPENDS
     ITKImageSources
   TEST_DEPENDS
     ITKTestKernel
     ITKMetaIO
+    ITKSmoothing
+    ITKConvolution
+    ITKImageGrid
+    ITKImageStatistics
+    ITKMathematicalMorphology
+    ITKBinaryMathematicalMorphology
+    ITKImageGradient
   DESCRIPTION
     "${DOCUMENTATION}"
   EXCLUDE_FROM_DEFAULT
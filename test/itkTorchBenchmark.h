@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTorchBenchmark_h
+#define itkTorchBenchmark_h
+
+#include "itkTimeProbe.h"
+#include "itkVersion.h"
+
+#include <fstream>
+#include <string>
+#include <torch/torch.h>
+#include <torch/version.h>
+#include <vector>
+
+namespace itk
+{
+/** \class TorchBenchmark
+ *  \brief Time operations of the PyTorch module and write the times as JSON.
+ *
+ * Each call of Time() runs an operation once to warm up caches and
+ * allocators, then NumberOfRepeats times under a TimeProbe, and keeps
+ * the mean, minimum and standard deviation of the repeats.  Write()
+ * saves them, with the ITK and libtorch versions and the number of
+ * ATen threads, as one JSON object:
+ *
+ * \code
+ * { "suite": "...", "itk_version": "...", "torch_version": "...", "threads": 8,
+ *   "results": [ { "name": "Allocate", "variant": "itkZeros", "pixel": "float",
+ *                  "dimension": 3, "pixels": 2097152, "repeats": 10,
+ *                  "mean_seconds": ..., "min_seconds": ..., "stddev_seconds": ...,
+ *                  "pixels_per_second": ... }, ... ] }
+ * \endcode
+ *
+ * so that the results of two releases can be compared entry by entry.
+ *
+ * \ingroup PyTorch
+ */
+class TorchBenchmark
+{
+public:
+  explicit TorchBenchmark( const std::string & suite, unsigned int numberOfRepeats = 10 )
+    : m_Suite( suite ),
+      m_NumberOfRepeats( numberOfRepeats )
+    {
+    }
+
+  /** Time operation, which processes numberOfPixels pixels. */
+  template< typename TOperation >
+  void Time( const std::string & name, const std::string & variant, const std::string & pixel, unsigned int dimension,
+    uint64_t numberOfPixels, TOperation && operation )
+    {
+    operation();
+    TimeProbe probe;
+    for( unsigned int repeat = 0; repeat < m_NumberOfRepeats; ++repeat )
+      {
+      probe.Start();
+      operation();
+      probe.Stop();
+      }
+    Result result;
+    result.m_Name = name;
+    result.m_Variant = variant;
+    result.m_Pixel = pixel;
+    result.m_Dimension = dimension;
+    result.m_NumberOfPixels = numberOfPixels;
+    result.m_MeanSeconds = probe.GetMean();
+    result.m_MinimumSeconds = probe.GetMinimum();
+    result.m_StandardDeviationSeconds = probe.GetStandardDeviation();
+    m_Results.push_back( result );
+    std::cout << name << " " << variant << " " << pixel << " " << dimension << "D: " << result.m_MeanSeconds << " s, "
+      << numberOfPixels / result.m_MeanSeconds << " pixels/s" << std::endl;
+    }
+
+  /** Write the results to fileName.  Returns false if the file cannot
+   * be written. */
+  bool Write( const std::string & fileName ) const
+    {
+    std::ofstream file( fileName );
+    if( !file )
+      {
+      return false;
+      }
+    file.precision( 9 );
+    file << "{\n"
+      << "  \"suite\": \"" << m_Suite << "\",\n"
+      << "  \"itk_version\": \"" << Version::GetITKVersion() << "\",\n"
+      << "  \"torch_version\": \"" << TORCH_VERSION_MAJOR << "." << TORCH_VERSION_MINOR << "." << TORCH_VERSION_PATCH
+      << "\",\n"
+      << "  \"threads\": " << at::get_num_threads() << ",\n"
+      << "  \"results\": [";
+    for( size_t i = 0; i < m_Results.size(); ++i )
+      {
+      const Result & result = m_Results[i];
+      file << ( i == 0 ? "\n" : ",\n" )
+        << "    { \"name\": \"" << result.m_Name << "\", \"variant\": \"" << result.m_Variant << "\", \"pixel\": \""
+        << result.m_Pixel << "\", \"dimension\": " << result.m_Dimension << ", \"pixels\": " << result.m_NumberOfPixels
+        << ", \"repeats\": " << m_NumberOfRepeats << ", \"mean_seconds\": " << result.m_MeanSeconds
+        << ", \"min_seconds\": " << result.m_MinimumSeconds << ", \"stddev_seconds\": "
+        << result.m_StandardDeviationSeconds << ", \"pixels_per_second\": "
+        << result.m_NumberOfPixels / result.m_MeanSeconds << " }";
+      }
+    file << "\n  ]\n}\n";
+    return static_cast< bool >( file );
+    }
+
+private:
+  struct Result
+  {
+    std::string m_Name;
+    std::string m_Variant;
+    std::string m_Pixel;
+    unsigned int m_Dimension;
+    uint64_t m_NumberOfPixels;
+    double m_MeanSeconds;
+    double m_MinimumSeconds;
+    double m_StandardDeviationSeconds;
+  };
+
+  std::string m_Suite;
+  unsigned int m_NumberOfRepeats;
+  std::vector< Result > m_Results;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBinaryImageFilter.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+#include <limits>
+
+int itkTorchBinaryImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+
+  ImageType::SizeType size;
+  size[0] = 9;
+  size[1] = 8;
+  size[2] = 7;
+  const auto makeImage = [&size]( const torch::Tensor & tensor )
+    {
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions( size );
+    image->SetTensor( tensor );
+    return image;
+    };
+  const torch::Tensor tensor1 = torch::randn( { 7, 8, 9 } );
+  const torch::Tensor tensor2 = torch::randn( { 7, 8, 9 } );
+  ImageType::Pointer image1 = makeImage( tensor1.clone() );
+  ImageType::Pointer image2 = makeImage( tensor2.clone() );
+
+  // Two images.
+  using AddFilterType = itk::TorchAddImageFilter< ImageType >;
+  AddFilterType::Pointer addFilter = AddFilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( addFilter, TorchBinaryImageFilter, InPlaceImageFilter );
+  addFilter->SetInput1( image1 );
+  ITK_TRY_EXPECT_EXCEPTION( addFilter->Update() );
+  addFilter->SetInput2( image2 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( addFilter->Update() );
+  itkAssertOrThrowMacro( torch::equal( addFilter->GetOutput()->GetTensor(), tensor1 + tensor2 ),
+    "TorchAddImageFilter is wrong" );
+
+  // The second image must be buffered in the region of the output.
+  ImageType::SizeType smallerSize = size;
+  smallerSize[0] = 8;
+  ImageType::Pointer smallerImage = ImageType::New();
+  smallerImage->SetRegions( smallerSize );
+  smallerImage->Allocate( ImageType::itkZeros );
+  addFilter->SetInput2( smallerImage );
+  ITK_TRY_EXPECT_EXCEPTION( addFilter->Update() );
+  addFilter->SetInput2( image2 );
+
+  // A constant, in place.
+  using SubtractFilterType = itk::TorchSubtractImageFilter< ImageType >;
+  SubtractFilterType::Pointer subtractFilter = SubtractFilterType::New();
+  subtractFilter->SetInput1( image1 );
+  subtractFilter->SetConstant2( 2.5f );
+  ITK_TEST_SET_GET_VALUE( 2.5f, subtractFilter->GetConstant2() );
+  ITK_TEST_EXPECT_TRUE( subtractFilter->GetUseConstant2() );
+  subtractFilter->InPlaceOn();
+  const void * const storage = image1->GetTensor().data_ptr();
+  ITK_TRY_EXPECT_NO_EXCEPTION( subtractFilter->Update() );
+  itkAssertOrThrowMacro( subtractFilter->GetOutput()->GetTensor().data_ptr() == storage,
+    "TorchSubtractImageFilter did not run in place" );
+  itkAssertOrThrowMacro( torch::equal( subtractFilter->GetOutput()->GetTensor(), tensor1 - 2.5 ),
+    "TorchSubtractImageFilter is wrong" );
+
+  // Minimum and maximum.
+  image1 = makeImage( tensor1.clone() );
+  using MinimumFilterType = itk::TorchMinimumImageFilter< ImageType >;
+  MinimumFilterType::Pointer minimumFilter = MinimumFilterType::New();
+  minimumFilter->SetInput1( image1 );
+  minimumFilter->SetInput2( image2 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( minimumFilter->Update() );
+  itkAssertOrThrowMacro( torch::equal( minimumFilter->GetOutput()->GetTensor(), torch::min( tensor1, tensor2 ) ),
+    "TorchMinimumImageFilter is wrong" );
+  using MaximumFilterType = itk::TorchMaximumImageFilter< ImageType >;
+  MaximumFilterType::Pointer maximumFilter = MaximumFilterType::New();
+  maximumFilter->SetInput1( image1 );
+  maximumFilter->SetInput2( image2 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( maximumFilter->Update() );
+  itkAssertOrThrowMacro( torch::equal( maximumFilter->GetOutput()->GetTensor(), torch::max( tensor1, tensor2 ) ),
+    "TorchMaximumImageFilter is wrong" );
+
+  // Integer division rounds toward zero.
+  using IntImageType = itk::TorchImage< int32_t, ImageDimension >;
+  IntImageType::Pointer intImage = IntImageType::New();
+  intImage->SetRegions( size );
+  intImage->SetTensor( torch::randint( -100, 100, { 7, 8, 9 }, torch::dtype( torch::kInt ) ) );
+  using DivideFilterType = itk::TorchDivideImageFilter< IntImageType >;
+  DivideFilterType::Pointer divideFilter = DivideFilterType::New();
+  divideFilter->SetInput1( intImage );
+  divideFilter->SetConstant2( 7 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( divideFilter->Update() );
+  const torch::Tensor dividend = intImage->GetTensor();
+  const torch::Tensor expectedQuotient = dividend.sign() * dividend.abs().floor_divide( 7 );
+  itkAssertOrThrowMacro( torch::equal( divideFilter->GetOutput()->GetTensor(), expectedQuotient.to( torch::kInt ) ),
+    "TorchDivideImageFilter rounds integers wrongly" );
+
+  // Also beyond the integers that float represents exactly.
+  IntImageType::Pointer largeImage = IntImageType::New();
+  largeImage->SetRegions( size );
+  largeImage->SetTensor( torch::randint( 1 << 24, std::numeric_limits< int32_t >::max(), { 7, 8, 9 },
+    torch::dtype( torch::kInt ) ) * ( torch::randint( 0, 2, { 7, 8, 9 }, torch::dtype( torch::kInt ) ) * 2 - 1 ) );
+  IntImageType::Pointer divisorImage = IntImageType::New();
+  divisorImage->SetRegions( size );
+  divisorImage->SetTensor( torch::randint( -9, 10, { 7, 8, 9 }, torch::dtype( torch::kInt ) ).abs_().add_( 1 ) );
+  divisorImage->GetTensor().select( 0, 1 ).neg_();
+  divideFilter->SetInput1( largeImage );
+  divideFilter->SetInput2( divisorImage );
+  ITK_TRY_EXPECT_NO_EXCEPTION( divideFilter->Update() );
+  const torch::Tensor largeQuotient = divideFilter->GetOutput()->GetTensor();
+  const int32_t * const largeDividends = largeImage->GetTensor().data_ptr< int32_t >();
+  const int32_t * const divisors = divisorImage->GetTensor().data_ptr< int32_t >();
+  const int32_t * const largeQuotients = largeQuotient.data_ptr< int32_t >();
+  for( int64_t i = 0; i < largeQuotient.numel(); ++i )
+    {
+    ITK_TEST_EXPECT_EQUAL( largeQuotients[i], largeDividends[i] / divisors[i] );
+    }
+
+  // Vector pixels times a vector constant or a scalar image, in either
+  // component layout.
+  using VectorPixelType = itk::Vector< float, 2 >;
+  using VectorImageType = itk::TorchImage< VectorPixelType, ImageDimension >;
+  VectorPixelType factors;
+  factors[0] = 2.0f;
+  factors[1] = -3.0f;
+  for( const VectorImageType::ComponentLayoutType componentLayout :
+         { VectorImageType::itkComponentsLast, VectorImageType::itkComponentsFirst } )
+    {
+    VectorImageType::Pointer vectorImage = VectorImageType::New();
+    vectorImage->SetRegions( size );
+    vectorImage->SetComponentLayout( componentLayout );
+    vectorImage->SetTensor( torch::randn( vectorImage->ComputeTorchSize() ) );
+    const torch::Tensor vectors =
+      VectorImageType::PermuteComponentLayout( vectorImage->GetTensor(), componentLayout, VectorImageType::itkComponentsLast );
+
+    using VectorMultiplyFilterType = itk::TorchMultiplyImageFilter< VectorImageType >;
+    VectorMultiplyFilterType::Pointer vectorMultiplyFilter = VectorMultiplyFilterType::New();
+    vectorMultiplyFilter->SetInput1( vectorImage );
+    vectorMultiplyFilter->SetConstant2( factors );
+    ITK_TRY_EXPECT_NO_EXCEPTION( vectorMultiplyFilter->Update() );
+    ITK_TEST_EXPECT_EQUAL( vectorMultiplyFilter->GetOutput()->GetComponentLayout(), componentLayout );
+    itkAssertOrThrowMacro( torch::equal( VectorImageType::PermuteComponentLayout( vectorMultiplyFilter->GetOutput()->GetTensor(),
+      componentLayout, VectorImageType::itkComponentsLast ), vectors * torch::tensor( { 2.0f, -3.0f } ) ),
+      "TorchMultiplyImageFilter with a vector constant is wrong" );
+
+    using ScalarMultiplyFilterType = itk::TorchMultiplyImageFilter< VectorImageType, ImageType >;
+    ScalarMultiplyFilterType::Pointer scalarMultiplyFilter = ScalarMultiplyFilterType::New();
+    scalarMultiplyFilter->SetInput1( vectorImage );
+    scalarMultiplyFilter->SetInput2( image2 );
+    ITK_TRY_EXPECT_NO_EXCEPTION( scalarMultiplyFilter->Update() );
+    itkAssertOrThrowMacro( torch::equal( VectorImageType::PermuteComponentLayout( scalarMultiplyFilter->GetOutput()->GetTensor(),
+      componentLayout, VectorImageType::itkComponentsLast ), vectors * tensor2.unsqueeze( -1 ) ),
+      "TorchMultiplyImageFilter with a scalar image is wrong" );
+    }
+
+  // The output stays on the device of the first input.
+  if( torch::cuda::is_available() )
+    {
+    ImageType::Pointer cudaImage = makeImage( tensor1.to( torch::kCUDA ) );
+    addFilter->SetInput1( cudaImage );
+    ITK_TRY_EXPECT_NO_EXCEPTION( addFilter->Update() );
+    itkAssertOrThrowMacro( addFilter->GetOutput()->GetTensor().is_cuda(), "TorchAddImageFilter left the GPU" );
+    itkAssertOrThrowMacro( torch::allclose( addFilter->GetOutput()->GetTensor().cpu(), tensor1 + tensor2 ),
+      "TorchAddImageFilter is wrong on the GPU" );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBinaryMorphologyImageFilter.h"
+
+#include "itkBinaryDilateImageFilter.h"
+#include "itkBinaryErodeImageFilter.h"
+#include "itkBinaryMorphologicalClosingImageFilter.h"
+#include "itkBinaryMorphologicalOpeningImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Whether the filter computes what ITKFilterType, set up with the same
+// foreground, computes with the flat structuring element of the same
+// shape and radius.
+template< typename FilterType, typename ITKFilterType >
+bool
+MatchesITK( FilterType *filter, ITKFilterType *itkFilter )
+{
+  using ImageType = typename FilterType::InputImageType;
+  using KernelType = typename ITKFilterType::KernelType;
+  const KernelType kernel = filter->GetStructuringElement() == FilterType::itkBall
+    ? KernelType::Ball( filter->GetPixelRadius() ) : KernelType::Box( filter->GetPixelRadius() );
+  itkFilter->SetInput( filter->GetInput()->ToImage() );
+  itkFilter->SetKernel( kernel );
+  itkFilter->SetForegroundValue( filter->GetForegroundValue() );
+  itkFilter->Update();
+
+  filter->Update();
+  const torch::Tensor expected = ImageType::FromImage( itkFilter->GetOutput() )->GetTensor();
+  const bool matches = torch::equal( filter->GetOutput()->GetTensor().cpu(), expected );
+  if( !matches )
+    {
+    std::cerr << "Mismatch with " << itkFilter->GetNameOfClass() << " for a "
+      << ( filter->GetStructuringElement() == FilterType::itkBall ? "ball" : "box" ) << " of radius "
+      << filter->GetPixelRadius() << std::endl;
+    }
+  return matches;
+}
+
+template< typename ImageType >
+bool
+MatchesITKForAllOperations( const ImageType *image, typename ImageType::PixelType foregroundValue,
+  typename ImageType::PixelType backgroundValue )
+{
+  using FilterType = itk::TorchBinaryMorphologyImageFilter< ImageType >;
+  using ITKImageType = typename ImageType::ITKImageType;
+  using KernelType = itk::FlatStructuringElement< ImageType::ImageDimension >;
+  using DilateType = itk::BinaryDilateImageFilter< ITKImageType, ITKImageType, KernelType >;
+  using ErodeType = itk::BinaryErodeImageFilter< ITKImageType, ITKImageType, KernelType >;
+  using OpeningType = itk::BinaryMorphologicalOpeningImageFilter< ITKImageType, ITKImageType, KernelType >;
+  using ClosingType = itk::BinaryMorphologicalClosingImageFilter< ITKImageType, ITKImageType, KernelType >;
+
+  // Radii of lines that are pooled and of lines that are iterated.
+  std::vector< typename FilterType::RadiusType > radii( 3 );
+  radii[0].Fill( 1 );
+  radii[1][0] = 2; radii[1][1] = 1; radii[1][2] = 0;
+  radii[2][0] = 6; radii[2][1] = 4; radii[2][2] = 2;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetForegroundValue( foregroundValue );
+  filter->SetBackgroundValue( backgroundValue );
+  bool matches = true;
+  for( const auto element : { FilterType::itkBox, FilterType::itkBall } )
+    {
+    filter->SetStructuringElement( element );
+    for( const auto & radius : radii )
+      {
+      filter->SetRadius( radius );
+      filter->SetOperation( FilterType::itkDilate );
+      typename DilateType::Pointer dilate = DilateType::New();
+      matches &= MatchesITK( filter.GetPointer(), dilate.GetPointer() );
+      filter->SetOperation( FilterType::itkErode );
+      typename ErodeType::Pointer erode = ErodeType::New();
+      erode->SetBackgroundValue( backgroundValue );
+      matches &= MatchesITK( filter.GetPointer(), erode.GetPointer() );
+      filter->SetOperation( FilterType::itkOpen );
+      typename OpeningType::Pointer opening = OpeningType::New();
+      opening->SetBackgroundValue( backgroundValue );
+      matches &= MatchesITK( filter.GetPointer(), opening.GetPointer() );
+      filter->SetOperation( FilterType::itkClose );
+      for( const bool safeBorder : { true, false } )
+        {
+        filter->SetSafeBorder( safeBorder );
+        typename ClosingType::Pointer closing = ClosingType::New();
+        closing->SetSafeBorder( safeBorder );
+        matches &= MatchesITK( filter.GetPointer(), closing.GetPointer() );
+        }
+      }
+    }
+  return matches;
+}
+
+} // end namespace
+
+int itkTorchBinaryMorphologyImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< unsigned char, ImageDimension >;
+  using FilterType = itk::TorchBinaryMorphologyImageFilter< ImageType >;
+
+  // Foreground blobs, some touching the border, among background pixels
+  // of other values, which are kept where the foreground does not
+  // change.
+  ImageType::SizeType size;
+  size[0] = 29;
+  size[1] = 23;
+  size[2] = 11;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  const torch::Tensor blobs = at::max_pool3d( torch::rand( { 1, 11, 23, 29 } ).gt( 0.97 ).to( torch::kFloat ),
+    { 3, 5, 5 }, { 1, 1, 1 }, { 1, 2, 2 } ).squeeze( 0 ).to( torch::kBool );
+  const torch::Tensor holes = torch::rand( { 11, 23, 29 } ).gt( 0.9 );
+  image->SetTensor( torch::randint( 100, { 11, 23, 29 }, torch::dtype( torch::kByte ) )
+    .masked_fill( blobs.logical_and( holes.logical_not() ), 255 ) );
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchBinaryMorphologyImageFilter, TorchMorphologyImageFilterBase );
+  ITK_TEST_EXPECT_EQUAL( static_cast< int >( filter->GetForegroundValue() ), 255 );
+  ITK_TEST_EXPECT_EQUAL( static_cast< int >( filter->GetBackgroundValue() ), 0 );
+  ITK_TEST_SET_GET_BOOLEAN( filter, SafeBorder, true );
+
+  ITK_TEST_EXPECT_TRUE( MatchesITKForAllOperations( image.GetPointer(), 255, 0 ) );
+  ITK_TEST_EXPECT_TRUE( MatchesITKForAllOperations( image.GetPointer(), 255, 150 ) );
+
+  // Foreground values other than the highest value of the type.
+  using FloatImageType = itk::TorchImage< float, ImageDimension >;
+  FloatImageType::Pointer floatImage = FloatImageType::New();
+  floatImage->SetRegions( size );
+  floatImage->SetTensor( image->GetTensor().to( torch::kFloat ).div( 255.0 ) );
+  ITK_TEST_EXPECT_TRUE( MatchesITKForAllOperations( floatImage.GetPointer(), 1.0f, -1.0f ) );
+
+  // The dilation of a single pixel is the structuring element.
+  ImageType::Pointer pixelImage = ImageType::New();
+  pixelImage->SetRegions( size );
+  pixelImage->Allocate( ImageType::itkZeros );
+  pixelImage->GetTensor()[5][11][14] = 255;
+  filter->SetInput( pixelImage );
+  filter->SetOperation( FilterType::itkDilate );
+  filter->SetStructuringElement( FilterType::itkBall );
+  filter->SetRadius( 4 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  const itk::FlatStructuringElement< ImageDimension > ball =
+    itk::FlatStructuringElement< ImageDimension >::Ball( filter->GetPixelRadius() );
+  ITK_TEST_EXPECT_EQUAL( filter->GetOutput()->GetTensor().eq( 255 ).sum().item< int64_t >(),
+    static_cast< int64_t >( std::count( ball.Begin(), ball.End(), true ) ) );
+
+  if( torch::cuda::is_available() )
+    {
+    image->SetDevice( ImageType::itkCUDA );
+    filter->SetInput( image );
+    filter->SetOperation( FilterType::itkClose );
+    ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    ITK_TEST_EXPECT_TRUE( filter->GetOutput()->GetTensor().is_cuda() );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchConvolutionImageFilter.h"
+
+#include "itkConvolutionImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkTorchConvolutionImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 2;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchConvolutionImageFilter< ImageType >;
+  using KernelImageType = FilterType::KernelImageType;
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  // An asymmetric kernel, so that a flipped or shifted kernel is
+  // detected.
+  KernelImageType::SizeType kernelSize;
+  kernelSize[0] = 5;
+  kernelSize[1] = 3;
+  KernelImageType::Pointer kernel = KernelImageType::New();
+  kernel->SetRegions( kernelSize );
+  kernel->SetDevice( KernelImageType::itkCPU );
+  kernel->SetTensor( torch::arange( 15, torch::dtype( torch::kFloat ) ).reshape( { 3, 5 } ) - 4.0 );
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchConvolutionImageFilter, TorchConvolutionImageFilterBase );
+  filter->SetInput( image );
+  ITK_TRY_EXPECT_EXCEPTION( filter->Update() );
+  filter->SetKernelImage( kernel );
+  ITK_TEST_SET_GET_VALUE( kernel.GetPointer(), filter->GetKernelImage() );
+
+  using ITKFilterType = itk::ConvolutionImageFilter< ImageType::ITKImageType, KernelImageType::ITKImageType >;
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  itkFilter->SetKernelImage( kernel->ToImage() );
+
+  for( const bool normalize : { false, true } )
+    {
+    filter->SetNormalize( normalize );
+    ITK_TEST_SET_GET_VALUE( normalize, filter->GetNormalize() );
+    ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    itkFilter->SetNormalize( normalize );
+    ITK_TRY_EXPECT_NO_EXCEPTION( itkFilter->Update() );
+    itkAssertOrThrowMacro( torch::allclose( filter->GetOutput()->GetTensor(),
+      ImageType::FromImage( itkFilter->GetOutput() )->GetTensor(), 1e-4, 1e-4 ),
+      "TorchConvolutionImageFilter disagrees with ConvolutionImageFilter" );
+    }
+
+  // A constant image is unchanged by a normalized kernel, also at the
+  // border, with the zero-flux Neumann boundary condition.
+  image->FillBuffer( 3.0f );
+  image->Modified();
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  itkAssertOrThrowMacro( torch::allclose( filter->GetOutput()->GetTensor(), image->GetTensor(), 1e-5, 1e-5 ),
+    "TorchConvolutionImageFilter does not replicate the border" );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
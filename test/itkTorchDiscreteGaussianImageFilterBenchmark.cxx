@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchDiscreteGaussianImageFilter.h"
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkTorchDiscreteGaussianImageFilterBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchDiscreteGaussianImageFilter< ImageType >;
+  using ITKFilterType = itk::DiscreteGaussianImageFilter< ImageType::ITKImageType, ImageType::ITKImageType >;
+
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  itk::TorchBenchmark benchmark( "TorchDiscreteGaussianImageFilter", 5 );
+  for( const double variance : { 2.0, 8.0 } )
+    {
+    const std::string variant = "variance " + std::to_string( variance );
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( image );
+    filter->SetVariance( variance );
+    benchmark.Time( "TorchDiscreteGaussianImageFilter", variant, "float", ImageDimension, numberOfPixels,
+      [&]()
+        {
+        filter->Modified();
+        filter->Update();
+        } );
+
+    ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+    itkFilter->SetInput( image->ToImage() );
+    itkFilter->SetVariance( variance );
+    benchmark.Time( "DiscreteGaussianImageFilter", variant, "float", ImageDimension, numberOfPixels,
+      [&]()
+        {
+        itkFilter->Modified();
+        itkFilter->Update();
+        } );
+    }
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
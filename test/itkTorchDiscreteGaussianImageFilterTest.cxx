@@ -0,0 +1,108 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchDiscreteGaussianImageFilter.h"
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+#include <cmath>
+#include <numeric>
+
+int itkTorchDiscreteGaussianImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchDiscreteGaussianImageFilter< ImageType >;
+
+  ImageType::SizeType size;
+  size[0] = 96;
+  size[1] = 80;
+  size[2] = 64;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  FilterType::ArrayType variance;
+  variance[0] = 2.0;
+  variance[1] = 1.5;
+  variance[2] = 6.0;
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchDiscreteGaussianImageFilter, TorchConvolutionImageFilterBase );
+  filter->SetInput( image );
+  filter->SetVariance( variance );
+  ITK_TEST_SET_GET_VALUE( variance, filter->GetVariance() );
+  ITK_TEST_SET_GET_BOOLEAN( filter, UseImageSpacing, true );
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    const std::vector< double > coefficients = filter->GetKernelCoefficients( i );
+    ITK_TEST_EXPECT_TRUE( coefficients.size() % 2 == 1 );
+    ITK_TEST_EXPECT_TRUE( std::abs( std::accumulate( coefficients.begin(), coefficients.end(), 0.0 ) - 1.0 ) < 1e-6 );
+    }
+
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  // DiscreteGaussianImageFilter computes the same on an itk::Image
+  // sharing the pixels of the TorchImage.
+  using ITKFilterType = itk::DiscreteGaussianImageFilter< ImageType::ITKImageType, ImageType::ITKImageType >;
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  itkFilter->SetVariance( variance );
+  ITK_TRY_EXPECT_NO_EXCEPTION( itkFilter->Update() );
+
+  const torch::Tensor blurred = filter->GetOutput()->GetTensor();
+  const torch::Tensor expected = ImageType::FromImage( itkFilter->GetOutput() )->GetTensor();
+  itkAssertOrThrowMacro( torch::allclose( blurred, expected, 1e-4, 1e-5 ),
+    "TorchDiscreteGaussianImageFilter disagrees with DiscreteGaussianImageFilter" );
+  ITK_TEST_EXPECT_EQUAL( filter->GetOutput()->GetSpacing(), spacing );
+
+  // Vector pixels are blurred per component, in either layout.
+  using VectorImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using VectorFilterType = itk::TorchDiscreteGaussianImageFilter< VectorImageType >;
+  for( const VectorImageType::ComponentLayoutType componentLayout :
+         { VectorImageType::itkComponentsLast, VectorImageType::itkComponentsFirst } )
+    {
+    VectorImageType::Pointer vectorImage = VectorImageType::New();
+    vectorImage->SetRegions( size );
+    vectorImage->SetSpacing( spacing );
+    vectorImage->SetComponentLayout( VectorImageType::itkComponentsLast );
+    vectorImage->SetTensor( torch::stack( { image->GetTensor(), -2.0 * image->GetTensor() }, -1 ) );
+    vectorImage->SetComponentLayout( componentLayout );
+    VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+    vectorFilter->SetInput( vectorImage );
+    vectorFilter->SetVariance( variance );
+    ITK_TRY_EXPECT_NO_EXCEPTION( vectorFilter->Update() );
+    ITK_TEST_EXPECT_EQUAL( vectorFilter->GetOutput()->GetComponentLayout(), componentLayout );
+    const torch::Tensor vectors = VectorImageType::PermuteComponentLayout( vectorFilter->GetOutput()->GetTensor(),
+      componentLayout, VectorImageType::itkComponentsLast );
+    itkAssertOrThrowMacro( torch::allclose( vectors.select( -1, 0 ), blurred, 1e-5, 1e-6 )
+      && torch::allclose( vectors.select( -1, 1 ), -2.0 * blurred, 1e-5, 1e-6 ),
+      "TorchDiscreteGaussianImageFilter blurs vector pixels wrongly" );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
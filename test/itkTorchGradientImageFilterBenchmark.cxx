@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchGradientImageFilter.h"
+#include "itkTorchGradientMagnitudeImageFilter.h"
+
+#include "itkGradientImageFilter.h"
+#include "itkGradientMagnitudeImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkTorchGradientImageFilterBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchGradientImageFilter< ImageType >;
+  using MagnitudeFilterType = itk::TorchGradientMagnitudeImageFilter< ImageType >;
+  using ITKFilterType = itk::GradientImageFilter< ImageType::ITKImageType >;
+  using ITKMagnitudeFilterType = itk::GradientMagnitudeImageFilter< ImageType::ITKImageType, ImageType::ITKImageType >;
+
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  itk::TorchBenchmark benchmark( "TorchGradientImageFilter", 5 );
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  benchmark.Time( "TorchGradientImageFilter", "", "float", ImageDimension, numberOfPixels,
+    [&]()
+      {
+      filter->Modified();
+      filter->Update();
+      } );
+
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  benchmark.Time( "GradientImageFilter", "", "float", ImageDimension, numberOfPixels,
+    [&]()
+      {
+      itkFilter->Modified();
+      itkFilter->Update();
+      } );
+
+  MagnitudeFilterType::Pointer magnitudeFilter = MagnitudeFilterType::New();
+  magnitudeFilter->SetInput( image );
+  benchmark.Time( "TorchGradientMagnitudeImageFilter", "", "float", ImageDimension, numberOfPixels,
+    [&]()
+      {
+      magnitudeFilter->Modified();
+      magnitudeFilter->Update();
+      } );
+
+  ITKMagnitudeFilterType::Pointer itkMagnitudeFilter = ITKMagnitudeFilterType::New();
+  itkMagnitudeFilter->SetInput( image->ToImage() );
+  benchmark.Time( "GradientMagnitudeImageFilter", "", "float", ImageDimension, numberOfPixels,
+    [&]()
+      {
+      itkMagnitudeFilter->Modified();
+      itkMagnitudeFilter->Update();
+      } );
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
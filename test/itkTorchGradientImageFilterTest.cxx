@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchGradientImageFilter.h"
+#include "itkTorchGradientMagnitudeImageFilter.h"
+
+#include "itkGradientImageFilter.h"
+#include "itkGradientMagnitudeImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+int itkTorchGradientImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using GradientImageType = itk::TorchImage< itk::CovariantVector< float, ImageDimension >, ImageDimension >;
+  using FilterType = itk::TorchGradientImageFilter< ImageType >;
+  using MagnitudeFilterType = itk::TorchGradientMagnitudeImageFilter< ImageType >;
+
+  ImageType::SizeType size;
+  size[0] = 96;
+  size[1] = 80;
+  size[2] = 48;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+  // A rotation about z.
+  ImageType::DirectionType direction;
+  direction.SetIdentity();
+  const double angle = 0.5;
+  direction[0][0] = std::cos( angle );
+  direction[0][1] = -std::sin( angle );
+  direction[1][0] = std::sin( angle );
+  direction[1][1] = std::cos( angle );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->SetDirection( direction );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchGradientImageFilter, TorchGradientImageFilterBase );
+  filter->SetInput( image );
+  ITK_TEST_SET_GET_BOOLEAN( filter, UseImageSpacing, true );
+  ITK_TEST_SET_GET_BOOLEAN( filter, UseImageDirection, true );
+
+  using ITKFilterType = itk::GradientImageFilter< ImageType::ITKImageType >;
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  for( const bool useImageSpacing : { true, false } )
+    {
+    for( const bool useImageDirection : { true, false } )
+      {
+      filter->SetUseImageSpacing( useImageSpacing );
+      filter->SetUseImageDirection( useImageDirection );
+      itkFilter->SetUseImageSpacing( useImageSpacing );
+      itkFilter->SetUseImageDirection( useImageDirection );
+      ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+      ITK_TRY_EXPECT_NO_EXCEPTION( itkFilter->Update() );
+
+      const torch::Tensor expected = GradientImageType::FromImage( itkFilter->GetOutput() )->GetTensor();
+      itkAssertOrThrowMacro( torch::allclose( filter->GetOutput()->GetTensor(), expected, 1e-4, 1e-5 ),
+        "TorchGradientImageFilter disagrees with GradientImageFilter" );
+      }
+    }
+  ITK_TEST_EXPECT_EQUAL( filter->GetOutput()->GetDirection(), direction );
+  const torch::Tensor gradient = filter->GetOutput()->GetTensor();
+
+  // The gradient of a ramp is constant, also at the border, where the
+  // padding halves the one-sided differences.
+  ImageType::Pointer ramp = ImageType::New();
+  ramp->SetRegions( size );
+  ramp->SetSpacing( spacing );
+  ramp->SetTensor( ( 2.0 * torch::arange( 96, torch::kFloat ).view( { 1, 1, 96 } )
+    - 3.0 * torch::arange( 80, torch::kFloat ).view( { 1, 80, 1 } ) ).expand( { 48, 80, 96 } ).contiguous() );
+  filter->SetInput( ramp );
+  filter->UseImageSpacingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  const torch::Tensor rampGradient = filter->GetOutput()->GetTensor();
+  ITK_TEST_EXPECT_TRUE( torch::allclose( rampGradient.select( -1, 0 ).narrow( 2, 1, 94 ),
+    torch::full( { 48, 80, 94 }, 2.0 / 0.8 ) ) );
+  ITK_TEST_EXPECT_TRUE( torch::allclose( rampGradient.select( -1, 1 ).narrow( 1, 1, 78 ),
+    torch::full( { 48, 78, 96 }, -3.0 ) ) );
+  ITK_TEST_EXPECT_TRUE( torch::allclose( rampGradient.select( -1, 0 ).select( 2, 0 ), torch::full( { 48, 80 }, 1.0 / 0.8 ) ) );
+  ITK_TEST_EXPECT_EQUAL( rampGradient.select( -1, 2 ).abs().max().item< float >(), 0.0f );
+
+  // The components are written in the layout of the input.
+  image->SetComponentLayout( ImageType::itkComponentsFirst );
+  filter->SetInput( image );
+  filter->UseImageSpacingOff();
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ITK_TEST_EXPECT_EQUAL( filter->GetOutput()->GetComponentLayout(), GradientImageType::itkComponentsFirst );
+  ITK_TEST_EXPECT_TRUE( filter->GetOutput()->GetTensor().sizes() == torch::IntArrayRef( { 3, 48, 80, 96 } ) );
+  ITK_TEST_EXPECT_TRUE( torch::allclose( GradientImageType::PermuteComponentLayout( filter->GetOutput()->GetTensor(),
+    GradientImageType::itkComponentsFirst, GradientImageType::itkComponentsLast ), gradient, 1e-5, 1e-6 ) );
+  image->SetComponentLayout( ImageType::itkComponentsLast );
+
+  // The magnitude needs no gradient image.
+  MagnitudeFilterType::Pointer magnitudeFilter = MagnitudeFilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( magnitudeFilter, TorchGradientMagnitudeImageFilter, TorchGradientImageFilterBase );
+  magnitudeFilter->SetInput( image );
+  using ITKMagnitudeFilterType = itk::GradientMagnitudeImageFilter< ImageType::ITKImageType, ImageType::ITKImageType >;
+  ITKMagnitudeFilterType::Pointer itkMagnitudeFilter = ITKMagnitudeFilterType::New();
+  itkMagnitudeFilter->SetInput( image->ToImage() );
+  for( const bool useImageSpacing : { true, false } )
+    {
+    magnitudeFilter->SetUseImageSpacing( useImageSpacing );
+    itkMagnitudeFilter->SetUseImageSpacing( useImageSpacing );
+    ITK_TRY_EXPECT_NO_EXCEPTION( magnitudeFilter->Update() );
+    ITK_TRY_EXPECT_NO_EXCEPTION( itkMagnitudeFilter->Update() );
+    const torch::Tensor expected = ImageType::FromImage( itkMagnitudeFilter->GetOutput() )->GetTensor();
+    itkAssertOrThrowMacro( torch::allclose( magnitudeFilter->GetOutput()->GetTensor(), expected, 1e-4, 1e-5 ),
+      "TorchGradientMagnitudeImageFilter disagrees with GradientMagnitudeImageFilter" );
+    }
+  ITK_TEST_EXPECT_TRUE( torch::allclose( magnitudeFilter->GetOutput()->GetTensor(), gradient.norm( 2, -1 ), 1e-4, 1e-5 ) );
+
+  if( torch::cuda::is_available() )
+    {
+    image->SetDevice( ImageType::itkCUDA );
+    ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    ITK_TEST_EXPECT_TRUE( filter->GetOutput()->GetTensor().is_cuda() );
+    itkAssertOrThrowMacro( torch::allclose( filter->GetOutput()->GetTensor().cpu(), gradient, 1e-4, 1e-5 ),
+      "TorchGradientImageFilter disagrees on CUDA" );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
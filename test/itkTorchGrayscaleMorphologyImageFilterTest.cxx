@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchGrayscaleMorphologyImageFilter.h"
+
+#include "itkFlatStructuringElement.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkGrayscaleMorphologicalClosingImageFilter.h"
+#include "itkGrayscaleMorphologicalOpeningImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+// Whether the filter computes what ITKFilterType computes with the
+// flat structuring element of the same shape and radius.
+template< typename ITKFilterType, typename FilterType >
+bool
+MatchesITK( FilterType *filter )
+{
+  using ImageType = typename FilterType::InputImageType;
+  using KernelType = typename ITKFilterType::KernelType;
+  const KernelType kernel = filter->GetStructuringElement() == FilterType::itkBall
+    ? KernelType::Ball( filter->GetPixelRadius() ) : KernelType::Box( filter->GetPixelRadius() );
+  typename ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( filter->GetInput()->ToImage() );
+  itkFilter->SetKernel( kernel );
+  itkFilter->Update();
+
+  filter->Update();
+  const torch::Tensor expected = ImageType::FromImage( itkFilter->GetOutput() )->GetTensor();
+  const bool matches = torch::equal( filter->GetOutput()->GetTensor().cpu(), expected );
+  if( !matches )
+    {
+    std::cerr << "Mismatch with " << itkFilter->GetNameOfClass() << " for a "
+      << ( filter->GetStructuringElement() == FilterType::itkBall ? "ball" : "box" ) << " of radius "
+      << filter->GetPixelRadius() << std::endl;
+    }
+  return matches;
+}
+
+template< typename ImageType >
+bool
+MatchesITKForAllOperations( const ImageType *image )
+{
+  using FilterType = itk::TorchGrayscaleMorphologyImageFilter< ImageType >;
+  using ITKImageType = typename ImageType::ITKImageType;
+  using KernelType = itk::FlatStructuringElement< ImageType::ImageDimension >;
+
+  // Radii of lines that are pooled, of lines that are iterated, and of
+  // an element larger than a dimension of the image.
+  std::vector< typename FilterType::RadiusType > radii( 3 );
+  radii[0][0] = 1; radii[0][1] = 2; radii[0][2] = 0;
+  radii[1][0] = 9; radii[1][1] = 5; radii[1][2] = 2;
+  radii[2][0] = 4; radii[2][1] = 3; radii[2][2] = 20;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  bool matches = true;
+  for( const auto element : { FilterType::itkBox, FilterType::itkBall } )
+    {
+    filter->SetStructuringElement( element );
+    for( const auto & radius : radii )
+      {
+      filter->SetRadius( radius );
+      filter->SetOperation( FilterType::itkDilate );
+      matches &= MatchesITK< itk::GrayscaleDilateImageFilter< ITKImageType, ITKImageType, KernelType > >(
+        filter.GetPointer() );
+      filter->SetOperation( FilterType::itkErode );
+      matches &= MatchesITK< itk::GrayscaleErodeImageFilter< ITKImageType, ITKImageType, KernelType > >(
+        filter.GetPointer() );
+      filter->SetOperation( FilterType::itkOpen );
+      matches &= MatchesITK< itk::GrayscaleMorphologicalOpeningImageFilter< ITKImageType, ITKImageType, KernelType > >(
+        filter.GetPointer() );
+      filter->SetOperation( FilterType::itkClose );
+      matches &= MatchesITK< itk::GrayscaleMorphologicalClosingImageFilter< ITKImageType, ITKImageType, KernelType > >(
+        filter.GetPointer() );
+      }
+    }
+  return matches;
+}
+
+} // end namespace
+
+int itkTorchGrayscaleMorphologyImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchGrayscaleMorphologyImageFilter< ImageType >;
+
+  ImageType::SizeType size;
+  size[0] = 31;
+  size[1] = 24;
+  size[2] = 13;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchGrayscaleMorphologyImageFilter, TorchMorphologyImageFilterBase );
+  ITK_TEST_EXPECT_EQUAL( filter->GetOperation(), FilterType::itkDilate );
+  ITK_TEST_EXPECT_EQUAL( filter->GetStructuringElement(), FilterType::itkBox );
+  ITK_TEST_EXPECT_EQUAL( filter->GetRadius()[0], 1 );
+  ITK_TEST_EXPECT_TRUE( filter->GetSafeBorder() );
+  ITK_TEST_SET_GET_BOOLEAN( filter, SafeBorder, true );
+
+  // Floating point images, whose short lines are pooled, and integer
+  // images, whose lines are all iterated.
+  ITK_TEST_EXPECT_TRUE( MatchesITKForAllOperations( image.GetPointer() ) );
+  using ByteImageType = itk::TorchImage< unsigned char, ImageDimension >;
+  ByteImageType::Pointer byteImage = ByteImageType::New();
+  byteImage->SetRegions( size );
+  byteImage->SetTensor( torch::randint( 256, { 13, 24, 31 }, torch::dtype( torch::kByte ) ) );
+  ITK_TEST_EXPECT_TRUE( MatchesITKForAllOperations( byteImage.GetPointer() ) );
+
+  // Without a safe border, structures touching the border survive the
+  // opening.
+  filter->SetInput( image );
+  filter->SetOperation( FilterType::itkOpen );
+  filter->SetStructuringElement( FilterType::itkBall );
+  filter->SetRadius( 3 );
+  filter->SafeBorderOff();
+  using ITKOpeningType =
+    itk::GrayscaleMorphologicalOpeningImageFilter< ImageType::ITKImageType, ImageType::ITKImageType,
+    itk::FlatStructuringElement< ImageDimension > >;
+  ITKOpeningType::Pointer itkOpening = ITKOpeningType::New();
+  itkOpening->SetSafeBorder( false );
+  itkOpening->SetInput( image->ToImage() );
+  itkOpening->SetKernel( itk::FlatStructuringElement< ImageDimension >::Ball( filter->GetPixelRadius() ) );
+  ITK_TRY_EXPECT_NO_EXCEPTION( itkOpening->Update() );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ITK_TEST_EXPECT_TRUE( torch::equal( filter->GetOutput()->GetTensor(),
+    ImageType::FromImage( itkOpening->GetOutput() )->GetTensor() ) );
+
+  // A radius in physical units is rounded down to whole pixels.
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.0;
+  spacing[2] = 2.5;
+  image->SetSpacing( spacing );
+  FilterType::PhysicalRadiusType physicalRadius;
+  physicalRadius.Fill( 2.0 );
+  filter->SetPhysicalRadius( physicalRadius );
+  ITK_TEST_SET_GET_BOOLEAN( filter, UsePhysicalRadius, true );
+  const FilterType::RadiusType pixelRadius = filter->GetPixelRadius();
+  ITK_TEST_EXPECT_EQUAL( pixelRadius[0], 4 );
+  ITK_TEST_EXPECT_EQUAL( pixelRadius[1], 2 );
+  ITK_TEST_EXPECT_EQUAL( pixelRadius[2], 0 );
+  filter->SetOperation( FilterType::itkDilate );
+  filter->SetStructuringElement( FilterType::itkBox );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ITK_TEST_EXPECT_TRUE( torch::equal( filter->GetOutput()->GetTensor(),
+    at::max_pool2d( image->GetTensor(), { 5, 9 }, { 1, 1 }, { 2, 4 } ) ) );
+
+  if( torch::cuda::is_available() )
+    {
+    image->SetDevice( ImageType::itkCUDA );
+    ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    ITK_TEST_EXPECT_TRUE( filter->GetOutput()->GetTensor().is_cuda() );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchImageBatch.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchImageBatchTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  constexpr unsigned int VectorDimension = 2;
+  using PixelType = itk::Vector< float, VectorDimension >;
+  using BatchType = itk::TorchImageBatch< PixelType, ImageDimension >;
+  using ImageType = BatchType::ImageType;
+
+  BatchType::Pointer batch = BatchType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( batch, TorchImageBatch, Object );
+
+  ImageType::SizeType size;
+  size[0] = 6;
+  size[1] = 5;
+  size[2] = 4;
+  const ImageType::RegionType region( size );
+  batch->SetRegion( region );
+  ITK_TEST_SET_GET_VALUE( region, batch->GetRegion() );
+  batch->Allocate( 3, ImageType::itkZeros );
+  ITK_TEST_EXPECT_EQUAL( batch->GetNumberOfImages(), 3 );
+
+  // The batch tensor is [N, D, H, W, C].
+  const std::vector< int64_t > expectedSizes = { 3, 4, 5, 6, 2 };
+  itkAssertOrThrowMacro( batch->GetTensor().sizes() == torch::IntArrayRef( expectedSizes ),
+    "TorchImageBatch::Allocate made a tensor of the wrong sizes" );
+  itkAssertOrThrowMacro( batch->GetTensor().is_contiguous(), "TorchImageBatch tensor is not contiguous" );
+
+  // Each image is a view of its slice of the batch, with its own geometry.
+  ImageType::IndexType index;
+  index[0] = 5;
+  index[1] = 1;
+  index[2] = 3;
+  PixelType value;
+  value[0] = 3.0f;
+  value[1] = -3.0f;
+  batch->GetImage( 1 )->SetPixel( index, value );
+  itkAssertOrThrowMacro( batch->GetTensor()[1][3][1][5][1].item< float >() == -3.0f,
+    "TorchImageBatch image is not a view of the batch tensor" );
+  ImageType::PointType origin;
+  origin.Fill( 7.0 );
+  batch->GetImage( 2 )->SetOrigin( origin );
+  itkAssertOrThrowMacro( batch->GetImage( 0 )->GetOrigin() != origin, "TorchImageBatch images share geometry" );
+  ITK_TRY_EXPECT_EXCEPTION( batch->GetImage( 3 ) );
+
+  // Stack existing images, keeping their geometry.
+  std::vector< ImageType::ConstPointer > images;
+  for( unsigned int i = 0; i < 2; ++i )
+    {
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions( region );
+    image->Allocate();
+    PixelType fillValue;
+    fillValue.Fill( static_cast< float >( i + 1 ) );
+    image->FillBuffer( fillValue );
+    ImageType::SpacingType spacing;
+    spacing.Fill( 0.5 * ( i + 1 ) );
+    image->SetSpacing( spacing );
+    images.push_back( image.GetPointer() );
+    }
+  batch->Stack( images );
+  ITK_TEST_EXPECT_EQUAL( batch->GetNumberOfImages(), 2 );
+  ITK_TEST_EXPECT_EQUAL( batch->GetCapacity(), 2 );
+  for( unsigned int i = 0; i < 2; ++i )
+    {
+    itkAssertOrThrowMacro( batch->GetImage( i )->GetSpacing() == images[i]->GetSpacing(),
+      "TorchImageBatch::Stack lost the spacing" );
+    const PixelType pixelValue = batch->GetImage( i )->GetPixel( index );
+    itkAssertOrThrowMacro( pixelValue[0] == static_cast< float >( i + 1 ), "TorchImageBatch::Stack lost the pixels" );
+    }
+
+  // Appending after use grows the batch in place: the existing images
+  // keep their pixels and keep aliasing the batch.
+  ImageType::Pointer firstImage = batch->GetImage( 0 );
+  const torch::Tensor firstTensor = firstImage->GetTensor();
+  firstImage->SetPixel( index, value );
+  batch->AppendImage( images[1] );
+  ITK_TEST_EXPECT_EQUAL( batch->GetNumberOfImages(), 3 );
+  ITK_TEST_EXPECT_EQUAL( batch->GetCapacity(), 4 );
+  itkAssertOrThrowMacro( batch->GetTensor().size( 0 ) == 3, "TorchImageBatch::AppendImage failed" );
+  ITK_TEST_EXPECT_TRUE( batch->GetImage( 0 ) == firstImage.GetPointer() );
+  const PixelType pixelValue = batch->GetImage( 0 )->GetPixel( index );
+  itkAssertOrThrowMacro( pixelValue == value, "TorchImageBatch::AppendImage lost the pixels of an existing image" );
+  firstImage->FillBuffer( value );
+  itkAssertOrThrowMacro( torch::equal( batch->GetTensor()[0], firstImage->GetTensor() )
+    && torch::equal( firstTensor, firstImage->GetTensor() ),
+    "An image of a TorchImageBatch stopped aliasing the batch when it grew" );
+
+  // Images are copied as they are appended, so later writes to them
+  // do not reach the batch.
+  ImageType::Pointer source = ImageType::New();
+  source->Graft( images[0] );
+  batch->AppendImage( source );
+  PixelType sourceValue;
+  sourceValue.Fill( 42.0f );
+  source->FillBuffer( sourceValue );
+  const PixelType appendedValue = batch->GetImage( 3 )->GetPixel( index );
+  itkAssertOrThrowMacro( appendedValue[0] == 1.0f, "A write to an appended image reached the batch" );
+  ITK_TEST_EXPECT_EQUAL( batch->GetCapacity(), 4 );
+
+  // A components-first batch is [N, C, D, H, W]; appended images are
+  // permuted as they are copied.
+  BatchType::Pointer firstBatch = BatchType::New();
+  firstBatch->SetComponentLayout( ImageType::itkComponentsFirst );
+  firstBatch->AppendImage( batch->GetImage( 0 ) );
+  const std::vector< int64_t > expectedFirstSizes = { 1, 2, 4, 5, 6 };
+  itkAssertOrThrowMacro( firstBatch->GetTensor().sizes() == torch::IntArrayRef( expectedFirstSizes ),
+    "TorchImageBatch with itkComponentsFirst has the wrong tensor sizes" );
+  const PixelType firstPixelValue = firstBatch->GetImage( 0 )->GetPixel( index );
+  itkAssertOrThrowMacro( firstPixelValue == value, "TorchImageBatch with itkComponentsFirst lost the pixels" );
+
+  // Images of a different size are rejected.
+  ImageType::Pointer smallImage = ImageType::New();
+  size.Fill( 2 );
+  smallImage->SetRegions( size );
+  smallImage->Allocate();
+  ITK_TRY_EXPECT_EXCEPTION( batch->AppendImage( smallImage ) );
+  ITK_TEST_EXPECT_EQUAL( batch->GetNumberOfImages(), 4 );
+
+  // Room reserved up front is used without growing.
+  BatchType::Pointer reservedBatch = BatchType::New();
+  reservedBatch->Reserve( 3 );
+  ITK_TEST_EXPECT_EQUAL( reservedBatch->GetCapacity(), 3 );
+  reservedBatch->AppendImage( images[0] );
+  const void * const reservedStorage = reservedBatch->GetTensor().data_ptr();
+  reservedBatch->AppendImage( images[1] );
+  reservedBatch->AppendImage( images[0] );
+  ITK_TEST_EXPECT_EQUAL( reservedBatch->GetCapacity(), 3 );
+  ITK_TEST_EXPECT_TRUE( reservedBatch->GetTensor().data_ptr() == reservedStorage );
+  reservedBatch->Initialize();
+  ITK_TEST_EXPECT_EQUAL( reservedBatch->GetNumberOfImages(), 0 );
+  ITK_TEST_EXPECT_EQUAL( reservedBatch->GetCapacity(), 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchImage.h"
+
+#include "itkCovariantVector.h"
+#include "itkRGBAPixel.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// About two million pixels per image in every dimension.
+constexpr double NumberOfPixels = 2097152.0;
+
+// The number of pixels read and written one at a time.
+constexpr itk::SizeValueType NumberOfAccessedPixels = 65536;
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+BenchmarkImage( itk::TorchBenchmark & benchmark, const std::string & pixelName, const TPixel & value )
+{
+  using ImageType = itk::TorchImage< TPixel, VImageDimension >;
+  using DeepScalarType = typename ImageType::DeepScalarType;
+
+  typename ImageType::SizeType size;
+  size.Fill( static_cast< itk::SizeValueType >( std::round( std::pow( NumberOfPixels, 1.0 / VImageDimension ) ) ) );
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  const std::vector< std::pair< typename ImageType::TensorInitializer, std::string > > initializers{
+    { ImageType::itkEmpty, "itkEmpty" }, { ImageType::itkZeros, "itkZeros" }, { ImageType::itkOnes, "itkOnes" },
+    { ImageType::itkRand, "itkRand" }, { ImageType::itkRandn, "itkRandn" } };
+  for( const auto & initializer : initializers )
+    {
+    // ATen draws random numbers only for floating point types.
+    if( initializer.first >= ImageType::itkRand && !std::is_floating_point< DeepScalarType >::value )
+      {
+      continue;
+      }
+    benchmark.Time( "Allocate", initializer.second, pixelName, VImageDimension, numberOfPixels,
+      [&]() { image->Allocate( initializer.first ); } );
+    }
+
+  benchmark.Time( "FillBuffer", "", pixelName, VImageDimension, numberOfPixels,
+    [&]() { image->FillBuffer( value ); } );
+  if( ImageType::PixelDimension > 0 )
+    {
+    // A scalar image of the same number of deep scalars, which a
+    // non-scalar FillBuffer() should come close to.
+    using ScalarImageType = itk::TorchImage< DeepScalarType, VImageDimension >;
+    typename ScalarImageType::SizeType scalarSize = size;
+    scalarSize[0] *= ImageType::TorchImagePixelHelper::SizeOf;
+    typename ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+    scalarImage->SetRegions( scalarSize );
+    scalarImage->SetDevice( ScalarImageType::itkCPU );
+    scalarImage->Allocate();
+    benchmark.Time( "FillBuffer", "DeepScalarReference", pixelName, VImageDimension, numberOfPixels,
+      [&]() { scalarImage->FillBuffer( static_cast< DeepScalarType >( 1 ) ); } );
+    }
+
+  typename ImageType::Pointer graft = ImageType::New();
+  benchmark.Time( "Graft", "", pixelName, VImageDimension, numberOfPixels,
+    [&]() { graft->Graft( image ); } );
+
+  const itk::SizeValueType numberOfAccessedPixels = std::min( NumberOfAccessedPixels, image->GetBufferedRegion().GetNumberOfPixels() );
+  for( const bool directCPUAccess : { true, false } )
+    {
+    image->SetDirectCPUAccess( directCPUAccess );
+    const std::string variant = directCPUAccess ? "DirectCPUAccess" : "TensorAccess";
+    benchmark.Time( "SetPixel", variant, pixelName, VImageDimension, numberOfAccessedPixels,
+      [&]()
+        {
+        for( itk::SizeValueType offset = 0; offset < numberOfAccessedPixels; ++offset )
+          {
+          image->SetPixel( image->ComputeIndex( offset ), value );
+          }
+        } );
+    itk::SizeValueType numberOfMatches = 0;
+    benchmark.Time( "GetPixel", variant, pixelName, VImageDimension, numberOfAccessedPixels,
+      [&]()
+        {
+        numberOfMatches = 0;
+        for( itk::SizeValueType offset = 0; offset < numberOfAccessedPixels; ++offset )
+          {
+          numberOfMatches += static_cast< TPixel >( image->GetPixel( image->ComputeIndex( offset ) ) ) == value;
+          }
+        } );
+    itkAssertOrThrowMacro( numberOfMatches == numberOfAccessedPixels, "GetPixel() does not return what SetPixel() set" );
+    }
+  image->SetDirectCPUAccess( true );
+
+  // The same loops over an itk::Image, which direct CPU access should
+  // come close to.
+  using ITKImageType = typename ImageType::ITKImageType;
+  typename ITKImageType::Pointer referenceImage = ITKImageType::New();
+  referenceImage->SetRegions( size );
+  referenceImage->Allocate();
+  benchmark.Time( "SetPixel", "ImageReference", pixelName, VImageDimension, numberOfAccessedPixels,
+    [&]()
+      {
+      for( itk::SizeValueType offset = 0; offset < numberOfAccessedPixels; ++offset )
+        {
+        referenceImage->SetPixel( referenceImage->ComputeIndex( offset ), value );
+        }
+      } );
+  itk::SizeValueType numberOfReferenceMatches = 0;
+  benchmark.Time( "GetPixel", "ImageReference", pixelName, VImageDimension, numberOfAccessedPixels,
+    [&]()
+      {
+      numberOfReferenceMatches = 0;
+      for( itk::SizeValueType offset = 0; offset < numberOfAccessedPixels; ++offset )
+        {
+        numberOfReferenceMatches += referenceImage->GetPixel( referenceImage->ComputeIndex( offset ) ) == value;
+        }
+      } );
+  itkAssertOrThrowMacro( numberOfReferenceMatches == numberOfAccessedPixels,
+    "Image::GetPixel() does not return what SetPixel() set" );
+
+  typename ImageType::ITKImagePointer itkImage;
+  benchmark.Time( "ToImage", "", pixelName, VImageDimension, numberOfPixels,
+    [&]() { itkImage = image->ToImage(); } );
+  benchmark.Time( "FromImage", "", pixelName, VImageDimension, numberOfPixels,
+    [&]() { ImageType::FromImage( itkImage ); } );
+}
+
+template< typename TPixel >
+void
+BenchmarkImages( itk::TorchBenchmark & benchmark, const std::string & pixelName, const TPixel & value )
+{
+  BenchmarkImage< TPixel, 2 >( benchmark, pixelName, value );
+  BenchmarkImage< TPixel, 3 >( benchmark, pixelName, value );
+  BenchmarkImage< TPixel, 4 >( benchmark, pixelName, value );
+}
+
+template< typename TPixel >
+TPixel
+MakeComponents()
+{
+  TPixel pixel;
+  for( unsigned int i = 0; i < pixel.Size(); ++i )
+    {
+    pixel[i] = static_cast< typename TPixel::ValueType >( i + 1 );
+    }
+  return pixel;
+}
+
+} // end namespace
+
+int itkTorchImageBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The pixel types wrapped for Python.
+  itk::TorchBenchmark benchmark( "TorchImage" );
+  BenchmarkImages< float >( benchmark, "float", 1.5f );
+  BenchmarkImages< double >( benchmark, "double", 1.5 );
+  BenchmarkImages< bool >( benchmark, "bool", true );
+  BenchmarkImages< unsigned char >( benchmark, "unsigned char", 7 );
+  BenchmarkImages< signed char >( benchmark, "signed char", -7 );
+  BenchmarkImages< short >( benchmark, "short", -7 );
+  BenchmarkImages< long >( benchmark, "long", -7 );
+  BenchmarkImages< long long >( benchmark, "long long", -7 );
+  BenchmarkImages( benchmark, "RGBPixel<unsigned char>", MakeComponents< itk::RGBPixel< unsigned char > >() );
+  BenchmarkImages( benchmark, "RGBAPixel<unsigned char>", MakeComponents< itk::RGBAPixel< unsigned char > >() );
+  BenchmarkImages( benchmark, "Vector<float,2>", MakeComponents< itk::Vector< float, 2 > >() );
+  BenchmarkImages( benchmark, "Vector<float,3>", MakeComponents< itk::Vector< float, 3 > >() );
+  BenchmarkImages( benchmark, "Vector<float,4>", MakeComponents< itk::Vector< float, 4 > >() );
+  BenchmarkImages( benchmark, "CovariantVector<float,2>", MakeComponents< itk::CovariantVector< float, 2 > >() );
+  BenchmarkImages( benchmark, "CovariantVector<float,3>", MakeComponents< itk::CovariantVector< float, 3 > >() );
+  BenchmarkImages( benchmark, "CovariantVector<float,4>", MakeComponents< itk::CovariantVector< float, 4 > >() );
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchImage.h"
+#include "itkTorchImageRegionIterator.h"
+#include "itkTorchUnaryImageFilter.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchImageCloneTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using Counters = itk::TorchInstrumentationCounters;
+
+  ImageType::IndexType start;
+  start[0] = 2;
+  start[1] = -3;
+  start[2] = 0;
+  ImageType::SizeType size;
+  size[0] = 16;
+  size[1] = 12;
+  size[2] = 8;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.0;
+  spacing[2] = 2.5;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( start, size ) );
+  image->SetSpacing( spacing );
+  image->SetDevice( ImageType::itkCPU );
+  image->SetComponentLayout( ImageType::itkComponentsFirst );
+  image->Allocate( ImageType::itkRandn );
+  const torch::Tensor original = image->GetTensor().clone();
+
+  ImageType::PixelType value;
+  value[0] = 100.0f;
+  value[1] = -100.0f;
+
+  // A clone shares the pixels, and copies the rest, of its source.
+  ImageType::Pointer clone = image->Clone();
+  ITK_TEST_EXPECT_EQUAL( clone->GetBufferedRegion(), image->GetBufferedRegion() );
+  ITK_TEST_EXPECT_EQUAL( clone->GetSpacing(), spacing );
+  ITK_TEST_EXPECT_EQUAL( clone->GetComponentLayout(), ImageType::itkComponentsFirst );
+  ITK_TEST_EXPECT_TRUE( clone->GetTensor().data_ptr() == image->GetTensor().data_ptr() );
+  ITK_TEST_EXPECT_TRUE( clone->IsTensorShared() );
+  ITK_TEST_EXPECT_TRUE( image->IsTensorShared() );
+
+  // Reading does not copy.
+  const ImageType::IndexType index = start;
+  const ImageType * const constClone = clone.GetPointer();
+  const ImageType::PixelType readValue = constClone->GetPixel( index );
+  ITK_TEST_EXPECT_EQUAL( readValue, image->ToImage()->GetPixel( index ) );
+  ITK_TEST_EXPECT_TRUE( clone->GetTensor().data_ptr() == image->GetTensor().data_ptr() );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( clone->GetPixel( index ) ), readValue );
+  ITK_TEST_EXPECT_TRUE( clone->GetTensor().data_ptr() == image->GetTensor().data_ptr() );
+
+  // Writing through the reference of the non-const GetPixel() copies.
+  ImageType::Pointer referenced = image->Clone();
+  ImageType::TorchImagePixelHelper pixel = referenced->GetPixel( index );
+  ITK_TEST_EXPECT_TRUE( referenced->GetTensor().data_ptr() == image->GetTensor().data_ptr() );
+  pixel = value;
+  ITK_TEST_EXPECT_TRUE( referenced->GetTensor().data_ptr() != image->GetTensor().data_ptr() );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( pixel ), value );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( referenced->GetPixel( index ) ), value );
+  itkAssertOrThrowMacro( torch::equal( image->GetTensor(), original ), "Writing through GetPixel() changed the source" );
+  referenced = nullptr;
+
+  // The first write to the clone copies its pixels, and only its.
+  itk::TorchInstrumentation::GetInstance()->EnabledOn();
+  clone->SetPixel( index, value );
+  ITK_TEST_EXPECT_TRUE( clone->GetTensor().data_ptr() != image->GetTensor().data_ptr() );
+  ITK_TEST_EXPECT_EQUAL( clone->GetInstrumentationCounters().GetCount( Counters::itkCopy ), 1 );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( clone->GetPixel( index ) ), value );
+  itkAssertOrThrowMacro( torch::equal( image->GetTensor(), original ), "Writing to a clone changed its source" );
+  ITK_TEST_EXPECT_TRUE( !clone->IsTensorShared() );
+  ITK_TEST_EXPECT_TRUE( !image->IsTensorShared() );
+
+  // The source then writes in place.
+  const void * const storage = image->GetTensor().data_ptr();
+  ITK_TEST_EXPECT_TRUE( !image->MakeTensorWritable() );
+  ITK_TEST_EXPECT_TRUE( image->GetTensor().data_ptr() == storage );
+
+  // A write to the source leaves the clone unchanged, and the images
+  // grafted from the source follow it.
+  clone = image->Clone();
+  ImageType::Pointer graft = ImageType::New();
+  graft->Graft( image );
+  graft->SetPixel( index, value );
+  ITK_TEST_EXPECT_TRUE( image->GetTensor().data_ptr() == graft->GetTensor().data_ptr() );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( image->GetPixel( index ) ), value );
+  itkAssertOrThrowMacro( torch::equal( clone->GetTensor(), original ), "Writing to a graft changed a clone" );
+  ITK_TEST_EXPECT_TRUE( clone->GetTensor().data_ptr() == storage );
+
+  // Filling a clone allocates storage without copying the pixels.
+  ImageType::Pointer filled = clone->Clone();
+  filled->ResetInstrumentationCounters();
+  filled->FillBuffer( value );
+  ITK_TEST_EXPECT_EQUAL( filled->GetInstrumentationCounters().GetCount( Counters::itkCopy ), 0 );
+  ITK_TEST_EXPECT_EQUAL( filled->GetInstrumentationCounters().GetCount( Counters::itkAllocation ), 1 );
+  itkAssertOrThrowMacro( torch::equal( clone->GetTensor(), original ), "Filling a clone changed its source" );
+  itk::TorchInstrumentation::GetInstance()->SetEnabled( false );
+
+  // Iterators that write copy first.
+  ImageType::Pointer iterated = clone->Clone();
+  itk::TorchImageRegionIterator< ImageType > iterator( iterated, iterated->GetBufferedRegion() );
+  for( ; !iterator.IsAtEnd(); ++iterator )
+    {
+    iterator.Set( value );
+    }
+  itkAssertOrThrowMacro( torch::equal( clone->GetTensor(), original ), "An iterator changed the source of a clone" );
+
+  // An in-place filter writes to pixels of the clone's own.
+  using ScalarImageType = itk::TorchImage< float, ImageDimension >;
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions( size );
+  scalarImage->SetDevice( ScalarImageType::itkCPU );
+  scalarImage->Allocate( ScalarImageType::itkRandn );
+  const torch::Tensor scalarOriginal = scalarImage->GetTensor().clone();
+  using AbsFilterType = itk::TorchAbsImageFilter< ScalarImageType >;
+  AbsFilterType::Pointer absFilter = AbsFilterType::New();
+  absFilter->SetInput( scalarImage->Clone() );
+  absFilter->InPlaceOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION( absFilter->Update() );
+  itkAssertOrThrowMacro( torch::equal( absFilter->GetOutput()->GetTensor(), scalarOriginal.abs() ),
+    "TorchAbsImageFilter is wrong on a clone" );
+  itkAssertOrThrowMacro( torch::equal( scalarImage->GetTensor(), scalarOriginal ),
+    "An in-place filter changed the source of a clone" );
+
+  // A clone of an image with region views gets pixels of its own right
+  // away, as the views write without copying.
+  ImageType::Pointer viewed = ImageType::New();
+  viewed->SetRegions( ImageType::RegionType( start, size ) );
+  viewed->SetDevice( ImageType::itkCPU );
+  viewed->Allocate( ImageType::itkRandn );
+  ImageType::RegionType viewRegion( start, size );
+  viewRegion.ShrinkByRadius( 1 );
+  const ImageType::IndexType viewIndex = viewRegion.GetIndex();
+  ImageType::Pointer view = viewed->CreateRegionView( viewRegion );
+  const torch::Tensor viewedOriginal = viewed->GetTensor().clone();
+  ImageType::Pointer viewedClone = viewed->Clone();
+  ITK_TEST_EXPECT_TRUE( !viewedClone->IsTensorShared() );
+  ITK_TEST_EXPECT_TRUE( viewedClone->GetTensor().data_ptr() != viewed->GetTensor().data_ptr() );
+  view->FillBuffer( value );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( viewed->GetPixel( viewIndex ) ), value );
+  itkAssertOrThrowMacro( torch::equal( viewedClone->GetTensor(), viewedOriginal ),
+    "Writing to a region view changed a clone of its image" );
+
+  // A region view of a clone, or of its source, shares the pixels that
+  // image keeps after the copy.
+  view = nullptr;
+  ImageType::Pointer lazyClone = viewed->Clone();
+  ITK_TEST_EXPECT_TRUE( lazyClone->IsTensorShared() );
+  const torch::Tensor lazyOriginal = viewed->GetTensor().clone();
+  view = viewed->CreateRegionView( viewRegion );
+  ITK_TEST_EXPECT_TRUE( !viewed->IsTensorShared() );
+  ImageType::PixelType viewValue;
+  viewValue[0] = -1.0f;
+  viewValue[1] = 1.0f;
+  view->SetPixel( viewIndex, viewValue );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( viewed->GetPixel( viewIndex ) ), viewValue );
+  itkAssertOrThrowMacro( torch::equal( lazyClone->GetTensor(), lazyOriginal ),
+    "Writing to a region view changed a clone of its image" );
+  ImageType::Pointer cloneView = lazyClone->CreateRegionView( viewRegion );
+  cloneView->SetPixel( viewIndex, value );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( lazyClone->GetPixel( viewIndex ) ), value );
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( viewed->GetPixel( viewIndex ) ), viewValue );
+
+  // A clone of an image that is not allocated is not allocated either.
+  ImageType::Pointer empty = ImageType::New();
+  empty->SetRegions( size );
+  ImageType::Pointer emptyClone = empty->Clone();
+  ITK_TEST_EXPECT_TRUE( !emptyClone->GetTensor().defined() );
+  ITK_TEST_EXPECT_TRUE( !emptyClone->IsTensorShared() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchImage.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+namespace
+{
+// A DLPack tensor over memory of the test's own, as another array
+// library would export it.
+struct ForeignArray
+{
+  std::vector< float > m_Data;
+  std::vector< int64_t > m_Shape;
+  DLManagedTensor m_DLManagedTensor;
+  bool m_Deleted{ false };
+
+  explicit ForeignArray( const std::vector< int64_t > & shape )
+    : m_Shape( shape )
+    {
+    int64_t numberOfElements = 1;
+    for( const int64_t size : shape )
+      {
+      numberOfElements *= size;
+      }
+    m_Data.resize( numberOfElements );
+    for( int64_t i = 0; i < numberOfElements; ++i )
+      {
+      m_Data[i] = static_cast< float >( i );
+      }
+    DLTensor & dlTensor = m_DLManagedTensor.dl_tensor;
+    dlTensor.data = m_Data.data();
+    dlTensor.ctx = { kDLCPU, 0 };
+    dlTensor.ndim = static_cast< int >( shape.size() );
+    dlTensor.dtype = { kDLFloat, 32, 1 };
+    dlTensor.shape = m_Shape.data();
+    dlTensor.strides = nullptr;
+    dlTensor.byte_offset = 0;
+    m_DLManagedTensor.manager_ctx = this;
+    m_DLManagedTensor.deleter = []( DLManagedTensor * self )
+      {
+      static_cast< ForeignArray * >( self->manager_ctx )->m_Deleted = true;
+      };
+    }
+};
+} // namespace
+
+int itkTorchImageDLPackTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+
+  ImageType::IndexType start;
+  start[0] = 4;
+  start[1] = -2;
+  start[2] = 1;
+  ImageType::SizeType size;
+  size[0] = 10;
+  size[1] = 7;
+  size[2] = 5;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.75;
+  spacing[2] = 3.0;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( start, size ) );
+  image->SetSpacing( spacing );
+  image->SetDevice( ImageType::itkCPU );
+
+  // Only allocated images can be exported.
+  ITK_TRY_EXPECT_EXCEPTION( image->ToDLPack() );
+  image->Allocate( ImageType::itkRandn );
+
+  // The export shares the pixels, with the sizes of ComputeTorchSize(),
+  // in either component layout.
+  for( const ImageType::ComponentLayoutType componentLayout :
+         { ImageType::itkComponentsLast, ImageType::itkComponentsFirst } )
+    {
+    image->SetComponentLayout( componentLayout );
+    DLManagedTensor * dlManagedTensor = image->ToDLPack();
+    const DLTensor & dlTensor = dlManagedTensor->dl_tensor;
+    const std::vector< int64_t > torchSize = image->ComputeTorchSize();
+    ITK_TEST_EXPECT_EQUAL( dlTensor.ndim, static_cast< int >( torchSize.size() ) );
+    for( unsigned int i = 0; i < torchSize.size(); ++i )
+      {
+      ITK_TEST_EXPECT_EQUAL( dlTensor.shape[i], torchSize[i] );
+      }
+    ITK_TEST_EXPECT_TRUE( dlTensor.data == image->GetTensor().data_ptr() );
+    ITK_TEST_EXPECT_EQUAL( static_cast< int >( dlTensor.dtype.code ), static_cast< int >( kDLFloat ) );
+    ITK_TEST_EXPECT_EQUAL( static_cast< int >( dlTensor.dtype.bits ), 32 );
+    ITK_TEST_EXPECT_EQUAL( static_cast< int >( dlTensor.ctx.device_type ), static_cast< int >( kDLCPU ) );
+
+    // Importing it back, with the geometry of the image, gives the
+    // same image without a copy.
+    ImageType::Pointer imported = ImageType::FromDLPack( dlManagedTensor, image, componentLayout );
+    ITK_TEST_EXPECT_EQUAL( imported->GetBufferedRegion(), image->GetBufferedRegion() );
+    ITK_TEST_EXPECT_EQUAL( imported->GetSpacing(), spacing );
+    ITK_TEST_EXPECT_EQUAL( imported->GetComponentLayout(), componentLayout );
+    ITK_TEST_EXPECT_TRUE( imported->GetTensor().data_ptr() == image->GetTensor().data_ptr() );
+    ImageType::PixelType value;
+    value[0] = 3.0f;
+    value[1] = -4.0f;
+    imported->SetPixel( start, value );
+    ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( image->GetPixel( start ) ), value );
+    }
+
+  // Region views are exported with their strides.
+  ImageType::RegionType region( start, size );
+  region.ShrinkByRadius( 1 );
+  ImageType::Pointer view = image->CreateRegionView( region );
+  DLManagedTensor * viewDLManagedTensor = view->ToDLPack();
+  ITK_TEST_EXPECT_TRUE( viewDLManagedTensor->dl_tensor.strides != nullptr );
+  ImageType::Pointer importedView = ImageType::FromDLPack( viewDLManagedTensor, view, view->GetComponentLayout() );
+  itkAssertOrThrowMacro( torch::equal( importedView->GetTensor(), view->GetTensor() ),
+    "A region view changed through DLPack" );
+
+  // Foreign memory becomes a TorchImage without a copy, sized after
+  // the tensor without geometry, and is released with the image.
+  ForeignArray foreignArray( { 5, 7, 10, 2 } );
+  ImageType::Pointer foreign = ImageType::FromDLPack( &foreignArray.m_DLManagedTensor );
+  ITK_TEST_EXPECT_EQUAL( foreign->GetBufferedRegion().GetSize(), size );
+  ITK_TEST_EXPECT_EQUAL( foreign->GetBufferedRegion().GetIndex(), ImageType::IndexType::Filled( 0 ) );
+  ITK_TEST_EXPECT_TRUE( foreign->GetTensor().data_ptr() == foreignArray.m_Data.data() );
+  ImageType::IndexType index;
+  index[0] = 9;
+  index[1] = 6;
+  index[2] = 4;
+  ITK_TEST_EXPECT_EQUAL( static_cast< ImageType::PixelType >( foreign->GetPixel( index ) )[1],
+    static_cast< float >( foreignArray.m_Data.size() - 1 ) );
+  ITK_TEST_EXPECT_TRUE( !foreignArray.m_Deleted );
+  foreign = nullptr;
+  ITK_TEST_EXPECT_TRUE( foreignArray.m_Deleted );
+
+  // Tensors of the wrong type or sizes are rejected, and released.
+  using DoubleImageType = itk::TorchImage< double, ImageDimension >;
+  ForeignArray wrongType( { 5, 7, 10 } );
+  ITK_TRY_EXPECT_EXCEPTION( DoubleImageType::FromDLPack( &wrongType.m_DLManagedTensor ) );
+  ITK_TEST_EXPECT_TRUE( wrongType.m_Deleted );
+  ForeignArray wrongSize( { 5, 7, 10, 3 } );
+  ITK_TRY_EXPECT_EXCEPTION( ImageType::FromDLPack( &wrongSize.m_DLManagedTensor ) );
+  ITK_TEST_EXPECT_TRUE( wrongSize.m_Deleted );
+  ITK_TRY_EXPECT_EXCEPTION( ImageType::FromDLPack( nullptr ) );
+
+  // DLPack has no boolean type.
+  using BoolImageType = itk::TorchImage< bool, ImageDimension >;
+  BoolImageType::Pointer boolImage = BoolImageType::New();
+  boolImage->SetRegions( size );
+  boolImage->SetDevice( BoolImageType::itkCPU );
+  boolImage->Allocate( BoolImageType::itkZeros );
+  ITK_TRY_EXPECT_EXCEPTION( boolImage->ToDLPack() );
+
+  // CUDA tensors keep their device.
+  image->SetComponentLayout( ImageType::itkComponentsLast );
+  if( image->SetDevice( ImageType::itkCUDA ) )
+    {
+    DLManagedTensor * dlManagedTensor = image->ToDLPack();
+    ITK_TEST_EXPECT_EQUAL( static_cast< int >( dlManagedTensor->dl_tensor.ctx.device_type ), static_cast< int >( kDLGPU ) );
+    ImageType::Pointer imported = ImageType::FromDLPack( dlManagedTensor, image );
+    ITK_TEST_EXPECT_TRUE( imported->GetTensor().is_cuda() );
+    ITK_TEST_EXPECT_TRUE( imported->GetTensor().data_ptr() == image->GetTensor().data_ptr() );
+    }
+  else
+    {
+    std::cout << "CUDA is not available; DLPack on GPUs is not tested." << std::endl;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
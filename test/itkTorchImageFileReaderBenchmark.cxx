@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchImageFileReader.h"
+#include "itkTorchImageFileWriter.h"
+
+#include "itkImageFileReader.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchImageFileReaderBenchmark( int argc, char * argv[] )
+{
+  if( argc < 3 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string fileName = std::string( argv[2] ) + "/itkTorchImageFileReaderBenchmark.mha";
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using ReaderType = itk::TorchImageFileReader< ImageType >;
+  using WriterType = itk::TorchImageFileWriter< ImageType >;
+  using ITKReaderType = itk::ImageFileReader< ImageType::ITKImageType >;
+
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRand );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetFileName( fileName );
+  ITK_TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  // TorchImageFileReader against ImageFileReader followed by a copy
+  // into a TorchImage.
+  itk::TorchBenchmark benchmark( "TorchImageFileReader", 5 );
+  for( const bool streaming : { false, true } )
+    {
+    benchmark.Time( "TorchImageFileReader", streaming ? "streamed" : "whole", "Vector<float,2>", ImageDimension,
+      numberOfPixels,
+      [&]()
+        {
+        ReaderType::Pointer reader = ReaderType::New();
+        reader->SetFileName( fileName );
+        reader->SetUseStreaming( streaming );
+        reader->GetOutput()->SetDevice( ImageType::itkCPU );
+        reader->Update();
+        } );
+    }
+  benchmark.Time( "ImageFileReader", "copied into TorchImage", "Vector<float,2>", ImageDimension, numberOfPixels,
+    [&]()
+      {
+      ITKReaderType::Pointer itkReader = ITKReaderType::New();
+      itkReader->SetFileName( fileName );
+      itkReader->Update();
+      ImageType::Pointer copy = ImageType::New();
+      copy->SetRegions( size );
+      copy->SetTensor( ImageType::FromImage( itkReader->GetOutput() )->GetTensor().clone() );
+      } );
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
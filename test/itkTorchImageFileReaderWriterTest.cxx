@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchImageFileReader.h"
+#include "itkTorchImageFileWriter.h"
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchImageFileReaderWriterTest( int argc, char *argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv );
+    std::cerr << " outputDirectory";
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string outputDirectory = argv[1];
+  const std::string vectorFileName = outputDirectory + "/itkTorchImageFileReaderWriterTestVector.mha";
+  const std::string unsignedFileName = outputDirectory + "/itkTorchImageFileReaderWriterTestUnsigned.mha";
+
+  constexpr unsigned int ImageDimension = 3;
+  using PixelType = itk::Vector< float, 2 >;
+  using ImageType = itk::TorchImage< PixelType, ImageDimension >;
+  using WriterType = itk::TorchImageFileWriter< ImageType >;
+  using ReaderType = itk::TorchImageFileReader< ImageType >;
+
+  // A TorchImage with distinct pixels and non-trivial geometry.
+  ImageType::SizeType size;
+  size[0] = 7;
+  size[1] = 6;
+  size[2] = 20;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.75;
+  spacing[2] = 2.0;
+  image->SetSpacing( spacing );
+  ImageType::PointType origin;
+  origin[0] = -10.0;
+  origin[1] = 3.0;
+  origin[2] = 1.5;
+  image->SetOrigin( origin );
+  image->SetTensor( torch::arange( 7 * 6 * 20 * 2, torch::dtype( torch::kFloat ) ).reshape( image->ComputeTorchSize() ) );
+
+  // Write in slabs.
+  WriterType::Pointer writer = WriterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( writer, TorchImageFileWriter, ProcessObject );
+  ITK_TRY_EXPECT_EXCEPTION( writer->Update() );
+  writer->SetInput( image );
+  writer->SetFileName( vectorFileName );
+  ITK_TEST_SET_GET_VALUE( vectorFileName, std::string( writer->GetFileName() ) );
+  ITK_TEST_SET_GET_BOOLEAN( writer, UseStreaming, true );
+  writer->SetNumberOfSlicesPerSlab( 3 );
+  ITK_TEST_SET_GET_VALUE( 3, writer->GetNumberOfSlicesPerSlab() );
+  ITK_TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  // ImageFileReader agrees with what was written.
+  using ITKReaderType = itk::ImageFileReader< ImageType::ITKImageType >;
+  ITKReaderType::Pointer itkReader = ITKReaderType::New();
+  itkReader->SetFileName( vectorFileName );
+  ITK_TRY_EXPECT_NO_EXCEPTION( itkReader->Update() );
+  ImageType::ITKImageType::Pointer itkImage = itkReader->GetOutput();
+  ITK_TEST_EXPECT_EQUAL( itkImage->GetSpacing(), spacing );
+  ITK_TEST_EXPECT_EQUAL( itkImage->GetOrigin(), origin );
+  itkAssertOrThrowMacro( torch::equal( ImageType::FromImage( itkImage )->GetTensor(), image->GetTensor() ),
+    "TorchImageFileWriter wrote the wrong pixels" );
+
+  // Read whole and streamed, into both component layouts.
+  for( const bool streaming : { false, true } )
+    {
+    for( const ImageType::ComponentLayoutType componentLayout : { ImageType::itkComponentsLast, ImageType::itkComponentsFirst } )
+      {
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetFileName( vectorFileName );
+      reader->SetUseStreaming( streaming );
+      reader->SetNumberOfSlicesPerSlab( 4 );
+      reader->GetOutput()->SetDevice( ImageType::itkCPU );
+      reader->GetOutput()->SetComponentLayout( componentLayout );
+      ITK_TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+      ImageType::Pointer readImage = reader->GetOutput();
+      ITK_TEST_EXPECT_EQUAL( readImage->GetSpacing(), spacing );
+      ITK_TEST_EXPECT_EQUAL( readImage->GetOrigin(), origin );
+      ITK_TEST_EXPECT_EQUAL( readImage->GetBufferedRegion(), image->GetBufferedRegion() );
+      itkAssertOrThrowMacro( torch::equal( ImageType::PermuteComponentLayout( readImage->GetTensor(), componentLayout,
+        ImageType::itkComponentsLast ), image->GetTensor() ), "TorchImageFileReader read the wrong pixels" );
+      }
+    }
+
+  // A streamed read of a sub-region reads only that region, also from
+  // a compressed file, which the ImageIO reads whole.
+  const std::string compressedFileName = outputDirectory + "/itkTorchImageFileReaderWriterTestCompressed.mha";
+  WriterType::Pointer compressedWriter = WriterType::New();
+  compressedWriter->SetInput( image );
+  compressedWriter->SetFileName( compressedFileName );
+  compressedWriter->UseStreamingOff();
+  compressedWriter->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION( compressedWriter->Update() );
+  for( const std::string & fileName : { vectorFileName, compressedFileName } )
+    {
+    ReaderType::Pointer reader = ReaderType::New();
+    ITK_EXERCISE_BASIC_OBJECT_METHODS( reader, TorchImageFileReader, ImageSource );
+    reader->SetFileName( fileName );
+    reader->UseStreamingOn();
+    reader->UpdateOutputInformation();
+    ImageType::IndexType index;
+    index[0] = 1;
+    index[1] = 2;
+    index[2] = 5;
+    ImageType::SizeType regionSize;
+    regionSize[0] = 3;
+    regionSize[1] = 4;
+    regionSize[2] = 9;
+    const ImageType::RegionType region( index, regionSize );
+    reader->GetOutput()->SetRequestedRegion( region );
+    ITK_TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+    ITK_TEST_EXPECT_EQUAL( reader->GetOutput()->GetBufferedRegion(), region );
+    ImageType::Pointer view = image->CreateRegionView( region );
+    itkAssertOrThrowMacro( torch::equal( reader->GetOutput()->GetTensor().cpu(), view->GetTensor() ),
+      "TorchImageFileReader read the wrong region" );
+    }
+
+  // Components are converted to the pixel type of the output.
+  {
+    using DoubleImageType = itk::TorchImage< itk::Vector< double, 2 >, ImageDimension >;
+    using DoubleReaderType = itk::TorchImageFileReader< DoubleImageType >;
+    DoubleReaderType::Pointer reader = DoubleReaderType::New();
+    reader->SetFileName( vectorFileName );
+    ITK_TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+    itkAssertOrThrowMacro( torch::equal( reader->GetOutput()->GetTensor().cpu(), image->GetTensor().to( torch::kDouble ) ),
+      "TorchImageFileReader converted components wrongly" );
+
+    // The number of components must match.
+    using ScalarReaderType = itk::TorchImageFileReader< itk::TorchImage< float, ImageDimension > >;
+    ScalarReaderType::Pointer scalarReader = ScalarReaderType::New();
+    scalarReader->SetFileName( vectorFileName );
+    ITK_TRY_EXPECT_EXCEPTION( scalarReader->Update() );
+  }
+
+  // Unsigned 16 bit components keep values that do not fit in int16.
+  {
+    using UnsignedImageType = itk::Image< uint16_t, 2 >;
+    UnsignedImageType::Pointer unsignedImage = UnsignedImageType::New();
+    UnsignedImageType::SizeType unsignedSize;
+    unsignedSize.Fill( 4 );
+    unsignedImage->SetRegions( unsignedSize );
+    unsignedImage->Allocate();
+    unsignedImage->FillBuffer( 40000 );
+    using UnsignedWriterType = itk::ImageFileWriter< UnsignedImageType >;
+    UnsignedWriterType::Pointer unsignedWriter = UnsignedWriterType::New();
+    unsignedWriter->SetInput( unsignedImage );
+    unsignedWriter->SetFileName( unsignedFileName );
+    ITK_TRY_EXPECT_NO_EXCEPTION( unsignedWriter->Update() );
+
+    using IntImageType = itk::TorchImage< int32_t, 2 >;
+    using IntReaderType = itk::TorchImageFileReader< IntImageType >;
+    IntReaderType::Pointer reader = IntReaderType::New();
+    reader->SetFileName( unsignedFileName );
+    ITK_TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+    itkAssertOrThrowMacro( reader->GetOutput()->GetTensor().eq( 40000 ).all().item< bool >(),
+      "TorchImageFileReader converted unsigned components wrongly" );
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
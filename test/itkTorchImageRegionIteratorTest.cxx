@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchImage.h"
+#include "itkTorchImageRegionIterator.h"
+#include "itkTorchImageScanlineIterator.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchImageRegionIteratorTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  constexpr unsigned int VectorDimension = 2;
+  using PixelType = itk::Vector< float, VectorDimension >;
+  using ImageType = itk::TorchImage< PixelType, ImageDimension >;
+
+  ImageType::SizeType size;
+  size[0] = 7;
+  size[1] = 5;
+  size[2] = 4;
+  ImageType::Pointer image = ImageType::New();
+  image->SetDevice( ImageType::itkCPU );
+  image->SetRegions( size );
+  image->Allocate( ImageType::itkZeros );
+
+  // Write a sub-region with the region iterator.
+  ImageType::IndexType regionIndex;
+  regionIndex[0] = 1;
+  regionIndex[1] = 2;
+  regionIndex[2] = 0;
+  ImageType::SizeType regionSize;
+  regionSize[0] = 4;
+  regionSize[1] = 2;
+  regionSize[2] = 3;
+  const ImageType::RegionType region( regionIndex, regionSize );
+
+  itk::TorchImageRegionIterator< ImageType > it( image, region );
+  itk::SizeValueType numberOfPixels = 0;
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    PixelType value;
+    value[0] = static_cast< float >( index[0] + 10 * index[1] + 100 * index[2] );
+    value[1] = -value[0];
+    it.Set( value );
+    ++numberOfPixels;
+    }
+  ITK_TEST_EXPECT_EQUAL( numberOfPixels, region.GetNumberOfPixels() );
+
+  // Check every pixel of the image with GetPixel.
+  itk::TorchImageRegionConstIterator< ImageType > cit( image, image->GetBufferedRegion() );
+  for( cit.GoToBegin(); !cit.IsAtEnd(); ++cit )
+    {
+    const ImageType::IndexType & index = cit.GetIndex();
+    PixelType expected;
+    expected.Fill( 0.0f );
+    if( region.IsInside( index ) )
+      {
+      expected[0] = static_cast< float >( index[0] + 10 * index[1] + 100 * index[2] );
+      expected[1] = -expected[0];
+      }
+    const PixelType value = cit.Get();
+    const PixelType pixelValue = image->GetPixel( index );
+    itkAssertOrThrowMacro( value == expected, "TorchImageRegionConstIterator::Get failed" );
+    itkAssertOrThrowMacro( pixelValue == expected, "TorchImageRegionIterator::Set failed" );
+    }
+
+  // Use the scanline iterator as an lvalue, then read back.
+  itk::TorchImageScanlineIterator< ImageType > sit( image, region );
+  PixelType ones;
+  ones.Fill( 1.0f );
+  numberOfPixels = 0;
+  sit.GoToBegin();
+  while( !sit.IsAtEnd() )
+    {
+    while( !sit.IsAtEndOfLine() )
+      {
+      sit.Value() = ones;
+      ++numberOfPixels;
+      ++sit;
+      }
+    sit.NextLine();
+    }
+  ITK_TEST_EXPECT_EQUAL( numberOfPixels, region.GetNumberOfPixels() );
+
+  itk::TorchImageScanlineConstIterator< ImageType > scit( image, region );
+  float sum = 0.0f;
+  for( scit.GoToBegin(); !scit.IsAtEnd(); scit.NextLine() )
+    {
+    for( ; !scit.IsAtEndOfLine(); ++scit )
+      {
+      const PixelType value = scit.Get();
+      sum += value[0] + value[1];
+      }
+    }
+  ITK_TEST_EXPECT_EQUAL( sum, 2.0f * region.GetNumberOfPixels() );
+
+  // A region outside the buffered region is rejected.
+  ImageType::RegionType outsideRegion = region;
+  outsideRegion.SetIndex( 2, 3 );
+  ITK_TRY_EXPECT_EXCEPTION( itk::TorchImageRegionConstIterator< ImageType >( image, outsideRegion ) );
+
+  // Tensors on a GPU are rejected.
+  if( image->SetDevice( ImageType::itkCUDA ) )
+    {
+    ITK_TRY_EXPECT_EXCEPTION( itk::TorchImageRegionConstIterator< ImageType >( image, region ) );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
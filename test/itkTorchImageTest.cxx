@@ -17,7 +17,9 @@
  *=========================================================================*/
 
 #include "itkTorchImage.h"
+#include "itkTorchImageSerializer.h"
 
+#include "itkImage.h"
 #include "itkCommand.h"
 #include "itkTestingMacros.h"
 #include "itkRGBPixel.h"
@@ -25,6 +27,8 @@
 #include "itkVector.h"
 #include "itkCovariantVector.h"
 
+#include <fstream>
+
 namespace
 {
 class ShowProgress : public itk::Command
@@ -118,6 +122,18 @@ itkTorchImageTestByTypeAndDimension(
   pixelValue = image->GetPixel( location0 );
   itkAssertOrThrowMacro( pixelValue == secondValue, StructName + "::SetPixel has side effect" );
 
+  // The same values must be seen with and without direct CPU access.
+  ITK_TEST_SET_GET_BOOLEAN( image, DirectCPUAccess, true );
+  image->DirectCPUAccessOff();
+  pixelValue = image->GetPixel( location0 );
+  itkAssertOrThrowMacro( pixelValue == secondValue, StructName + "::GetPixel without DirectCPUAccess failed" );
+  image->GetPixel( location0 ) = firstValue;
+  image->DirectCPUAccessOn();
+  pixelValue = image->GetPixel( location0 );
+  itkAssertOrThrowMacro( pixelValue == firstValue, StructName + "::GetPixel with DirectCPUAccess failed" );
+  pixelValue = image->GetPixel( location1 );
+  itkAssertOrThrowMacro( pixelValue == thirdValue, StructName + "::GetPixel with DirectCPUAccess failed" );
+
   typename ImageType::Pointer image2 = ImageType::New();
   image2->SetRegions( size );
   image2->Graft( image );
@@ -125,19 +141,558 @@ itkTorchImageTestByTypeAndDimension(
   return EXIT_SUCCESS;
 }
 
+// Fill a vector image, whose components are broadcast over the whole
+// buffer at once.  The PyTorchBenchmarks compare its speed with that
+// of a scalar image of the same number of deep scalars.
+int
+itkTorchImageFillBufferTest()
+{
+  constexpr int ImageDimension = 3;
+  constexpr int VectorDimension = 3;
+  constexpr int SizePerDimension = 16;
+  using VectorPixelType = itk::Vector< float, VectorDimension >;
+  using VectorImageType = itk::TorchImage< VectorPixelType, ImageDimension >;
+
+  typename VectorImageType::SizeType vectorSize;
+  vectorSize.Fill( SizePerDimension );
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetDevice( VectorImageType::itkCPU );
+  vectorImage->SetRegions( vectorSize );
+  vectorImage->Allocate();
+
+  const float components[VectorDimension] = {1.5f, -2.5f, 3.5f};
+  const VectorPixelType vectorValue( components );
+  vectorImage->FillBuffer( vectorValue );
+
+  typename VectorImageType::IndexType location;
+  location.Fill( SizePerDimension - 1 );
+  const VectorPixelType pixelValue = vectorImage->GetPixel( location );
+  itkAssertOrThrowMacro( pixelValue == vectorValue, "TorchImage<Vector<float, 3>, 3>::FillBuffer failed" );
+  location.Fill( 0 );
+  location[1] = 1;
+  itkAssertOrThrowMacro( static_cast< VectorPixelType >( vectorImage->GetPixel( location ) ) == vectorValue,
+    "TorchImage<Vector<float, 3>, 3>::FillBuffer failed" );
+
+  return EXIT_SUCCESS;
+}
+
+// Write and read every pixel of a CPU TorchImage, which accesses the
+// buffer directly.  The PyTorchBenchmarks compare the speed of such
+// loops with those over an itk::Image.
+int
+itkTorchImageDirectCPUAccessTest()
+{
+  constexpr int ImageDimension = 3;
+  constexpr int SizePerDimension = 16;
+  using PixelType = float;
+  using TorchImageType = itk::TorchImage< PixelType, ImageDimension >;
+
+  typename TorchImageType::SizeType size;
+  size.Fill( SizePerDimension );
+
+  TorchImageType::Pointer torchImage = TorchImageType::New();
+  torchImage->SetDevice( TorchImageType::itkCPU );
+  torchImage->SetRegions( size );
+  torchImage->Allocate();
+
+  typename TorchImageType::IndexType index;
+  for( index[2] = 0; index[2] < SizePerDimension; ++index[2] )
+    {
+    for( index[1] = 0; index[1] < SizePerDimension; ++index[1] )
+      {
+      for( index[0] = 0; index[0] < SizePerDimension; ++index[0] )
+        {
+        torchImage->SetPixel( index, static_cast< PixelType >( index[0] + index[1] - index[2] ) );
+        }
+      }
+    }
+  unsigned int mismatches = 0;
+  for( index[2] = 0; index[2] < SizePerDimension; ++index[2] )
+    {
+    for( index[1] = 0; index[1] < SizePerDimension; ++index[1] )
+      {
+      for( index[0] = 0; index[0] < SizePerDimension; ++index[0] )
+        {
+        if( torchImage->GetPixel( index ) != static_cast< PixelType >( index[0] + index[1] - index[2] ) )
+          {
+          ++mismatches;
+          }
+        }
+      }
+    }
+  ITK_TEST_EXPECT_EQUAL( mismatches, 0u );
+
+  // The pixels went to the tensor elements of their reversed indices.
+  const torch::Tensor range = torch::arange( SizePerDimension, torch::dtype( TorchImageType::TorchValueType ) );
+  const torch::Tensor expected = range.view( { 1, 1, SizePerDimension } ) + range.view( { 1, SizePerDimension, 1 } )
+    - range.view( { SizePerDimension, 1, 1 } );
+  itkAssertOrThrowMacro( torch::equal( torchImage->GetTensor(), expected ),
+    "TorchImage<float, 3> direct CPU access wrote the wrong elements" );
+
+  return EXIT_SUCCESS;
+}
+
+// Convert between itk::Image and TorchImage in both directions and
+// check that the pixel buffer is shared rather than copied.
+int
+itkTorchImageConversionTest()
+{
+  constexpr int ImageDimension = 2;
+  using PixelType = itk::RGBPixel< uint8_t >;
+  using TorchImageType = itk::TorchImage< PixelType, ImageDimension >;
+  using ImageType = TorchImageType::ITKImageType;
+
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  ImageType::SizeType size;
+  size[0] = 17;
+  size[1] = 9;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 2.0;
+  ImageType::PointType origin;
+  origin[0] = 10.0;
+  origin[1] = -4.0;
+  ImageType::DirectionType direction;
+  direction[0][0] = 0.0;
+  direction[0][1] = 1.0;
+  direction[1][0] = 1.0;
+  direction[1][1] = 0.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( start, size ) );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->SetDirection( direction );
+  image->Allocate();
+  const uint8_t firstComponents[] = {1, 2, 3};
+  image->FillBuffer( PixelType( firstComponents ) );
+
+  TorchImageType::Pointer torchImage = TorchImageType::FromImage( image );
+  itkAssertOrThrowMacro( torchImage->GetBufferPointer() == image->GetBufferPointer(),
+    "TorchImage::FromImage copied the pixel buffer" );
+  itkAssertOrThrowMacro( torchImage->GetBufferedRegion() == image->GetBufferedRegion(),
+    "TorchImage::FromImage failed to copy the buffered region" );
+  itkAssertOrThrowMacro( torchImage->GetLargestPossibleRegion() == image->GetLargestPossibleRegion(),
+    "TorchImage::FromImage failed to copy the largest possible region" );
+  itkAssertOrThrowMacro( torchImage->GetSpacing() == spacing, "TorchImage::FromImage failed to copy the spacing" );
+  itkAssertOrThrowMacro( torchImage->GetOrigin() == origin, "TorchImage::FromImage failed to copy the origin" );
+  itkAssertOrThrowMacro( torchImage->GetDirection() == direction, "TorchImage::FromImage failed to copy the direction" );
+
+  // Writes through either image are seen by the other.
+  ImageType::IndexType location = start;
+  const uint8_t secondComponents[] = {40, 50, 60};
+  torchImage->SetPixel( location, PixelType( secondComponents ) );
+  itkAssertOrThrowMacro( image->GetBufferPointer()[0] == PixelType( secondComponents ),
+    "TorchImage::FromImage does not share the pixel buffer" );
+
+  // The TorchImage keeps the buffer alive after the image is released.
+  const PixelType * const buffer = image->GetBufferPointer();
+  image = nullptr;
+  location[0] = start[0] + 1;
+  PixelType pixelValue = torchImage->GetPixel( location );
+  itkAssertOrThrowMacro( pixelValue == PixelType( firstComponents ), "TorchImage::FromImage lost the pixel buffer" );
+
+  ImageType::Pointer roundTrip = torchImage->ToImage();
+  itkAssertOrThrowMacro( roundTrip->GetBufferPointer() == buffer, "TorchImage::ToImage copied the pixel buffer" );
+  itkAssertOrThrowMacro( roundTrip->GetBufferedRegion() == torchImage->GetBufferedRegion(),
+    "TorchImage::ToImage failed to copy the buffered region" );
+  itkAssertOrThrowMacro( roundTrip->GetSpacing() == spacing, "TorchImage::ToImage failed to copy the spacing" );
+  itkAssertOrThrowMacro( roundTrip->GetOrigin() == origin, "TorchImage::ToImage failed to copy the origin" );
+  itkAssertOrThrowMacro( roundTrip->GetDirection() == direction, "TorchImage::ToImage failed to copy the direction" );
+
+  // The image keeps the tensor alive after the TorchImage is released.
+  torchImage = nullptr;
+  itkAssertOrThrowMacro( roundTrip->GetPixel( start ) == PixelType( secondComponents ),
+    "TorchImage::ToImage lost the pixel buffer" );
+
+  return EXIT_SUCCESS;
+}
+
+// Create sub-region views and check that they share pixels with
+// their parent image.
+int
+itkTorchImageRegionViewTest()
+{
+  constexpr int ImageDimension = 3;
+  constexpr int VectorDimension = 2;
+  using PixelType = itk::Vector< int16_t, VectorDimension >;
+  using ImageType = itk::TorchImage< PixelType, ImageDimension >;
+
+  ImageType::SizeType size;
+  size[0] = 10;
+  size[1] = 8;
+  size[2] = 6;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  const int16_t zeroComponents[] = {0, 0};
+  image->FillBuffer( PixelType( zeroComponents ) );
+
+  ImageType::IndexType regionIndex;
+  regionIndex[0] = 2;
+  regionIndex[1] = 3;
+  regionIndex[2] = 1;
+  ImageType::SizeType regionSize;
+  regionSize[0] = 5;
+  regionSize[1] = 4;
+  regionSize[2] = 2;
+  const ImageType::RegionType region( regionIndex, regionSize );
+
+  ImageType::Pointer view = image->CreateRegionView( region );
+  itkAssertOrThrowMacro( view->GetBufferedRegion() == region, "TorchImage::CreateRegionView set the wrong buffered region" );
+  itkAssertOrThrowMacro( view->GetLargestPossibleRegion() == image->GetLargestPossibleRegion(),
+    "TorchImage::CreateRegionView set the wrong largest possible region" );
+
+  // Filling the view fills only the region of the parent.
+  const int16_t fillComponents[] = {7, -7};
+  view->FillBuffer( PixelType( fillComponents ) );
+  ImageType::IndexType inside = regionIndex;
+  inside[0] += 4;
+  inside[2] += 1;
+  ImageType::IndexType outside = regionIndex;
+  outside[1] -= 1;
+  PixelType pixelValue = image->GetPixel( inside );
+  itkAssertOrThrowMacro( pixelValue == PixelType( fillComponents ), "TorchImage region view does not share pixels" );
+  pixelValue = image->GetPixel( outside );
+  itkAssertOrThrowMacro( pixelValue == PixelType( zeroComponents ), "TorchImage region view wrote outside its region" );
+
+  // Writes to the parent are seen through the view, at the same index.
+  const int16_t setComponents[] = {100, 200};
+  image->SetPixel( regionIndex, PixelType( setComponents ) );
+  pixelValue = view->GetPixel( regionIndex );
+  itkAssertOrThrowMacro( pixelValue == PixelType( setComponents ), "TorchImage region view uses the wrong index" );
+
+  // A view of a view, and the storage outliving the parent.
+  ImageType::RegionType innerRegion = region;
+  innerRegion.SetIndex( 0, regionIndex[0] + 1 );
+  innerRegion.SetSize( 0, 2 );
+  ImageType::Pointer innerView = view->CreateRegionView( innerRegion );
+  image = nullptr;
+  view = nullptr;
+  pixelValue = innerView->GetPixel( inside - ImageType::OffsetType{ { 2, 0, 0 } } );
+  itkAssertOrThrowMacro( pixelValue == PixelType( fillComponents ), "TorchImage region view lost its storage" );
+
+  // A region outside the buffered region is rejected.
+  ITK_TRY_EXPECT_EXCEPTION( innerView->CreateRegionView( region ) );
+
+  return EXIT_SUCCESS;
+}
+
+// Access pixels with the components-first layout and convert between
+// the two layouts.
+int
+itkTorchImageComponentLayoutTest()
+{
+  constexpr int ImageDimension = 3;
+  using PixelType = itk::RGBPixel< int16_t >;
+  using ImageType = itk::TorchImage< PixelType, ImageDimension >;
+
+  ImageType::SizeType size;
+  size[0] = 5;
+  size[1] = 4;
+  size[2] = 3;
+  ImageType::Pointer image = ImageType::New();
+  image->SetComponentLayout( ImageType::itkComponentsFirst );
+  itkAssertOrThrowMacro( image->GetComponentLayout() == ImageType::itkComponentsFirst,
+    "TorchImage::SetComponentLayout failed" );
+  image->SetRegions( size );
+  image->Allocate();
+  const std::vector< int64_t > firstSizes = { 3, 3, 4, 5 };
+  itkAssertOrThrowMacro( image->GetTensor().sizes() == torch::IntArrayRef( firstSizes ),
+    "TorchImage with itkComponentsFirst has the wrong tensor sizes" );
+
+  const int16_t fillComponents[] = {1, 2, 3};
+  image->FillBuffer( PixelType( fillComponents ) );
+  ImageType::IndexType index;
+  index[0] = 4;
+  index[1] = 2;
+  index[2] = 1;
+  const int16_t setComponents[] = {-10, 20, -30};
+  image->SetPixel( index, PixelType( setComponents ) );
+
+  // The components are the slowest varying dimension.
+  const torch::Tensor cpuTensor = image->GetTensor().cpu();
+  itkAssertOrThrowMacro( cpuTensor[2][1][2][4].item< int16_t >() == -30,
+    "TorchImage::SetPixel with itkComponentsFirst wrote to the wrong place" );
+  itkAssertOrThrowMacro( cpuTensor[1][0][0][0].item< int16_t >() == 2,
+    "TorchImage::FillBuffer with itkComponentsFirst failed" );
+
+  // Both access paths agree.
+  for( const bool directCPUAccess : { true, false } )
+    {
+    image->SetDirectCPUAccess( directCPUAccess );
+    PixelType pixelValue = image->GetPixel( index );
+    itkAssertOrThrowMacro( pixelValue == PixelType( setComponents ), "TorchImage::GetPixel with itkComponentsFirst failed" );
+    index[0] = 0;
+    pixelValue = image->GetPixel( index );
+    itkAssertOrThrowMacro( pixelValue == PixelType( fillComponents ), "TorchImage::GetPixel with itkComponentsFirst failed" );
+    index[0] = 4;
+    }
+
+  // Re-laying out the storage keeps the pixel values.
+  image->SetComponentLayout( ImageType::itkComponentsLast );
+  const std::vector< int64_t > lastSizes = { 3, 4, 5, 3 };
+  itkAssertOrThrowMacro( image->GetTensor().sizes() == torch::IntArrayRef( lastSizes ),
+    "TorchImage::SetComponentLayout has the wrong tensor sizes" );
+  itkAssertOrThrowMacro( image->GetTensor().is_contiguous(), "TorchImage::SetComponentLayout is not contiguous" );
+  PixelType pixelValue = image->GetPixel( index );
+  itkAssertOrThrowMacro( pixelValue == PixelType( setComponents ), "TorchImage::SetComponentLayout lost pixel values" );
+
+  // A scalar image is re-laid out without a copy.
+  using ScalarImageType = itk::TorchImage< float, ImageDimension >;
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions( size );
+  scalarImage->Allocate();
+  const void * const buffer = scalarImage->GetTensor().data_ptr();
+  scalarImage->SetComponentLayout( ScalarImageType::itkComponentsFirst );
+  itkAssertOrThrowMacro( scalarImage->GetTensor().data_ptr() == buffer, "TorchImage::SetComponentLayout copied a scalar image" );
+
+  return EXIT_SUCCESS;
+}
+
+// Map images onto a file in each memory map mode.
+int
+itkTorchImageMemoryMapTest( const char * const fileName )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using PixelType = itk::Vector< int16_t, 2 >;
+  using ImageType = itk::TorchImage< PixelType, ImageDimension >;
+
+  ImageType::SizeType size;
+  size[0] = 5;
+  size[1] = 4;
+  size[2] = 3;
+  const ImageType::RegionType region( size );
+  const auto makeImage = [&region]()
+    {
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions( region );
+    return image;
+    };
+
+  // The raw tensor follows a header whose length is not a multiple of
+  // the page size.
+  constexpr uint64_t offset = 100;
+  ImageType::Pointer reference = makeImage();
+  reference->SetTensor( torch::arange( 5 * 4 * 3 * 2, torch::dtype( ImageType::TorchValueType ) ).reshape(
+    reference->ComputeTorchSize() ) );
+  {
+    std::ofstream file( fileName, std::ios::binary | std::ios::trunc );
+    const std::vector< char > header( offset, 0 );
+    file.write( header.data(), offset );
+    file.write( static_cast< const char * >( reference->GetTensor().data_ptr() ),
+      reference->GetTensor().numel() * sizeof( int16_t ) );
+  }
+
+#ifdef _WIN32
+  ITK_TRY_EXPECT_EXCEPTION( makeImage()->AllocateFromFile( fileName ) );
+#else
+  ImageType::IndexType index;
+  index[0] = 4;
+  index[1] = 2;
+  index[2] = 1;
+  const PixelType original = reference->GetPixel( index );
+  PixelType changed;
+  changed[0] = -1;
+  changed[1] = -2;
+
+  ImageType::Pointer image = makeImage();
+  image->AllocateFromFile( fileName, ImageType::itkMapReadOnly, offset );
+  itkAssertOrThrowMacro( torch::equal( image->GetTensor(), reference->GetTensor() ),
+    "TorchImage::AllocateFromFile read the wrong pixels" );
+  const ImageType * constImage = image.GetPointer();
+  itkAssertOrThrowMacro( constImage->GetPixel( index ) == original, "TorchImage::GetPixel failed on a mapped file" );
+
+  // A read-only image refuses writes, unlike its clones and the
+  // images allocated otherwise.
+  ITK_TEST_EXPECT_TRUE( image->GetReadOnly() );
+  ITK_TRY_EXPECT_EXCEPTION( image->SetPixel( index, changed ) );
+  ITK_TRY_EXPECT_EXCEPTION( image->FillBuffer( changed ) );
+  ITK_TRY_EXPECT_EXCEPTION( image->GetBufferPointer() );
+  itkAssertOrThrowMacro( image->GetPixel( index ) == original, "TorchImage::GetPixel failed on a read-only image" );
+  ITK_TRY_EXPECT_EXCEPTION( image->GetPixel( index ) = changed );
+  ImageType::ITKImagePointer readOnlyCopy = image->ToImage();
+  ITK_TEST_EXPECT_TRUE( readOnlyCopy->GetBufferPointer() != constImage->GetBufferPointer() );
+  readOnlyCopy->SetPixel( index, changed );
+  itkAssertOrThrowMacro( constImage->GetPixel( index ) == original, "Writing to ToImage() changed a read-only image" );
+  ImageType::Pointer readOnlyView = image->CreateRegionView( image->GetBufferedRegion() );
+  ITK_TEST_EXPECT_TRUE( readOnlyView->GetReadOnly() );
+  ITK_TRY_EXPECT_EXCEPTION( readOnlyView->SetPixel( index, changed ) );
+  ImageType::Pointer readOnlyClone = image->Clone();
+  ITK_TEST_EXPECT_TRUE( readOnlyClone->IsTensorShared() );
+  readOnlyView = nullptr;
+  image = nullptr;
+  readOnlyClone->SetPixel( index, changed );
+  ITK_TEST_EXPECT_TRUE( !readOnlyClone->GetReadOnly() );
+  itkAssertOrThrowMacro( readOnlyClone->GetPixel( index ) == changed,
+    "TorchImage::SetPixel failed on a clone of a mapped file" );
+  image = makeImage();
+  image->AllocateFromFile( fileName, ImageType::itkMapReadOnly, offset );
+  constImage = image.GetPointer();
+
+  // Private writes do not reach the file.
+  ImageType::Pointer copyOnWrite = makeImage();
+  copyOnWrite->AllocateFromFile( fileName, ImageType::itkMapCopyOnWrite, offset );
+  copyOnWrite->SetPixel( index, changed );
+  itkAssertOrThrowMacro( copyOnWrite->GetPixel( index ) == changed, "TorchImage::SetPixel failed on a mapped file" );
+  itkAssertOrThrowMacro( constImage->GetPixel( index ) == original, "itkMapCopyOnWrite changed the file" );
+
+  // Shared writes do.
+  ImageType::Pointer shared = makeImage();
+  shared->AllocateFromFile( fileName, ImageType::itkMapShared, offset );
+  shared->SetPixel( index, changed );
+  shared = nullptr;
+  image = makeImage();
+  image->AllocateFromFile( fileName, ImageType::itkMapReadOnly, offset );
+  constImage = image.GetPointer();
+  itkAssertOrThrowMacro( constImage->GetPixel( index ) == changed, "itkMapShared did not change the file" );
+
+  // A file that is too short cannot be mapped for reading, but is
+  // extended for shared writing.
+  ITK_TRY_EXPECT_EXCEPTION( makeImage()->AllocateFromFile( fileName, ImageType::itkMapReadOnly, offset + 1 ) );
+  ITK_TRY_EXPECT_EXCEPTION( makeImage()->AllocateFromFile( std::string( fileName ) + ".missing" ) );
+  shared = makeImage();
+  ITK_TRY_EXPECT_NO_EXCEPTION( shared->AllocateFromFile( fileName, ImageType::itkMapShared, 2 * offset ) );
+#endif
+
+  return EXIT_SUCCESS;
+}
+
+// Save and load images, with and without memory mapping.
+int
+itkTorchImageSaveLoadTest( const char * const fileName )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using PixelType = itk::Vector< float, 3 >;
+  using ImageType = itk::TorchImage< PixelType, ImageDimension >;
+
+  ImageType::IndexType start;
+  start[0] = -2;
+  start[1] = 4;
+  start[2] = 1;
+  ImageType::SizeType size;
+  size[0] = 6;
+  size[1] = 5;
+  size[2] = 4;
+  const ImageType::RegionType region( start, size );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->SetComponentLayout( ImageType::itkComponentsFirst );
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.25;
+  spacing[1] = 1.5;
+  spacing[2] = 3.0;
+  image->SetSpacing( spacing );
+  ImageType::PointType origin;
+  origin[0] = 11.0;
+  origin[1] = -4.0;
+  origin[2] = 0.5;
+  image->SetOrigin( origin );
+  ImageType::DirectionType direction;
+  direction.Fill( 0.0 );
+  direction[0][1] = 1.0;
+  direction[1][0] = -1.0;
+  direction[2][2] = 1.0;
+  image->SetDirection( direction );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+  using SerializerType = itk::TorchImageSerializer< ImageType >;
+  SerializerType::Pointer serializer = SerializerType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( serializer, TorchImageSerializer, Object );
+  ITK_TRY_EXPECT_NO_EXCEPTION( serializer->Save( image, fileName ) );
+
+  // The file is what Python's torch.load reads: a dictionary with the
+  // tensor and the meta information.
+  {
+    std::ifstream file( fileName, std::ios::binary );
+    const std::vector< char > bytes( ( std::istreambuf_iterator< char >( file ) ), std::istreambuf_iterator< char >() );
+    const c10::IValue value = torch::jit::pickle_load( bytes );
+    itkAssertOrThrowMacro( value.isGenericDict(), "TorchImageSerializer::Save did not save a dictionary" );
+    itkAssertOrThrowMacro( torch::equal( value.toGenericDict().at( "tensor" ).toTensor(), image->GetTensor() ),
+      "TorchImageSerializer::Save did not save the tensor" );
+  }
+
+#ifdef _WIN32
+  constexpr bool canMemoryMap = false;
+#else
+  constexpr bool canMemoryMap = true;
+#endif
+  for( const bool memoryMap : { false, canMemoryMap } )
+    {
+    ImageType::Pointer loaded = ImageType::New();
+    serializer->SetMemoryMap( memoryMap );
+    ITK_TEST_SET_GET_VALUE( memoryMap, serializer->GetMemoryMap() );
+    ITK_TRY_EXPECT_NO_EXCEPTION( serializer->Load( loaded, fileName ) );
+    ITK_TEST_EXPECT_EQUAL( loaded->GetBufferedRegion(), region );
+    ITK_TEST_EXPECT_EQUAL( loaded->GetLargestPossibleRegion(), region );
+    ITK_TEST_EXPECT_EQUAL( loaded->GetSpacing(), spacing );
+    ITK_TEST_EXPECT_EQUAL( loaded->GetOrigin(), origin );
+    ITK_TEST_EXPECT_EQUAL( loaded->GetDirection(), direction );
+    ITK_TEST_EXPECT_EQUAL( loaded->GetComponentLayout(), ImageType::itkComponentsFirst );
+    itkAssertOrThrowMacro( torch::equal( loaded->GetTensor(), image->GetTensor() ),
+      "TorchImageSerializer::Load did not load the tensor" );
+    ImageType::IndexType index = start;
+    index[1] += 2;
+    itkAssertOrThrowMacro( loaded->GetPixel( index ) == image->GetPixel( index ),
+      "TorchImage::GetPixel failed on a loaded image" );
+
+    // Writes to a loaded image, memory mapped or not, do not reach the
+    // file.
+    PixelType value;
+    value.Fill( 42.0f );
+    loaded->SetPixel( index, value );
+    }
+  ImageType::Pointer reloaded = ImageType::New();
+  serializer->SetMemoryMap( canMemoryMap );
+  serializer->Load( reloaded, fileName );
+  itkAssertOrThrowMacro( torch::equal( reloaded->GetTensor(), image->GetTensor() ),
+    "Writing to a memory mapped image changed the file" );
+
+  // A region view is saved compactly, with its own regions.
+  ImageType::IndexType viewStart = start;
+  viewStart[0] += 1;
+  ImageType::SizeType viewSize = size;
+  viewSize[0] = 2;
+  const ImageType::RegionType viewRegion( viewStart, viewSize );
+  ImageType::Pointer view = image->CreateRegionView( viewRegion );
+  serializer->Save( view, fileName );
+  serializer->Load( reloaded, fileName );
+  ITK_TEST_EXPECT_EQUAL( reloaded->GetBufferedRegion(), viewRegion );
+  itkAssertOrThrowMacro( torch::equal( reloaded->GetTensor(), view->GetTensor() ),
+    "TorchImageSerializer::Save did not save a region view" );
+  itkAssertOrThrowMacro( reloaded->GetTensor().storage().nbytes() == viewRegion.GetNumberOfPixels() * sizeof( PixelType ),
+    "TorchImageSerializer::Save saved more than a region view" );
+
+  // The pixel type must have the same components; the dtype may differ.
+  using ScalarImageType = itk::TorchImage< float, ImageDimension >;
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  ITK_TRY_EXPECT_EXCEPTION( itk::TorchImageSerializer< ScalarImageType >::New()->Load( scalarImage, fileName ) );
+  using DoubleImageType = itk::TorchImage< itk::Vector< double, 3 >, ImageDimension >;
+  DoubleImageType::Pointer doubleImage = DoubleImageType::New();
+  ITK_TRY_EXPECT_NO_EXCEPTION( itk::TorchImageSerializer< DoubleImageType >::New()->Load( doubleImage, fileName ) );
+  itkAssertOrThrowMacro( torch::allclose( doubleImage->GetTensor().cpu(), view->GetTensor().to( torch::kDouble ) ),
+    "TorchImageSerializer::Load did not convert the dtype" );
+
+  return EXIT_SUCCESS;
+}
+
 int itkTorchImageTest( int argc, char *argv[] )
 {
   std::cout << "Test compiled " << __DATE__ << " " << __TIME__ << std::endl;
 
-  if ( argc < 2 )
+  if ( argc < 4 )
     {
     std::cerr << "Missing parameters." << std::endl;
     std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv );
-    std::cerr << " outputImage";
+    std::cerr << " outputImage memoryMappedFile savedImage";
     std::cerr << std::endl;
     return EXIT_FAILURE;
     }
   // const char * const outputImageFileName = argv[1];
+  const char * const memoryMappedFileName = argv[2];
+  const char * const savedImageFileName = argv[3];
 
   // Torch supports:
   //   Unsigned integer types: 1, 8 bits.
@@ -381,6 +936,56 @@ int itkTorchImageTest( int argc, char *argv[] )
       }
   }
 
+  {
+    const int response = itkTorchImageComponentLayoutTest();
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+  {
+    const int response = itkTorchImageRegionViewTest();
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+  {
+    const int response = itkTorchImageConversionTest();
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+  {
+    const int response = itkTorchImageDirectCPUAccessTest();
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+  {
+    const int response = itkTorchImageFillBufferTest();
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+  {
+    const int response = itkTorchImageMemoryMapTest( memoryMappedFileName );
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+  {
+    const int response = itkTorchImageSaveLoadTest( savedImageFileName );
+    if( response != EXIT_SUCCESS )
+      {
+      return response;
+      }
+  }
+
   std::cout << "Test finished." << std::endl;
   return EXIT_SUCCESS;
 }
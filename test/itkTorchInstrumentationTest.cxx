@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchInstrumentation.h"
+#include "itkTorchImage.h"
+
+#include "itkCommand.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+namespace
+{
+class CountInstrumentationEvents : public itk::Command
+{
+public:
+  itkNewMacro( CountInstrumentationEvents );
+
+  void
+  Execute( itk::Object *caller, const itk::EventObject &event ) override
+  {
+    Execute( ( const itk::Object * )caller, event );
+  }
+
+  void
+  Execute( const itk::Object *itkNotUsed( caller ), const itk::EventObject &event ) override
+  {
+    const auto *instrumentationEvent = dynamic_cast< const itk::TorchInstrumentationEvent * >( &event );
+    if( instrumentationEvent == nullptr )
+      {
+      return;
+      }
+    ++m_NumberOfEvents;
+    m_NumberOfBytes += instrumentationEvent->GetNumberOfBytes();
+    std::cout << " " << event.GetEventName() << " of " << instrumentationEvent->GetNumberOfBytes() << " bytes in "
+      << instrumentationEvent->GetSeconds() << " s" << std::endl;
+  }
+
+  unsigned int m_NumberOfEvents{ 0 };
+  uint64_t m_NumberOfBytes{ 0 };
+};
+} // namespace
+
+int itkTorchInstrumentationTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using Counters = itk::TorchInstrumentationCounters;
+
+  itk::TorchInstrumentation::Pointer instrumentation = itk::TorchInstrumentation::GetInstance();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( instrumentation, TorchInstrumentation, Object );
+  itkAssertOrThrowMacro( instrumentation == itk::TorchInstrumentation::GetInstance(),
+    "TorchInstrumentation is not a singleton" );
+  ITK_TEST_SET_GET_BOOLEAN( instrumentation, Enabled, true );
+
+  ImageType::SizeType size;
+  size[0] = 32;
+  size[1] = 24;
+  size[2] = 16;
+  const uint64_t imageBytes = size[0] * size[1] * size[2] * 2 * sizeof( float );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+
+  // Nothing is counted while the instrumentation is disabled.
+  instrumentation->SetEnabled( false );
+  instrumentation->ResetCounters();
+  image->Allocate( ImageType::itkZeros );
+  ITK_TEST_EXPECT_EQUAL( image->GetInstrumentationCounters().GetCount( Counters::itkAllocation ), 0 );
+  ITK_TEST_EXPECT_EQUAL( instrumentation->GetCounters().GetCount( Counters::itkAllocation ), 0 );
+
+  instrumentation->EnabledOn();
+  CountInstrumentationEvents::Pointer imageObserver = CountInstrumentationEvents::New();
+  image->AddObserver( itk::TorchInstrumentationEvent(), imageObserver );
+  CountInstrumentationEvents::Pointer copyObserver = CountInstrumentationEvents::New();
+  instrumentation->AddObserver( itk::TorchCopyEvent(), copyObserver );
+
+  image->Allocate( ImageType::itkOnes );
+  const Counters & counters = image->GetInstrumentationCounters();
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkAllocation ), 1 );
+  ITK_TEST_EXPECT_EQUAL( counters.GetNumberOfBytes( Counters::itkAllocation ), imageBytes );
+  ITK_TEST_EXPECT_TRUE( counters.GetSeconds( Counters::itkAllocation ) >= 0.0 );
+  ITK_TEST_EXPECT_EQUAL( instrumentation->GetCounters().GetNumberOfBytes( Counters::itkAllocation ), imageBytes );
+  ITK_TEST_EXPECT_EQUAL( imageObserver->m_NumberOfEvents, 1 );
+
+  // Direct CPU access goes through no proxy.
+  ImageType::IndexType index;
+  index[0] = 3;
+  index[1] = 5;
+  index[2] = 7;
+  ImageType::PixelType value;
+  value[0] = 1.5f;
+  value[1] = -2.5f;
+  image->SetPixel( index, value );
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkPixelProxyAccess ), 0 );
+
+  // Indexed access counts each whole pixel once, not each component.
+  image->DirectCPUAccessOff();
+  image->SetPixel( index, value );
+  const ImageType::PixelType readValue = image->GetPixel( index );
+  ITK_TEST_EXPECT_EQUAL( readValue, value );
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkPixelProxyAccess ), 2 );
+  ITK_TEST_EXPECT_EQUAL( counters.GetNumberOfBytes( Counters::itkPixelProxyAccess ), 2 * 2 * sizeof( float ) );
+  image->DirectCPUAccessOn();
+
+  // ToImage() shares a contiguous buffer but copies a permuted one, as
+  // does the change of layout itself.
+  image->ToImage();
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkCopy ), 0 );
+  image->SetComponentLayout( ImageType::itkComponentsFirst );
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkCopy ), 1 );
+  image->ToImage();
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkCopy ), 2 );
+  ITK_TEST_EXPECT_EQUAL( counters.GetNumberOfBytes( Counters::itkCopy ), 2 * imageBytes );
+  ITK_TEST_EXPECT_EQUAL( copyObserver->m_NumberOfEvents, 2 );
+  ITK_TEST_EXPECT_EQUAL( copyObserver->m_NumberOfBytes, 2 * imageBytes );
+
+  // A scalar image changes layout without copying.
+  using ScalarImageType = itk::TorchImage< float, ImageDimension >;
+  ScalarImageType::Pointer scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions( size );
+  scalarImage->SetDevice( ScalarImageType::itkCPU );
+  scalarImage->Allocate();
+  scalarImage->SetComponentLayout( ScalarImageType::itkComponentsFirst );
+  ITK_TEST_EXPECT_EQUAL( scalarImage->GetInstrumentationCounters().GetCount( Counters::itkCopy ), 0 );
+  ITK_TEST_EXPECT_EQUAL( instrumentation->GetCounters().GetCount( Counters::itkAllocation ), 2 );
+
+  // Moves between devices.
+  if( image->SetDevice( ImageType::itkCUDA ) )
+    {
+    image->SetDevice( ImageType::itkCPU );
+    ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkDeviceTransfer ), 2 );
+    ITK_TEST_EXPECT_EQUAL( counters.GetNumberOfBytes( Counters::itkDeviceTransfer ), 2 * imageBytes );
+    }
+  else
+    {
+    std::cout << "CUDA is not available; device transfers are not tested." << std::endl;
+    ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkDeviceTransfer ), 0 );
+    }
+
+  image->Print( std::cout );
+  instrumentation->Print( std::cout );
+
+  image->ResetInstrumentationCounters();
+  ITK_TEST_EXPECT_EQUAL( counters.GetCount( Counters::itkCopy ), 0 );
+  ITK_TEST_EXPECT_EQUAL( instrumentation->GetCounters().GetCount( Counters::itkCopy ), 2 );
+  instrumentation->ResetCounters();
+  ITK_TEST_EXPECT_EQUAL( instrumentation->GetCounters().GetCount( Counters::itkCopy ), 0 );
+
+  instrumentation->RemoveAllObservers();
+  instrumentation->SetEnabled( false );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchIntensityNormalizeImageFilter.h"
+
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+int itkTorchIntensityNormalizeImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using InputImageType = itk::TorchImage< int16_t, ImageDimension >;
+  using OutputImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchIntensityNormalizeImageFilter< InputImageType, OutputImageType >;
+
+  // A CT-like int16 volume, large enough to be processed in several
+  // slabs.
+  InputImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 48;
+  size[2] = 40;
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( size );
+  input->SetDevice( InputImageType::itkCPU );
+  input->SetTensor( torch::randint( -1024, 3000, input->ComputeTorchSize(), torch::dtype( torch::kShort ) ) );
+  const torch::Tensor values = input->GetTensor().to( torch::kDouble );
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchIntensityNormalizeImageFilter, ImageToImageFilter );
+  filter->SetInput( input );
+  const auto check = [&filter]( const torch::Tensor & expected, const char *message )
+    {
+    filter->Update();
+    const torch::Tensor output = filter->GetOutput()->GetTensor();
+    itkAssertOrThrowMacro( output.scalar_type() == torch::kFloat, "Wrong output dtype" );
+    itkAssertOrThrowMacro( torch::allclose( output.to( torch::kDouble ), expected, 1e-5, 1e-5 ), message );
+    };
+
+  // Window/level.
+  filter->SetNormalization( FilterType::itkWindowLevel );
+  ITK_TEST_SET_GET_VALUE( FilterType::itkWindowLevel, filter->GetNormalization() );
+  filter->SetWindowLevel( 400.0, 40.0 );
+  ITK_TEST_SET_GET_VALUE( -160.0, filter->GetWindowMinimum() );
+  ITK_TEST_SET_GET_VALUE( 240.0, filter->GetWindowMaximum() );
+  ITK_TEST_SET_GET_VALUE( 400.0, filter->GetWindow() );
+  ITK_TEST_SET_GET_VALUE( 40.0, filter->GetLevel() );
+  check( ( ( values + 160.0 ) / 400.0 ).clamp( 0.0, 1.0 ), "itkWindowLevel is wrong" );
+
+  // Min-max to another output range.
+  filter->SetNormalization( FilterType::itkMinMax );
+  filter->SetOutputMinimum( -1.0 );
+  filter->SetOutputMaximum( 1.0 );
+  const double minimum = values.min().item< double >();
+  const double maximum = values.max().item< double >();
+  check( ( values - minimum ) / ( maximum - minimum ) * 2.0 - 1.0, "itkMinMax is wrong" );
+  ITK_TEST_EXPECT_TRUE( std::abs( filter->GetScale() - 2.0 / ( maximum - minimum ) ) < 1e-12 );
+
+  // Z-score.
+  filter->SetNormalization( FilterType::itkZScore );
+  check( ( values - values.mean() ) / values.std(), "itkZScore is wrong" );
+
+  // Percentiles.
+  filter->SetNormalization( FilterType::itkPercentile );
+  filter->SetLowerPercentile( 1.0 );
+  filter->SetUpperPercentile( 99.0 );
+  filter->SetOutputMinimum( 0.0 );
+  {
+    const torch::Tensor sorted = std::get< 0 >( values.reshape( { -1 } ).sort() );
+    const int64_t last = sorted.numel() - 1;
+    const double lower = sorted[std::llround( 0.01 * last )].item< double >();
+    const double upper = sorted[std::llround( 0.99 * last )].item< double >();
+    check( ( ( values - lower ) / ( upper - lower ) ).clamp( 0.0, 1.0 ), "itkPercentile is wrong" );
+  }
+
+  // A mask restricts the statistics but not the normalization.
+  using MaskImageType = FilterType::MaskImageType;
+  MaskImageType::Pointer mask = MaskImageType::New();
+  mask->SetRegions( size );
+  mask->SetDevice( MaskImageType::itkCPU );
+  mask->Allocate( MaskImageType::itkZeros );
+  mask->GetTensor().narrow( 0, 10, 20 ).fill_( 1 );
+  filter->SetMaskImage( mask );
+  ITK_TEST_SET_GET_VALUE( mask.GetPointer(), filter->GetMaskImage() );
+  filter->SetNormalization( FilterType::itkZScore );
+  {
+    const torch::Tensor masked = values.narrow( 0, 10, 20 );
+    check( ( values - masked.mean() ) / masked.std(), "itkZScore with a mask is wrong" );
+  }
+  mask->GetTensor().zero_();
+  mask->Modified();
+  ITK_TRY_EXPECT_EXCEPTION( filter->Update() );
+  filter->SetMaskImage( nullptr );
+
+  // Integer outputs are rounded and clamped to the output range.
+  using ByteImageType = itk::TorchImage< unsigned char, ImageDimension >;
+  using ByteFilterType = itk::TorchIntensityNormalizeImageFilter< InputImageType, ByteImageType >;
+  ByteFilterType::Pointer byteFilter = ByteFilterType::New();
+  byteFilter->SetInput( input );
+  byteFilter->SetNormalization( ByteFilterType::itkWindowLevel );
+  byteFilter->SetWindowLevel( 1500.0, -600.0 );
+  byteFilter->SetOutputMaximum( 255.0 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( byteFilter->Update() );
+  ITK_TEST_EXPECT_TRUE( std::abs( byteFilter->GetScale() - 255.0 / 1500.0 ) < 1e-12 );
+  ITK_TEST_EXPECT_TRUE( std::abs( byteFilter->GetShift() - 1350.0 * 255.0 / 1500.0 ) < 1e-9 );
+  const torch::Tensor expectedBytes = torch::add( torch::scalar_tensor( byteFilter->GetShift(), torch::kFloat ),
+    input->GetTensor(), byteFilter->GetScale() ).round().clamp( 0.0, 255.0 ).to( torch::kByte );
+  itkAssertOrThrowMacro( torch::equal( byteFilter->GetOutput()->GetTensor(), expectedBytes ),
+    "Integer output is wrong" );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
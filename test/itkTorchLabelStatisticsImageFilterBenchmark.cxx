@@ -0,0 +1,90 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchLabelStatisticsImageFilter.h"
+
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkTorchLabelStatisticsImageFilterBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using LabelImageType = itk::TorchImage< unsigned char, ImageDimension >;
+  using FilterType = itk::TorchLabelStatisticsImageFilter< ImageType, LabelImageType >;
+  using ITKFilterType = itk::LabelStatisticsImageFilter< ImageType::ITKImageType, LabelImageType::ITKImageType >;
+
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  itk::TorchBenchmark benchmark( "TorchLabelStatisticsImageFilter", 5 );
+  for( const int64_t numberOfLabels : { 2, 100 } )
+    {
+    LabelImageType::Pointer labelImage = LabelImageType::New();
+    labelImage->SetRegions( size );
+    labelImage->SetTensor( torch::randint( numberOfLabels, { 128, 128, 128 }, torch::dtype( torch::kByte ) ) );
+    for( const bool useHistograms : { false, true } )
+      {
+      const std::string variant =
+        std::to_string( numberOfLabels ) + " labels" + ( useHistograms ? ", histograms" : "" );
+
+      FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( image );
+      filter->SetLabelInput( labelImage );
+      ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+      itkFilter->SetInput( image->ToImage() );
+      itkFilter->SetLabelInput( labelImage->ToImage() );
+      if( useHistograms )
+        {
+        filter->SetHistogramParameters( 64, -8.0, 8.0 );
+        itkFilter->SetHistogramParameters( 64, -8.0, 8.0 );
+        }
+
+      benchmark.Time( "TorchLabelStatisticsImageFilter", variant, "float", ImageDimension, numberOfPixels,
+        [&]()
+          {
+          filter->Modified();
+          filter->Update();
+          } );
+      benchmark.Time( "LabelStatisticsImageFilter", variant, "float", ImageDimension, numberOfPixels,
+        [&]()
+          {
+          itkFilter->Modified();
+          itkFilter->Update();
+          } );
+      }
+    }
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchLabelStatisticsImageFilter.h"
+
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+int itkTorchLabelStatisticsImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using LabelImageType = itk::TorchImage< unsigned char, ImageDimension >;
+  using FilterType = itk::TorchLabelStatisticsImageFilter< ImageType, LabelImageType >;
+
+  ImageType::IndexType start;
+  start[0] = -5;
+  start[1] = 0;
+  start[2] = 7;
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 48;
+  size[2] = 32;
+  const ImageType::RegionType region( start, size );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  // About 100 labels, with gaps between the values, a label with a
+  // single pixel and a label confined to a box.
+  LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->SetRegions( region );
+  labelImage->SetTensor( ( torch::randint( 100, { 32, 48, 64 }, torch::dtype( torch::kLong ) ) * 2 )
+    .to( torch::kByte ) );
+  labelImage->GetTensor().narrow( 0, 20, 3 ).narrow( 1, 10, 5 ).narrow( 2, 40, 7 ).fill_( 201 );
+  labelImage->GetTensor()[31][47][63] = 255;
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchLabelStatisticsImageFilter, ImageToImageFilter );
+  filter->SetInput( image );
+  ITK_TRY_EXPECT_EXCEPTION( filter->Update() );
+  filter->SetLabelInput( labelImage );
+  ITK_TEST_SET_GET_VALUE( labelImage.GetPointer(), filter->GetLabelInput() );
+  ITK_TEST_EXPECT_TRUE( !filter->GetUseHistograms() );
+  constexpr unsigned int numberOfBins = 16;
+  filter->SetHistogramParameters( numberOfBins, -8.0, 8.0 );
+  ITK_TEST_EXPECT_TRUE( filter->GetUseHistograms() );
+
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  using ITKFilterType = itk::LabelStatisticsImageFilter< ImageType::ITKImageType, LabelImageType::ITKImageType >;
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  itkFilter->SetLabelInput( labelImage->ToImage() );
+  itkFilter->SetHistogramParameters( numberOfBins, -8.0, 8.0 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( itkFilter->Update() );
+
+  ITK_TEST_EXPECT_EQUAL( filter->GetNumberOfLabels(), itkFilter->GetNumberOfLabels() );
+  ITK_TEST_EXPECT_TRUE( filter->GetOutput()->GetTensor().is_same( image->GetTensor() ) );
+  const auto close = []( double a, double b )
+    {
+    return std::abs( a - b ) <= 1e-9 + 1e-9 * std::abs( b );
+    };
+  for( const FilterType::LabelPixelType label : filter->GetValidLabelValues() )
+    {
+    ITK_TEST_EXPECT_TRUE( itkFilter->HasLabel( label ) );
+    ITK_TEST_EXPECT_EQUAL( filter->GetCount( label ), itkFilter->GetCount( label ) );
+    ITK_TEST_EXPECT_EQUAL( filter->GetMinimum( label ), itkFilter->GetMinimum( label ) );
+    ITK_TEST_EXPECT_EQUAL( filter->GetMaximum( label ), itkFilter->GetMaximum( label ) );
+    ITK_TEST_EXPECT_TRUE( close( filter->GetSum( label ), itkFilter->GetSum( label ) ) );
+    ITK_TEST_EXPECT_TRUE( close( filter->GetMean( label ), itkFilter->GetMean( label ) ) );
+    ITK_TEST_EXPECT_TRUE( std::abs( filter->GetVariance( label ) - itkFilter->GetVariance( label ) ) < 1e-6 );
+    ITK_TEST_EXPECT_TRUE( filter->GetBoundingBox( label ) == itkFilter->GetBoundingBox( label ) );
+    ITK_TEST_EXPECT_EQUAL( filter->GetRegion( label ), itkFilter->GetRegion( label ) );
+    const FilterType::HistogramPointer histogram = filter->GetHistogram( label );
+    const ITKFilterType::HistogramPointer itkHistogram = itkFilter->GetHistogram( label );
+    ITK_TEST_EXPECT_EQUAL( histogram->GetSize( 0 ), itkHistogram->GetSize( 0 ) );
+    for( unsigned int b = 0; b < numberOfBins; ++b )
+      {
+      ITK_TEST_EXPECT_EQUAL( histogram->GetFrequency( b ), itkHistogram->GetFrequency( b ) );
+      }
+    }
+
+  ITK_TEST_EXPECT_EQUAL( filter->GetCount( 255 ), 1 );
+  ITK_TEST_EXPECT_EQUAL( filter->GetVariance( 255 ), 0.0 );
+  ITK_TEST_EXPECT_EQUAL( filter->GetRegion( 201 ).GetSize( 0 ), 7 );
+  ITK_TEST_EXPECT_TRUE( !filter->HasLabel( 1 ) );
+  ITK_TEST_EXPECT_EQUAL( filter->GetCount( 1 ), 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
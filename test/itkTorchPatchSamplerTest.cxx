@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchPatchSampler.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchPatchSamplerTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using SamplerType = itk::TorchPatchSampler< ImageType >;
+  using LabelImageType = SamplerType::LabelImageType;
+
+  // Every pixel holds its offset in the buffer, so that a patch tells
+  // where it was cut from.
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  start[2] = 0;
+  ImageType::SizeType size;
+  size[0] = 40;
+  size[1] = 30;
+  size[2] = 20;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( start, size ) );
+  image->SetSpacing( spacing );
+  image->SetTensor( torch::arange( 40 * 30 * 20, torch::dtype( torch::kFloat ) ).reshape( { 20, 30, 40 } ) );
+
+  SamplerType::SizeType patchSize;
+  patchSize[0] = 8;
+  patchSize[1] = 6;
+  patchSize[2] = 5;
+
+  SamplerType::Pointer sampler = SamplerType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( sampler, TorchPatchSampler, Object );
+  ITK_TRY_EXPECT_EXCEPTION( sampler->Sample() );
+  sampler->SetImage( image );
+  ITK_TEST_SET_GET_VALUE( image.GetPointer(), sampler->GetImage() );
+  ITK_TRY_EXPECT_EXCEPTION( sampler->Sample() );
+  sampler->SetPatchSize( patchSize );
+  ITK_TEST_SET_GET_VALUE( patchSize, sampler->GetPatchSize() );
+
+  // Each patch is the region of the image at its index.
+  const auto checkPatches = [&image, &patchSize]( const torch::Tensor & patches,
+    const std::vector< ImageType::IndexType > & indices, const std::vector< ImageType::PointType > & origins )
+    {
+    itkAssertOrThrowMacro( patches.size( 0 ) == static_cast< int64_t >( indices.size() )
+      && indices.size() == origins.size(), "TorchPatchSampler reports a wrong number of patches" );
+    for( size_t p = 0; p < indices.size(); ++p )
+      {
+      const ImageType::OffsetType offset = indices[p] - image->GetBufferedRegion().GetIndex();
+      const torch::Tensor expected = image->GetTensor().narrow( 0, offset[2], patchSize[2] )
+        .narrow( 1, offset[1], patchSize[1] ).narrow( 2, offset[0], patchSize[0] );
+      itkAssertOrThrowMacro( torch::equal( patches[p], expected ), "TorchPatchSampler cut a wrong patch" );
+      ImageType::PointType origin;
+      image->TransformIndexToPhysicalPoint( indices[p], origin );
+      itkAssertOrThrowMacro( origins[p] == origin, "TorchPatchSampler reports a wrong patch origin" );
+      }
+    };
+
+  ITK_TEST_SET_GET_VALUE( SamplerType::itkGridSampling, sampler->GetSampling() );
+  torch::Tensor patches = sampler->Sample();
+  ITK_TEST_EXPECT_TRUE( patches.sizes() == torch::IntArrayRef( { 5 * 5 * 4, 5, 6, 8 } ) );
+  ITK_TEST_EXPECT_EQUAL( sampler->GetPatchIndices().front(), start );
+  ITK_TEST_EXPECT_TRUE( !sampler->GetLabelPatches().defined() );
+  checkPatches( patches, sampler->GetPatchIndices(), sampler->GetPatchOrigins() );
+
+  SamplerType::SizeType stride;
+  stride[0] = 16;
+  stride[1] = 3;
+  stride[2] = 15;
+  sampler->SetStride( stride );
+  ITK_TEST_SET_GET_VALUE( stride, sampler->GetStride() );
+  patches = sampler->Sample();
+  ITK_TEST_EXPECT_EQUAL( patches.size( 0 ), 3 * 9 * 2 );
+  checkPatches( patches, sampler->GetPatchIndices(), sampler->GetPatchOrigins() );
+
+  sampler->SetSampling( SamplerType::itkRandomSampling );
+  sampler->SetNumberOfPatches( 16 );
+  ITK_TEST_SET_GET_VALUE( 16u, sampler->GetNumberOfPatches() );
+  sampler->SetSeed( 42 );
+  ITK_TEST_SET_GET_VALUE( 42u, sampler->GetSeed() );
+  patches = sampler->Sample();
+  ITK_TEST_EXPECT_EQUAL( patches.size( 0 ), 16 );
+  checkPatches( patches, sampler->GetPatchIndices(), sampler->GetPatchOrigins() );
+  // The same seed draws the same patches.
+  const std::vector< ImageType::IndexType > randomIndices = sampler->GetPatchIndices();
+  sampler->SetSeed( 42 );
+  sampler->Sample();
+  ITK_TEST_EXPECT_TRUE( sampler->GetPatchIndices() == randomIndices );
+
+  // Label-balanced patches are centered on a small labeled cube, or
+  // away from it.
+  LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->SetRegions( image->GetBufferedRegion() );
+  labelImage->SetDevice( LabelImageType::itkCPU );
+  labelImage->Allocate( LabelImageType::itkZeros );
+  labelImage->GetTensor().narrow( 0, 12, 2 ).narrow( 1, 4, 3 ).narrow( 2, 30, 4 ).fill_( 1 );
+  sampler->SetSampling( SamplerType::itkLabelBalancedSampling );
+  ITK_TRY_EXPECT_EXCEPTION( sampler->Sample() );
+  sampler->SetLabelImage( labelImage );
+  sampler->SetNumberOfPatches( 20 );
+  sampler->SetPositiveFraction( 0.25 );
+  ITK_TEST_SET_GET_VALUE( 0.25, sampler->GetPositiveFraction() );
+  patches = sampler->Sample();
+  checkPatches( patches, sampler->GetPatchIndices(), sampler->GetPatchOrigins() );
+  const torch::Tensor labelPatches = sampler->GetLabelPatches();
+  ITK_TEST_EXPECT_TRUE( labelPatches.sizes() == torch::IntArrayRef( { 20, 5, 6, 8 } ) );
+  // The positive patches contain the labeled pixel they were centered
+  // on, also where they were moved to fit in the image.
+  ITK_TEST_EXPECT_EQUAL( labelPatches.narrow( 0, 0, 5 ).ne( 0 ).flatten( 1 ).any( 1 ).sum().item< int64_t >(), 5 );
+
+  // Vector pixels keep their layout, with the patch number first.
+  using VectorImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using VectorSamplerType = itk::TorchPatchSampler< VectorImageType >;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( size );
+  vectorImage->SetComponentLayout( VectorImageType::itkComponentsFirst );
+  vectorImage->SetTensor( torch::stack( { image->GetTensor(), -image->GetTensor() } ) );
+  VectorSamplerType::Pointer vectorSampler = VectorSamplerType::New();
+  vectorSampler->SetImage( vectorImage );
+  vectorSampler->SetPatchSize( patchSize );
+  const torch::Tensor vectorPatches = vectorSampler->Sample();
+  ITK_TEST_EXPECT_TRUE( vectorPatches.sizes() == torch::IntArrayRef( { 5 * 5 * 4, 2, 5, 6, 8 } ) );
+  sampler->SetSampling( SamplerType::itkGridSampling );
+  stride.Fill( 0 );
+  sampler->SetStride( stride );
+  patches = sampler->Sample();
+  itkAssertOrThrowMacro( torch::equal( vectorPatches.select( 1, 0 ), patches )
+    && torch::equal( vectorPatches.select( 1, 1 ), -patches ),
+    "TorchPatchSampler cuts vector pixels wrongly" );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchResampleImageFilter.h"
+
+#include "itkAffineTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkResampleImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkTorchResampleImageFilterBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchResampleImageFilter< ImageType >;
+  using ITKFilterType = itk::ResampleImageFilter< ImageType::ITKImageType, ImageType::ITKImageType >;
+
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  // A rotation and scaling about the center of the image.
+  using TransformType = itk::AffineTransform< double, ImageDimension >;
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::InputPointType center;
+  center.Fill( 0.5 * ( size[0] - 1 ) );
+  transform->SetCenter( center );
+  TransformType::OutputVectorType axis;
+  axis[0] = 0.3;
+  axis[1] = -0.2;
+  axis[2] = 1.0;
+  transform->Rotate3D( axis, 0.4 );
+  transform->Scale( 1.1 );
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetOutputParametersFromImage( image );
+  filter->SetTransform( transform );
+
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  itkFilter->SetOutputParametersFromImage( itkFilter->GetInput() );
+  itkFilter->SetTransform( transform );
+
+  itk::TorchBenchmark benchmark( "TorchResampleImageFilter", 5 );
+  for( const FilterType::InterpolationType interpolation :
+         { FilterType::itkLinearInterpolation, FilterType::itkNearestInterpolation } )
+    {
+    std::string variant;
+    filter->SetInterpolation( interpolation );
+    if( interpolation == FilterType::itkLinearInterpolation )
+      {
+      variant = "linear";
+      itkFilter->SetInterpolator(
+        itk::LinearInterpolateImageFunction< ImageType::ITKImageType, double >::New().GetPointer() );
+      }
+    else
+      {
+      variant = "nearest";
+      itkFilter->SetInterpolator(
+        itk::NearestNeighborInterpolateImageFunction< ImageType::ITKImageType, double >::New().GetPointer() );
+      }
+
+    benchmark.Time( "TorchResampleImageFilter", variant, "float", ImageDimension, numberOfPixels,
+      [&]()
+        {
+        filter->Modified();
+        filter->Update();
+        } );
+    benchmark.Time( "ResampleImageFilter", variant, "float", ImageDimension, numberOfPixels,
+      [&]()
+        {
+        itkFilter->Modified();
+        itkFilter->Update();
+        } );
+    }
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,251 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchResampleImageFilter.h"
+
+#include "itkAffineTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkResampleImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchResampleImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using FilterType = itk::TorchResampleImageFilter< ImageType >;
+
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 56;
+  size[2] = 48;
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.2;
+  spacing[2] = 1.5;
+  ImageType::PointType origin;
+  origin[0] = -10.0;
+  origin[1] = 5.0;
+  origin[2] = 2.5;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  // A rotation and scaling about the center of the image.
+  using TransformType = itk::AffineTransform< double, ImageDimension >;
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::InputPointType center;
+  for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    center[j] = origin[j] + 0.5 * spacing[j] * ( size[j] - 1 );
+    }
+  transform->SetCenter( center );
+  TransformType::OutputVectorType axis;
+  axis[0] = 0.3;
+  axis[1] = -0.2;
+  axis[2] = 1.0;
+  transform->Rotate3D( axis, 0.4 );
+  transform->Scale( 1.1 );
+  TransformType::OutputVectorType translation;
+  translation[0] = 3.0;
+  translation[1] = -2.0;
+  translation[2] = 1.0;
+  transform->Translate( translation );
+
+  // A respaced, reoriented output grid that reaches outside of the
+  // input.
+  ImageType::SizeType outputSize;
+  outputSize[0] = 60;
+  outputSize[1] = 50;
+  outputSize[2] = 44;
+  ImageType::SpacingType outputSpacing;
+  outputSpacing.Fill( 1.3 );
+  ImageType::IndexType outputStartIndex;
+  outputStartIndex[0] = 2;
+  outputStartIndex[1] = -3;
+  outputStartIndex[2] = 0;
+  ImageType::DirectionType outputDirection;
+  outputDirection.SetIdentity();
+  outputDirection[0][0] = outputDirection[1][1] = std::cos( 0.2 );
+  outputDirection[0][1] = -std::sin( 0.2 );
+  outputDirection[1][0] = std::sin( 0.2 );
+  constexpr float defaultValue = -7.0f;
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchResampleImageFilter, ImageToImageFilter );
+  filter->SetInput( image );
+  filter->SetOutputParametersFromImage( image );
+  ITK_TEST_SET_GET_VALUE( size, filter->GetSize() );
+  ITK_TEST_SET_GET_VALUE( spacing, filter->GetOutputSpacing() );
+  ITK_TEST_SET_GET_VALUE( origin, filter->GetOutputOrigin() );
+
+  // The identity transform onto the grid of the input reproduces it.
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  itkAssertOrThrowMacro( torch::allclose( filter->GetOutput()->GetTensor(), image->GetTensor(), 1e-4, 1e-4 ),
+    "TorchResampleImageFilter does not reproduce the input with the identity transform" );
+
+  filter->SetTransform( transform );
+  ITK_TEST_SET_GET_VALUE( transform.GetPointer(), filter->GetTransform() );
+  filter->SetSize( outputSize );
+  filter->SetOutputSpacing( outputSpacing );
+  filter->SetOutputStartIndex( outputStartIndex );
+  ITK_TEST_SET_GET_VALUE( outputStartIndex, filter->GetOutputStartIndex() );
+  filter->SetOutputDirection( outputDirection );
+  ITK_TEST_SET_GET_VALUE( outputDirection, filter->GetOutputDirection() );
+  filter->SetDefaultPixelValue( defaultValue );
+  ITK_TEST_SET_GET_VALUE( defaultValue, filter->GetDefaultPixelValue() );
+
+  using ITKFilterType = itk::ResampleImageFilter< ImageType::ITKImageType, ImageType::ITKImageType >;
+  ITKFilterType::Pointer itkFilter = ITKFilterType::New();
+  itkFilter->SetInput( image->ToImage() );
+  itkFilter->SetTransform( transform );
+  itkFilter->SetSize( outputSize );
+  itkFilter->SetOutputSpacing( outputSpacing );
+  itkFilter->SetOutputOrigin( origin );
+  itkFilter->SetOutputStartIndex( outputStartIndex );
+  itkFilter->SetOutputDirection( outputDirection );
+  itkFilter->SetDefaultPixelValue( defaultValue );
+
+  for( const FilterType::InterpolationType interpolation :
+         { FilterType::itkLinearInterpolation, FilterType::itkNearestInterpolation } )
+    {
+    filter->SetInterpolation( interpolation );
+    ITK_TEST_SET_GET_VALUE( interpolation, filter->GetInterpolation() );
+    if( interpolation == FilterType::itkLinearInterpolation )
+      {
+      itkFilter->SetInterpolator(
+        itk::LinearInterpolateImageFunction< ImageType::ITKImageType, double >::New().GetPointer() );
+      }
+    else
+      {
+      itkFilter->SetInterpolator(
+        itk::NearestNeighborInterpolateImageFunction< ImageType::ITKImageType, double >::New().GetPointer() );
+      }
+
+    ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    ITK_TRY_EXPECT_NO_EXCEPTION( itkFilter->Update() );
+
+    const ImageType *output = filter->GetOutput();
+    ITK_TEST_EXPECT_EQUAL( output->GetLargestPossibleRegion(), itkFilter->GetOutput()->GetLargestPossibleRegion() );
+    ITK_TEST_EXPECT_EQUAL( output->GetSpacing(), outputSpacing );
+    ITK_TEST_EXPECT_EQUAL( output->GetDirection(), outputDirection );
+    const torch::Tensor resampled = output->GetTensor();
+    const torch::Tensor expected = ImageType::FromImage( itkFilter->GetOutput() )->GetTensor();
+    ITK_TEST_EXPECT_TRUE( resampled.eq( defaultValue ).any().item< bool >() );
+    if( interpolation == FilterType::itkLinearInterpolation )
+      {
+      itkAssertOrThrowMacro( torch::allclose( resampled, expected, 1e-3, 1e-3 ),
+        "TorchResampleImageFilter disagrees with ResampleImageFilter" );
+      }
+    else
+      {
+      // The grid is sampled in float, so points very near halfway
+      // between pixels may round to the other neighbor.
+      const double mismatches = resampled.ne( expected ).to( torch::kDouble ).mean().item< double >();
+      itkAssertOrThrowMacro( mismatches < 1e-3, "TorchResampleImageFilter disagrees with ResampleImageFilter" );
+      }
+    }
+
+  // A change of the transform alone brings the filter up to date.
+  const torch::Tensor beforeTranslation = filter->GetOutput()->GetTensor();
+  transform->Translate( translation );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ITK_TEST_EXPECT_TRUE( !torch::equal( filter->GetOutput()->GetTensor(), beforeTranslation ) );
+
+  // Vector pixels are resampled per component, in either layout.
+  using VectorImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using VectorFilterType = itk::TorchResampleImageFilter< VectorImageType >;
+  filter->SetInterpolation( FilterType::itkLinearInterpolation );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  const torch::Tensor resampled = filter->GetOutput()->GetTensor();
+  for( const VectorImageType::ComponentLayoutType componentLayout :
+         { VectorImageType::itkComponentsLast, VectorImageType::itkComponentsFirst } )
+    {
+    VectorImageType::Pointer vectorImage = VectorImageType::New();
+    vectorImage->SetRegions( size );
+    vectorImage->SetSpacing( spacing );
+    vectorImage->SetOrigin( origin );
+    vectorImage->SetComponentLayout( VectorImageType::itkComponentsLast );
+    vectorImage->SetTensor( torch::stack( { image->GetTensor(), -2.0 * image->GetTensor() }, -1 ) );
+    vectorImage->SetComponentLayout( componentLayout );
+    VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+    vectorFilter->SetInput( vectorImage );
+    vectorFilter->SetOutputParametersFromImage( filter->GetOutput() );
+    vectorFilter->SetTransform( transform );
+    VectorImageType::PixelType vectorDefaultValue;
+    vectorDefaultValue[0] = defaultValue;
+    vectorDefaultValue[1] = -2.0f * defaultValue;
+    vectorFilter->SetDefaultPixelValue( vectorDefaultValue );
+    ITK_TRY_EXPECT_NO_EXCEPTION( vectorFilter->Update() );
+    ITK_TEST_EXPECT_EQUAL( vectorFilter->GetOutput()->GetComponentLayout(), componentLayout );
+    const torch::Tensor vectors = VectorImageType::PermuteComponentLayout( vectorFilter->GetOutput()->GetTensor(),
+      componentLayout, VectorImageType::itkComponentsLast );
+    itkAssertOrThrowMacro( torch::allclose( vectors.select( -1, 0 ), resampled, 1e-5, 1e-5 )
+      && torch::allclose( vectors.select( -1, 1 ), -2.0 * resampled, 1e-5, 1e-5 ),
+      "TorchResampleImageFilter resamples vector pixels wrongly" );
+    }
+
+  // Bicubic interpolation is for 2D images, where it reproduces the
+  // pixels of the input at the pixel centers.
+  filter->SetInterpolation( FilterType::itkBicubicInterpolation );
+  ITK_TRY_EXPECT_EXCEPTION( filter->Update() );
+  using Image2DType = itk::TorchImage< float, 2 >;
+  using Filter2DType = itk::TorchResampleImageFilter< Image2DType >;
+  Image2DType::SizeType size2D;
+  size2D[0] = 40;
+  size2D[1] = 30;
+  Image2DType::Pointer image2D = Image2DType::New();
+  image2D->SetRegions( size2D );
+  image2D->SetDevice( Image2DType::itkCPU );
+  image2D->Allocate( Image2DType::itkRandn );
+  using Transform2DType = itk::AffineTransform< double, 2 >;
+  Transform2DType::Pointer transform2D = Transform2DType::New();
+  Transform2DType::OutputVectorType translation2D;
+  translation2D[0] = 3.0;
+  translation2D[1] = -2.0;
+  transform2D->Translate( translation2D );
+  Filter2DType::Pointer filter2D = Filter2DType::New();
+  filter2D->SetInput( image2D );
+  filter2D->SetOutputParametersFromImage( image2D );
+  filter2D->SetTransform( transform2D );
+  filter2D->SetInterpolation( Filter2DType::itkBicubicInterpolation );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter2D->Update() );
+  // Output pixel (x, y) is input pixel (x + 3, y - 2).
+  const torch::Tensor shifted = filter2D->GetOutput()->GetTensor();
+  itkAssertOrThrowMacro( torch::allclose( shifted.slice( 0, 2 ).slice( 1, 0, -3 ),
+    image2D->GetTensor().slice( 0, 0, -2 ).slice( 1, 3 ), 1e-4, 1e-4 )
+    && shifted.slice( 0, 0, 2 ).eq( 0.0f ).all().item< bool >(),
+    "TorchResampleImageFilter interpolates bicubically wrongly" );
+
+  // The output stays on the GPU.
+  if( image2D->SetDevice( Image2DType::itkCUDA ) )
+    {
+    image2D->Modified();
+    ITK_TRY_EXPECT_NO_EXCEPTION( filter2D->Update() );
+    itkAssertOrThrowMacro( filter2D->GetOutput()->GetTensor().is_cuda(), "TorchResampleImageFilter left the GPU" );
+    itkAssertOrThrowMacro( torch::allclose( filter2D->GetOutput()->GetTensor().cpu(), shifted, 1e-4, 1e-4 ),
+      "TorchResampleImageFilter disagrees between CPU and GPU" );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchScriptModelImageFilter.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchScriptModelImageFilterTest( int argc, char *argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " modelFileName" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string modelFileName = argv[1];
+
+  constexpr unsigned int ImageDimension = 2;
+  using InputImageType = itk::TorchImage< float, ImageDimension >;
+  using OutputImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using FilterType = itk::TorchScriptModelImageFilter< InputImageType, OutputImageType >;
+
+  // A tiny model with a pointwise channel, which any tiling and
+  // blending reproduce, and a channel that looks at the neighbors.
+  FilterType::ModuleType module( "TestModel" );
+  module.define( R"JIT(
+def forward(self, x):
+    return torch.cat([2.0 * x + 1.0, torch.max_pool2d(x, [3, 3], [1, 1], [1, 1])], 1)
+)JIT" );
+  module.save( modelFileName );
+
+  InputImageType::SizeType size;
+  size[0] = 50;
+  size[1] = 37;
+  InputImageType::SpacingType spacing;
+  spacing[0] = 0.7;
+  spacing[1] = 1.4;
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->SetDevice( InputImageType::itkCPU );
+  image->Allocate( InputImageType::itkRandn );
+  const torch::Tensor expected = module.forward( { image->GetTensor().view( { 1, 1, 37, 50 } ) } ).toTensor()[0];
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( filter, TorchScriptModelImageFilter, ImageToImageFilter );
+  filter->SetInput( image );
+  ITK_TRY_EXPECT_EXCEPTION( filter->Update() );
+  filter->SetModelFileName( modelFileName );
+  ITK_TEST_SET_GET_VALUE( modelFileName, std::string( filter->GetModelFileName() ) );
+
+  // Patches spanning the image give the output of the model.
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ITK_TEST_EXPECT_EQUAL( filter->GetNumberOfPatches(), 1 );
+  const auto outputChannels = [&filter]()
+    {
+    return OutputImageType::PermuteComponentLayout( filter->GetOutput()->GetTensor(),
+      filter->GetOutput()->GetComponentLayout(), OutputImageType::itkComponentsFirst );
+    };
+  itkAssertOrThrowMacro( torch::allclose( outputChannels(), expected, 1e-5, 1e-5 ),
+    "TorchScriptModelImageFilter disagrees with the model" );
+  ITK_TEST_EXPECT_EQUAL( filter->GetOutput()->GetSpacing(), spacing );
+
+  FilterType::SizeType patchSize;
+  patchSize[0] = 16;
+  patchSize[1] = 12;
+  filter->SetPatchSize( patchSize );
+  ITK_TEST_SET_GET_VALUE( patchSize, filter->GetPatchSize() );
+  filter->SetOverlap( 0.5 );
+  ITK_TEST_SET_GET_VALUE( 0.5, filter->GetOverlap() );
+  torch::Tensor previous;
+  for( const FilterType::BlendingType blending : { FilterType::itkGaussianBlending, FilterType::itkConstantBlending } )
+    {
+    filter->SetBlending( blending );
+    ITK_TEST_SET_GET_VALUE( blending, filter->GetBlending() );
+    for( const unsigned int batchSize : { 1u, 7u } )
+      {
+      filter->SetBatchSize( batchSize );
+      ITK_TEST_SET_GET_VALUE( batchSize, filter->GetBatchSize() );
+      ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+      // Starts 0, 8, ..., 32, 34 along x and 0, 6, ..., 24, 25 along y.
+      ITK_TEST_EXPECT_EQUAL( filter->GetNumberOfPatches(), 36 );
+      std::cout << "Blending " << blending << ", batch size " << batchSize << ": extraction "
+        << filter->GetExtractionTime() << "s, inference " << filter->GetInferenceTime() << "s, blending "
+        << filter->GetBlendingTime() << "s" << std::endl;
+      ITK_TEST_EXPECT_TRUE( filter->GetInferenceTime() > 0.0 );
+
+      const torch::Tensor channels = outputChannels();
+      itkAssertOrThrowMacro( torch::allclose( channels[0], expected[0], 1e-5, 1e-5 ),
+        "TorchScriptModelImageFilter blends a pointwise model wrongly" );
+      // The batching does not change the output.
+      if( batchSize != 1u )
+        {
+        itkAssertOrThrowMacro( torch::allclose( channels, previous, 1e-6, 1e-6 ),
+          "TorchScriptModelImageFilter depends on the batch size" );
+        }
+      previous = channels;
+      }
+    }
+
+  // Patches larger than the image are padded.
+  patchSize[0] = 64;
+  patchSize[1] = 40;
+  filter->SetPatchSize( patchSize );
+  ITK_TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ITK_TEST_EXPECT_EQUAL( filter->GetNumberOfPatches(), 1 );
+  ITK_TEST_EXPECT_EQUAL( filter->GetOutput()->GetLargestPossibleRegion(), image->GetLargestPossibleRegion() );
+  itkAssertOrThrowMacro( torch::allclose( outputChannels()[0], expected[0], 1e-5, 1e-5 ),
+    "TorchScriptModelImageFilter pads wrongly" );
+
+  // A model whose output does not match the output pixel is rejected.
+  FilterType::ModuleType wrongModule( "WrongModel" );
+  wrongModule.define( R"JIT(
+def forward(self, x):
+    return x
+)JIT" );
+  filter->SetModule( wrongModule );
+  ITK_TRY_EXPECT_EXCEPTION( filter->Update() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchImage.h"
+#include "itkTorchTensorPool.h"
+
+#include "itkTestingMacros.h"
+
+int itkTorchTensorPoolBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  const ImageType::RegionType region( size );
+  const uint64_t numberOfPixels = region.GetNumberOfPixels();
+
+  // Repeated allocation of images of one size, with and without the
+  // pool.
+  itk::TorchTensorPool * const pool = itk::TorchTensorPool::GetInstance();
+  const bool wasEnabled = pool->GetEnabled();
+  const uint64_t maximumNumberOfBytes = pool->GetMaximumNumberOfBytes();
+  pool->SetMaximumNumberOfBytes( 2 * numberOfPixels * sizeof( float ) );
+  itk::TorchBenchmark benchmark( "TorchTensorPool", 100 );
+  for( const bool enabled : { false, true } )
+    {
+    pool->SetEnabled( enabled );
+    benchmark.Time( "Allocate and FillBuffer", enabled ? "pool enabled" : "pool disabled", "float", ImageDimension,
+      numberOfPixels,
+      [&]()
+        {
+        ImageType::Pointer image = ImageType::New();
+        image->SetDevice( ImageType::itkCPU );
+        image->SetRegions( region );
+        image->Allocate();
+        image->FillBuffer( 1.0f );
+        } );
+    }
+  pool->SetEnabled( wasEnabled );
+  pool->SetMaximumNumberOfBytes( maximumNumberOfBytes );
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
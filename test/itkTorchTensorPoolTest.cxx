@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchTensorPool.h"
+#include "itkTorchImage.h"
+
+#include "itkTestingMacros.h"
+
+int itkTorchTensorPoolTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+
+  itk::TorchTensorPool::Pointer pool = itk::TorchTensorPool::GetInstance();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( pool, TorchTensorPool, Object );
+  itkAssertOrThrowMacro( pool == itk::TorchTensorPool::GetInstance(), "TorchTensorPool is not a singleton" );
+  ITK_TEST_SET_GET_BOOLEAN( pool, Enabled, true );
+
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  const ImageType::RegionType region( size );
+  const uint64_t imageBytes = region.GetNumberOfPixels() * sizeof( float );
+  const auto makeImage = [&region]( ImageType::TensorInitializer initializer )
+    {
+    ImageType::Pointer image = ImageType::New();
+    image->SetDevice( ImageType::itkCPU );
+    image->SetRegions( region );
+    image->Allocate( initializer );
+    return image;
+    };
+
+  // A disabled pool neither keeps nor hands out tensors.
+  pool->SetEnabled( false );
+  pool->ResetCounters();
+  makeImage( ImageType::itkEmpty );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 0 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 0 );
+
+  // The storage of a released image is reused by the next image of the
+  // same size.
+  pool->EnabledOn();
+  pool->SetMaximumNumberOfBytes( 4 * imageBytes );
+  ITK_TEST_SET_GET_VALUE( 4 * imageBytes, pool->GetMaximumNumberOfBytes() );
+  ImageType::Pointer image = makeImage( ImageType::itkEmpty );
+  const void * const storage = image->GetTensor().data_ptr();
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 1 );
+  image = nullptr;
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 1 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfBytes(), imageBytes );
+  image = makeImage( ImageType::itkOnes );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfHits(), 1 );
+  itkAssertOrThrowMacro( image->GetTensor().data_ptr() == storage, "TorchTensorPool did not recycle the tensor" );
+  itkAssertOrThrowMacro( image->GetTensor().eq( 1.0f ).all().item< bool >(),
+    "A recycled tensor was not initialized" );
+
+  // Initialize() returns the tensor as well.
+  image->Initialize();
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 1 );
+
+  // Tensors of another size or dtype do not match.
+  ImageType::SizeType otherSize;
+  otherSize.Fill( 32 );
+  ImageType::Pointer otherImage = ImageType::New();
+  otherImage->SetDevice( ImageType::itkCPU );
+  otherImage->SetRegions( ImageType::RegionType( otherSize ) );
+  otherImage->Allocate();
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 2 );
+  using DoubleImageType = itk::TorchImage< double, ImageDimension >;
+  DoubleImageType::Pointer doubleImage = DoubleImageType::New();
+  doubleImage->SetDevice( DoubleImageType::itkCPU );
+  doubleImage->SetRegions( region );
+  doubleImage->Allocate();
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 3 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 1 );
+  otherImage = nullptr;
+  doubleImage = nullptr;
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 3 );
+
+  // Storage that is still shared, by a view or a graft, is not
+  // recycled.
+  pool->Trim();
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 0 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfBytes(), 0 );
+  image = makeImage( ImageType::itkZeros );
+  ImageType::Pointer grafted = ImageType::New();
+  grafted->Graft( image.GetPointer() );
+  image = nullptr;
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 0 );
+  itkAssertOrThrowMacro( grafted->GetTensor().eq( 0.0f ).all().item< bool >(),
+    "A grafted tensor was released while still in use" );
+  grafted = nullptr;
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 0 );
+
+  // Tensors that are not allocated by Allocate() are never pooled.
+  image = ImageType::New();
+  image->SetRegions( region );
+  image->SetTensor( torch::zeros( image->ComputeTorchSize(), torch::dtype( ImageType::TorchValueType ) ) );
+  image = nullptr;
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 0 );
+
+  // The byte cap evicts the least recently returned tensors.
+  std::vector< ImageType::Pointer > images;
+  for( unsigned int i = 0; i < 6; ++i )
+    {
+    images.push_back( makeImage( ImageType::itkEmpty ) );
+    }
+  images.clear();
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 4 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfBytes(), 4 * imageBytes );
+  pool->SetMaximumNumberOfBytes( imageBytes );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 1 );
+  pool->SetMaximumNumberOfBytes( 4 * imageBytes );
+
+  // Repeated allocations of one size miss once and then reuse the
+  // same tensor.
+  constexpr unsigned int repeats = 10;
+  pool->Trim();
+  pool->ResetCounters();
+  for( unsigned int i = 0; i < repeats; ++i )
+    {
+    ImageType::Pointer repeatedImage = makeImage( ImageType::itkEmpty );
+    repeatedImage->FillBuffer( 1.0f );
+    }
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 1 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfHits(), repeats - 1 );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 1 );
+
+  pool->Print( std::cout );
+  pool->SetEnabled( false );
+  ITK_TEST_EXPECT_EQUAL( pool->GetNumberOfTensors(), 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchBenchmark.h"
+#include "itkTorchDiscreteGaussianImageFilter.h"
+#include "itkTorchThreadingPolicy.h"
+#include "itkTorchUnaryImageFilter.h"
+
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <utility>
+
+int itkTorchThreadingPolicyBenchmark( int argc, char * argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro( argv ) << " outputJSONFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using PolicyType = itk::TorchThreadingPolicy;
+  using ExpFilterType = itk::TorchExpImageFilter< ImageType >;
+  using GaussianFilterType = itk::TorchDiscreteGaussianImageFilter< ImageType >;
+
+  ImageType::SizeType size;
+  size[0] = 128;
+  size[1] = 96;
+  size[2] = 64;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+  const uint64_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  ExpFilterType::Pointer expFilter = ExpFilterType::New();
+  expFilter->SetInput( image );
+  GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
+  gaussianFilter->SetInput( image );
+  gaussianFilter->SetVariance( 4.0 );
+
+  // The time per number of threads, for choosing between the policies.
+  PolicyType * const policy = PolicyType::GetInstance();
+  const itk::ThreadIdType globalDefaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  itk::TorchBenchmark benchmark( "TorchThreadingPolicy", 3 );
+  for( itk::ThreadIdType threads = 1; ; threads = std::min( 2 * threads, globalDefaultNumberOfThreads ) )
+    {
+    const std::string variant = std::to_string( threads ) + " threads";
+    for( const PolicyType::ParallelismType parallelism :
+           { PolicyType::itkIntraOpParallelism, PolicyType::itkWorkUnitParallelism } )
+      {
+      policy->SetParallelism( parallelism );
+      const std::string policyVariant =
+        ( parallelism == PolicyType::itkIntraOpParallelism ? "intra-op, " : "work units, " ) + variant;
+      const std::pair< const char *, itk::ProcessObject * > filters[] = {
+        { "TorchExpImageFilter", expFilter }, { "TorchDiscreteGaussianImageFilter", gaussianFilter } };
+      for( const auto & filterPair : filters )
+        {
+        itk::ProcessObject * const filter = filterPair.second;
+        filter->GetMultiThreader()->SetMaximumNumberOfThreads( threads );
+        filter->SetNumberOfWorkUnits( threads );
+        benchmark.Time( filterPair.first, policyVariant, "float", ImageDimension, numberOfPixels,
+          [&]()
+            {
+            filter->Modified();
+            filter->Update();
+            } );
+        }
+      }
+    if( threads == globalDefaultNumberOfThreads )
+      {
+      break;
+      }
+    }
+  policy->SetParallelism( PolicyType::itkIntraOpParallelism );
+
+  ITK_TEST_EXPECT_TRUE( benchmark.Write( argv[1] ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchThreadingPolicy.h"
+#include "itkTorchBinaryImageFilter.h"
+#include "itkTorchUnaryImageFilter.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+#include <mutex>
+
+namespace
+{
+
+// A functor that copies its input and records the number of ATen
+// threads of each call.
+class RecordThreads
+{
+public:
+  void operator()( torch::Tensor & output, const torch::Tensor & input ) const
+    {
+    output.copy_( input );
+    std::lock_guard< std::mutex > lock( Mutex() );
+    NumbersOfThreads().push_back( at::get_num_threads() );
+    }
+
+  static std::mutex & Mutex()
+    {
+    static std::mutex mutex;
+    return mutex;
+    }
+  static std::vector< int > & NumbersOfThreads()
+    {
+    static std::vector< int > numbersOfThreads;
+    return numbersOfThreads;
+    }
+};
+
+} // end namespace
+
+int itkTorchThreadingPolicyTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+  using VectorImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using PolicyType = itk::TorchThreadingPolicy;
+
+  PolicyType::Pointer policy = PolicyType::GetInstance();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( policy, TorchThreadingPolicy, Object );
+  itkAssertOrThrowMacro( policy == PolicyType::GetInstance(), "TorchThreadingPolicy is not a singleton" );
+  ITK_TEST_EXPECT_EQUAL( policy->GetParallelism(), PolicyType::itkIntraOpParallelism );
+
+  // ITK's global default number of threads becomes ATen's.
+  const itk::ThreadIdType globalDefaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  policy->ApplyGlobalDefaultNumberOfThreads();
+  ITK_TEST_EXPECT_EQUAL( at::get_num_threads(), static_cast< int >( globalDefaultNumberOfThreads ) );
+
+  // The guard restores the number of threads.  Whether it can change
+  // the number at all depends on ATen's parallel backend.
+  const int numberOfThreads = at::get_num_threads();
+  bool backendSetsThreads;
+    {
+    const itk::TorchIntraOpThreadsGuard guard( 1 );
+    backendSetsThreads = at::get_num_threads() == 1;
+    }
+  ITK_TEST_EXPECT_EQUAL( at::get_num_threads(), numberOfThreads );
+  std::cout << "ATen parallel backend " << ( backendSetsThreads ? "sets" : "does not set" )
+    << " the number of threads per guard" << std::endl;
+
+  ImageType::SizeType size;
+  size[0] = 128;
+  size[1] = 96;
+  size[2] = 64;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetDevice( ImageType::itkCPU );
+  image->Allocate( ImageType::itkRandn );
+
+  // Filters get as many intra-op threads as they have work units, up to
+  // the maximum of their multithreaders.
+  using RecordFilterType = itk::TorchUnaryImageFilter< ImageType, ImageType, RecordThreads >;
+  RecordFilterType::Pointer recordFilter = RecordFilterType::New();
+  recordFilter->SetInput( image );
+  ITK_TEST_EXPECT_EQUAL( policy->GetNumberOfIntraOpThreads( recordFilter ),
+    static_cast< int >( std::min( recordFilter->GetNumberOfWorkUnits(),
+      recordFilter->GetMultiThreader()->GetMaximumNumberOfThreads() ) ) );
+  recordFilter->SetNumberOfWorkUnits( 2 );
+  ITK_TEST_EXPECT_EQUAL( policy->GetNumberOfIntraOpThreads( recordFilter ),
+    std::min( 2, static_cast< int >( recordFilter->GetMultiThreader()->GetMaximumNumberOfThreads() ) ) );
+  ITK_TRY_EXPECT_NO_EXCEPTION( recordFilter->Update() );
+  ITK_TEST_EXPECT_EQUAL( RecordThreads::NumbersOfThreads().size(), 1 );
+  if( backendSetsThreads )
+    {
+    ITK_TEST_EXPECT_EQUAL( RecordThreads::NumbersOfThreads().front(), policy->GetNumberOfIntraOpThreads( recordFilter ) );
+    }
+  ITK_TEST_EXPECT_EQUAL( at::get_num_threads(), numberOfThreads );
+  ITK_TEST_EXPECT_TRUE( torch::equal( recordFilter->GetOutput()->GetTensor(), image->GetTensor() ) );
+
+  // With work unit parallelism, each work unit computes a region with
+  // one thread.
+  policy->SetParallelism( PolicyType::itkWorkUnitParallelism );
+  ITK_TEST_EXPECT_EQUAL( policy->GetParallelism(), PolicyType::itkWorkUnitParallelism );
+  ITK_TEST_EXPECT_TRUE( policy->SplitsRegion( recordFilter, image->GetTensor() ) );
+  RecordThreads::NumbersOfThreads().clear();
+  recordFilter->SetNumberOfWorkUnits( 4 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( recordFilter->Update() );
+  ITK_TEST_EXPECT_TRUE( RecordThreads::NumbersOfThreads().size() > 1 );
+  if( backendSetsThreads )
+    {
+    for( const int n : RecordThreads::NumbersOfThreads() )
+      {
+      ITK_TEST_EXPECT_EQUAL( n, 1 );
+      }
+    }
+  ITK_TEST_EXPECT_TRUE( torch::equal( recordFilter->GetOutput()->GetTensor(), image->GetTensor() ) );
+
+  // Split regions give the results of whole images, also in place, for
+  // vector pixels in either layout and for broadcast operands.
+  using ExpFilterType = itk::TorchExpImageFilter< ImageType >;
+  ExpFilterType::Pointer expFilter = ExpFilterType::New();
+  expFilter->SetInput( image );
+  expFilter->SetNumberOfWorkUnits( 5 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( expFilter->Update() );
+  ITK_TEST_EXPECT_TRUE( torch::allclose( expFilter->GetOutput()->GetTensor(), image->GetTensor().exp() ) );
+  ImageType::Pointer inPlaceImage = ImageType::New();
+  inPlaceImage->Graft( image );
+  inPlaceImage->SetTensor( image->GetTensor().clone() );
+  expFilter->SetInput( inPlaceImage );
+  expFilter->InPlaceOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION( expFilter->Update() );
+  ITK_TEST_EXPECT_TRUE( torch::allclose( expFilter->GetOutput()->GetTensor(), image->GetTensor().exp() ) );
+
+  using AddFilterType = itk::TorchAddImageFilter< VectorImageType, ImageType, VectorImageType >;
+  for( const VectorImageType::ComponentLayoutType componentLayout :
+         { VectorImageType::itkComponentsLast, VectorImageType::itkComponentsFirst } )
+    {
+    VectorImageType::Pointer vectorImage = VectorImageType::New();
+    vectorImage->SetRegions( size );
+    vectorImage->SetTensor( torch::stack( { image->GetTensor(), -image->GetTensor() }, -1 ) );
+    vectorImage->SetComponentLayout( componentLayout );
+    AddFilterType::Pointer addFilter = AddFilterType::New();
+    addFilter->SetInput1( vectorImage );
+    addFilter->SetInput2( image );
+    addFilter->SetNumberOfWorkUnits( 3 );
+    ITK_TRY_EXPECT_NO_EXCEPTION( addFilter->Update() );
+    const torch::Tensor sum = VectorImageType::PermuteComponentLayout( addFilter->GetOutput()->GetTensor(),
+      componentLayout, VectorImageType::itkComponentsLast );
+    ITK_TEST_EXPECT_TRUE( torch::allclose( sum.select( -1, 0 ), 2.0 * image->GetTensor() ) );
+    ITK_TEST_EXPECT_EQUAL( sum.select( -1, 1 ).abs().max().item< float >(), 0.0f );
+    addFilter->SetConstant2( 3.0f );
+    ITK_TRY_EXPECT_NO_EXCEPTION( addFilter->Update() );
+    ITK_TEST_EXPECT_TRUE( torch::allclose( VectorImageType::PermuteComponentLayout( addFilter->GetOutput()->GetTensor(),
+      componentLayout, VectorImageType::itkComponentsLast ).select( -1, 0 ), image->GetTensor() + 3.0 ) );
+    }
+
+  policy->SetParallelism( PolicyType::itkIntraOpParallelism );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
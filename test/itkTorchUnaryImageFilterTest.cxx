@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTorchUnaryImageFilter.h"
+
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+int itkTorchUnaryImageFilterTest( int, char *[] )
+{
+  constexpr unsigned int ImageDimension = 3;
+  using ImageType = itk::TorchImage< float, ImageDimension >;
+
+  ImageType::SizeType size;
+  size[0] = 9;
+  size[1] = 8;
+  size[2] = 7;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetTensor( torch::rand( image->ComputeTorchSize() ) - 0.5 );
+  const torch::Tensor original = image->GetTensor().clone();
+
+  // Abs into a newly allocated output.
+  using AbsFilterType = itk::TorchAbsImageFilter< ImageType >;
+  AbsFilterType::Pointer absFilter = AbsFilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS( absFilter, TorchUnaryImageFilter, InPlaceImageFilter );
+  absFilter->SetInput( image );
+  ITK_TRY_EXPECT_NO_EXCEPTION( absFilter->Update() );
+  ImageType::Pointer absImage = absFilter->GetOutput();
+  ITK_TEST_EXPECT_EQUAL( absImage->GetBufferedRegion(), image->GetBufferedRegion() );
+  itkAssertOrThrowMacro( torch::equal( absImage->GetTensor(), original.abs() ), "TorchAbsImageFilter is wrong" );
+  itkAssertOrThrowMacro( torch::equal( image->GetTensor(), original ), "TorchAbsImageFilter changed its input" );
+
+  // Exp and Log in place, in a pipeline, keep the storage of the input.
+  using ExpFilterType = itk::TorchExpImageFilter< ImageType >;
+  using LogFilterType = itk::TorchLogImageFilter< ImageType >;
+  ExpFilterType::Pointer expFilter = ExpFilterType::New();
+  expFilter->SetInput( image );
+  expFilter->InPlaceOn();
+  LogFilterType::Pointer logFilter = LogFilterType::New();
+  logFilter->SetInput( expFilter->GetOutput() );
+  logFilter->InPlaceOn();
+  const void * const storage = image->GetTensor().data_ptr();
+  ITK_TRY_EXPECT_NO_EXCEPTION( logFilter->Update() );
+  itkAssertOrThrowMacro( logFilter->GetOutput()->GetTensor().data_ptr() == storage,
+    "TorchUnaryImageFilter did not run in place" );
+  itkAssertOrThrowMacro( torch::allclose( logFilter->GetOutput()->GetTensor(), original, 1e-5, 1e-6 ),
+    "TorchLogImageFilter does not invert TorchExpImageFilter" );
+
+  // Threshold converts int16 to float.
+  using ShortImageType = itk::TorchImage< int16_t, ImageDimension >;
+  ShortImageType::Pointer shortImage = ShortImageType::New();
+  shortImage->SetRegions( size );
+  shortImage->SetTensor( torch::randint( -1000, 1000, shortImage->ComputeTorchSize(), torch::dtype( torch::kShort ) ) );
+  using ThresholdFilterType = itk::TorchThresholdImageFilter< ShortImageType, ImageType >;
+  ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
+  thresholdFilter->SetInput( shortImage );
+  thresholdFilter->GetFunctor().SetBounds( -100.0, 400.0 );
+  thresholdFilter->GetFunctor().SetOutsideValue( -1024.0 );
+  ITK_TRY_EXPECT_NO_EXCEPTION( thresholdFilter->Update() );
+  const torch::Tensor shortTensor = shortImage->GetTensor();
+  const torch::Tensor expectedThreshold =
+    shortTensor.to( torch::kFloat ).masked_fill( shortTensor.lt( -100 ).logical_or( shortTensor.gt( 400 ) ), -1024.0 );
+  itkAssertOrThrowMacro( torch::equal( thresholdFilter->GetOutput()->GetTensor(), expectedThreshold ),
+    "TorchThresholdImageFilter is wrong" );
+
+  // Clamp of vector pixels in either component layout; the output
+  // takes the layout of the input.
+  using VectorImageType = itk::TorchImage< itk::Vector< float, 2 >, ImageDimension >;
+  using ClampFilterType = itk::TorchClampImageFilter< VectorImageType >;
+  for( const VectorImageType::ComponentLayoutType componentLayout :
+         { VectorImageType::itkComponentsLast, VectorImageType::itkComponentsFirst } )
+    {
+    VectorImageType::Pointer vectorImage = VectorImageType::New();
+    vectorImage->SetRegions( size );
+    vectorImage->SetComponentLayout( componentLayout );
+    vectorImage->SetTensor( torch::randn( vectorImage->ComputeTorchSize() ) );
+    ClampFilterType::Pointer clampFilter = ClampFilterType::New();
+    clampFilter->SetInput( vectorImage );
+    clampFilter->GetFunctor().SetLower( -0.5 );
+    ITK_TRY_EXPECT_NO_EXCEPTION( clampFilter->Update() );
+    ITK_TEST_EXPECT_EQUAL( clampFilter->GetOutput()->GetComponentLayout(), componentLayout );
+    itkAssertOrThrowMacro( torch::equal( clampFilter->GetOutput()->GetTensor(), vectorImage->GetTensor().clamp_min( -0.5 ) ),
+      "TorchClampImageFilter is wrong" );
+    }
+
+  // The output stays on the device of the input.
+  if( torch::cuda::is_available() )
+    {
+    ImageType::Pointer cudaImage = ImageType::New();
+    cudaImage->SetRegions( size );
+    cudaImage->SetTensor( original.to( torch::kCUDA ) );
+    absFilter->SetInput( cudaImage );
+    ITK_TRY_EXPECT_NO_EXCEPTION( absFilter->Update() );
+    itkAssertOrThrowMacro( absFilter->GetOutput()->GetTensor().is_cuda(), "TorchAbsImageFilter left the GPU" );
+    itkAssertOrThrowMacro( torch::equal( absFilter->GetOutput()->GetTensor().cpu(), original.abs() ),
+      "TorchAbsImageFilter is wrong on the GPU" );
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// The DLPack protocol for TorchImage in Python: __dlpack__() and
+// __dlpack_device__() let NumPy, CuPy and torch use the pixels of a
+// TorchImage without a copy, and FromDLPackObject() creates a
+// TorchImage from their arrays without a copy.  See
+// TorchImage::ToDLPack() and TorchImage::FromDLPack().
+
+%{
+#include <ATen/DLConvertor.h>
+
+// A capsule that no consumer has renamed to "used_dltensor" still owns
+// its tensor.
+static void itkTorchImageDLPackCapsuleDestructor( PyObject * capsule )
+{
+  if( PyCapsule_IsValid( capsule, "dltensor" ) )
+    {
+    auto * dlManagedTensor = static_cast< DLManagedTensor * >( PyCapsule_GetPointer( capsule, "dltensor" ) );
+    if( dlManagedTensor->deleter != nullptr )
+      {
+      dlManagedTensor->deleter( dlManagedTensor );
+      }
+    }
+}
+
+static PyObject * itkTorchImageToDLPackCapsule( DLManagedTensor * dlManagedTensor )
+{
+  return PyCapsule_New( dlManagedTensor, "dltensor", itkTorchImageDLPackCapsuleDestructor );
+}
+
+static PyObject * itkTorchImageDLPackDevice( bool cuda, uint64_t cudaDeviceNumber )
+{
+  return Py_BuildValue( "(ii)", static_cast< int >( cuda ? kDLGPU : kDLCPU ),
+    static_cast< int >( cuda ? cudaDeviceNumber : 0 ) );
+}
+
+// Take the tensor of a DLPack capsule, or of the capsule returned by
+// the __dlpack__() method of an object, and mark the capsule as
+// consumed.
+static DLManagedTensor * itkTorchImageDLPackFromPython( PyObject * object )
+{
+  PyObject * capsule = nullptr;
+  if( PyCapsule_CheckExact( object ) )
+    {
+    Py_INCREF( object );
+    capsule = object;
+    }
+  else
+    {
+    capsule = PyObject_CallMethod( object, "__dlpack__", nullptr );
+    if( capsule == nullptr )
+      {
+      PyErr_Clear();
+      itkGenericExceptionMacro( << "FromDLPackObject() expects a DLPack capsule or an object with __dlpack__()" );
+      }
+    }
+  if( !PyCapsule_IsValid( capsule, "dltensor" ) )
+    {
+    Py_DECREF( capsule );
+    itkGenericExceptionMacro( << "FromDLPackObject() expects an unused DLPack capsule" );
+    }
+  auto * dlManagedTensor = static_cast< DLManagedTensor * >( PyCapsule_GetPointer( capsule, "dltensor" ) );
+  PyCapsule_SetName( capsule, "used_dltensor" );
+  Py_DECREF( capsule );
+  return dlManagedTensor;
+}
+%}
+
+// swig_name is the wrapped class and cpp_name its C++ type, passed
+// with %arg() for its commas.  The stream argument of __dlpack__() is
+// accepted for the protocol but ignored, so a consumer that uses the
+// pixels of a GPU image on another stream must synchronize first,
+// e.g. with torch.cuda.synchronize().
+%define DECL_PYTHON_TORCH_IMAGE_CLASS(swig_name, cpp_name)
+  %extend swig_name {
+    PyObject * __dlpack__( PyObject * stream = nullptr )
+      {
+      return itkTorchImageToDLPackCapsule( self->ToDLPack() );
+      }
+
+    PyObject * __dlpack_device__()
+      {
+      cpp_name::DeviceType deviceType;
+      uint64_t cudaDeviceNumber;
+      self->GetDevice( deviceType, cudaDeviceNumber );
+      return itkTorchImageDLPackDevice( deviceType == cpp_name::itkCUDA, cudaDeviceNumber );
+      }
+
+    static cpp_name::Pointer FromDLPackObject( PyObject * object,
+      const itk::ImageBase< cpp_name::ImageDimension > * geometry = nullptr )
+      {
+      return cpp_name::FromDLPack( itkTorchImageDLPackFromPython( object ), geometry );
+      }
+  }
+%enddef